@@ -0,0 +1,89 @@
+//
+//  BenchUtils.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "BenchUtils.hpp"
+
+OffscreenGraphics& BenchUtils::GetGraphics()
+{
+    static OffscreenGraphics graphics;
+    return graphics;
+}
+
+void BenchUtils::OnColRendered()
+{
+    GetGraphics().EndColumn();
+}
+
+bool BenchUtils::ReadFile(const std::string& fileName, std::vector<uint8_t>& bytes)
+{
+    std::ifstream file {fileName, std::ios::binary};
+    if (!file)
+        return false;
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+bool BenchUtils::ReadWalls(const std::string& fileName, std::vector<Wall>& walls)
+{
+    std::ifstream file {fileName};
+    if (!file)
+        return false;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+        std::istringstream numbers {line};
+        double x1, y1, x2, y2;
+        if (!(numbers >> x1 >> y1 >> x2 >> y2))
+            return false;
+        walls.push_back({{{static_cast<Scalar>(x1), static_cast<Scalar>(y1)}, {static_cast<Scalar>(x2), static_cast<Scalar>(y2)}}});
+    }
+    return !file.bad();
+}
+
+BenchUtils::Summary::Summary(std::vector<double> samples):
+    count{samples.size()},
+    min{0.0f},
+    median{0.0f},
+    p99{0.0f}
+{
+    if (samples.empty())
+        return;
+
+    std::sort(samples.begin(), samples.end());
+    min = samples.front();
+    median = samples[samples.size() / 2];
+    // nearest-rank percentile
+    size_t p99Idx {(samples.size() * 99 + 99) / 100};
+    p99 = samples[std::min(p99Idx, samples.size()) - 1];
+}
+
+void BenchUtils::PrintHeader(const std::string& suiteName, const std::vector<std::string>& columns)
+{
+    printf("\n== %s ==\n", suiteName.c_str());
+    printf("%-28s", "scenario");
+    for (const std::string& column : columns)
+        printf(" %14s", column.c_str());
+    printf("\n");
+}
+
+void BenchUtils::PrintRow(const std::string& name, const std::vector<double>& values)
+{
+    printf("%-28s", name.c_str());
+    for (double value : values)
+        printf(" %14.1f", value);
+    printf("\n");
+    fflush(stdout);
+}
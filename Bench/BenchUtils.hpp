@@ -0,0 +1,92 @@
+//
+//  BenchUtils.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef BenchUtils_hpp
+#define BenchUtils_hpp
+
+#include <chrono>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <string>
+#include <vector>
+#include "OffscreenGraphics.hpp"
+#include "Wall.hpp"
+
+// common pieces for the benchmark suites: timing, summary statistics and result printing
+class BenchUtils
+{
+public:
+    BenchUtils() = delete;
+    ~BenchUtils() = delete;
+
+    class Timer
+    {
+    public:
+        Timer(): start{std::chrono::steady_clock::now()} {}
+        void Restart() { start = std::chrono::steady_clock::now(); }
+        double ElapsedNs() const
+        {
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // a summary of a set of samples (e.g. frame times)
+    class Summary
+    {
+    public:
+        explicit Summary(std::vector<double> samples);
+
+        size_t count;
+        double min;
+        double median;
+        double p99;
+    };
+
+    // options common to all suites
+    class Options
+    {
+    public:
+        bool quick {false}; // fewer repetitions, for a fast sanity check
+    };
+
+    // all suites render into the same offscreen column sink
+    static OffscreenGraphics& GetGraphics();
+    static void OnColRendered();
+
+    // (e.g. a compiled map - returns false if it couldn't be read)
+    static bool ReadFile(const std::string& fileName, std::vector<uint8_t>& bytes);
+    // (a map's walls, in bspc's text format - "x1 y1 x2 y2" per line, and # for comments)
+    static bool ReadWalls(const std::string& fileName, std::vector<Wall>& walls);
+
+    // results are printed as simple aligned tables, one row per scenario
+    static void PrintHeader(const std::string& suiteName, const std::vector<std::string>& columns);
+    static void PrintRow(const std::string& name, const std::vector<double>& values);
+
+    // the CPU's cycle counter, where there is one (otherwise always 0)
+    static uint64_t ReadCycleCounter()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    // keeps the optimizer from throwing away work whose result is otherwise unused
+    template <typename T>
+    static void DoNotOptimize(const T& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+};
+
+#endif /* BenchUtils_hpp */
@@ -0,0 +1,98 @@
+//
+//  CameraPaths.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <cmath>
+#include "CameraPaths.hpp"
+
+std::vector<CameraPaths::Pose> CameraPaths::SmileyFaceWalk(size_t numPoses)
+{
+    // inside the head, around the eyes and under the mouth
+    return Walk({
+        { 150.0f, 130.0f },
+        { 230.0f, 125.0f },
+        { 265.0f, 150.0f },
+        { 240.0f, 210.0f },
+        { 150.0f, 225.0f },
+        {  60.0f, 210.0f },
+        {  50.0f, 120.0f },
+        { 100.0f,  60.0f },
+        { 200.0f,  60.0f },
+    }, numPoses);
+}
+
+std::vector<CameraPaths::Pose> CameraPaths::BasicAreaWalk(size_t numPoses)
+{
+    // around the interior "box" and past the standalone wall
+    return Walk({
+        { 100.0f,  30.0f },
+        { 190.0f,  30.0f },
+        { 190.0f, 120.0f },
+        { 120.0f, 190.0f },
+        {  40.0f, 150.0f },
+        {  30.0f, 110.0f },
+        { 100.0f, 110.0f },
+    }, numPoses);
+}
+
+std::vector<CameraPaths::Pose> CameraPaths::PillarsWalk(size_t numPoses)
+{
+    // along the aisles between the pillars, around the edge of the grid and through the middle
+    return Walk({
+        {  30.0f,  30.0f },
+        { 366.0f,  30.0f },
+        { 366.0f, 198.0f },
+        {  30.0f, 198.0f },
+        {  30.0f, 366.0f },
+        { 366.0f, 366.0f },
+        { 198.0f, 366.0f },
+        { 198.0f,  30.0f },
+    }, numPoses);
+}
+
+std::vector<CameraPaths::Pose> CameraPaths::Spin(const Vec2& location, size_t numPoses)
+{
+    std::vector<Pose> poses;
+    for (size_t i = 0; i < numPoses; i++)
+        poses.push_back({location, 2.0f * M_PI * static_cast<double>(i) / static_cast<double>(numPoses)});
+    return poses;
+}
+
+// evenly spaces poses along a closed loop through the waypoints, facing the direction of
+// travel but also sweeping the view left and right
+std::vector<CameraPaths::Pose> CameraPaths::Walk(const std::vector<Point>& waypoints, size_t numPoses)
+{
+    std::vector<Pose> poses;
+
+    double totalLength {0.0f};
+    for (size_t i = 0; i < waypoints.size(); i++)
+        totalLength += (waypoints[(i + 1) % waypoints.size()] - waypoints[i]).Mag();
+
+    const double step {totalLength / static_cast<double>(numPoses)};
+    size_t segIdx {0};
+    double distIntoSeg {0.0f};
+    for (size_t i = 0; i < numPoses; i++)
+    {
+        Point p1 {waypoints[segIdx]};
+        Point p2 {waypoints[(segIdx + 1) % waypoints.size()]};
+        Point segDir {(p2 - p1).Norm()};
+
+        // (heading 0 looks along +y, and positive headings turn to the right, towards -x)
+        double travelHeading {atan2(-segDir.x, segDir.y)};
+        double sweep {0.6f * sin(static_cast<double>(i) * 0.15f)};
+        Point location {p1 + segDir * distIntoSeg};
+        poses.push_back({{static_cast<Scalar>(location.x), static_cast<Scalar>(location.y)}, travelHeading + sweep});
+
+        distIntoSeg += step;
+        while (distIntoSeg >= (waypoints[(segIdx + 1) % waypoints.size()] - waypoints[segIdx]).Mag())
+        {
+            distIntoSeg -= (waypoints[(segIdx + 1) % waypoints.size()] - waypoints[segIdx]).Mag();
+            segIdx = (segIdx + 1) % waypoints.size();
+        }
+    }
+
+    return poses;
+}
@@ -0,0 +1,46 @@
+//
+//  CameraPaths.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef CameraPaths_hpp
+#define CameraPaths_hpp
+
+#include <vector>
+#include "Vec2.hpp"
+
+// fixed (deterministic) sets of camera poses to replay through the renderers, so that
+// numbers from different runs and different builds can be compared
+class CameraPaths
+{
+public:
+    CameraPaths() = delete;
+    ~CameraPaths() = delete;
+
+    class Pose
+    {
+    public:
+        Vec2 location;
+        double headingRad; // as per Camera::SetPose()
+    };
+
+    // a walk around the inside of the map, looking around while walking
+    static std::vector<Pose> SmileyFaceWalk(size_t numPoses);
+    static std::vector<Pose> BasicAreaWalk(size_t numPoses);
+    // (Maps/pillars.txt, which is only in the benchmarks of builds with big trees)
+    static std::vector<Pose> PillarsWalk(size_t numPoses);
+
+    // standing still at one location, turning all the way around
+    static std::vector<Pose> Spin(const Vec2& location, size_t numPoses);
+
+private:
+    // (paths are always computed in double precision, so that they are the same poses in
+    // floating-point and fixed-point builds)
+    typedef _Vec2<double> Point;
+
+    static std::vector<Pose> Walk(const std::vector<Point>& waypoints, size_t numPoses);
+};
+
+#endif /* CameraPaths_hpp */
@@ -0,0 +1,140 @@
+//
+//  ColumnBench.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "ColumnBench.hpp"
+#include "ColumnRasterizer.hpp"
+
+namespace
+{
+    // the column drawing loop as it was before ColumnRasterizer, one pixel at a time
+    void RasterizeReference(uint8_t* pPages, uint8_t numPages, uint8_t y1, uint8_t y2, uint8_t ditherPattern)
+    {
+        uint8_t y {0};
+        for (uint8_t pageNum = 0; pageNum < numPages; pageNum++)
+        {
+            uint8_t pageData {0};
+            for (uint8_t i = 0; i < 8; i++)
+            {
+                if (y >= y1 && y < y2)
+                    pageData |= (1 << i);
+                y++;
+            }
+            pPages[pageNum] = (pageData & ditherPattern);
+        }
+    }
+
+    class Span
+    {
+    public:
+        uint8_t y1;
+        uint8_t y2;
+        uint8_t ditherPattern;
+    };
+
+    // returns the number of spans for which the output differs from the reference
+    // (every span, including empty and reversed ones and ones running past the end of the
+    // column, for every dither pattern and a few column heights)
+    size_t Check(size_t& numChecked)
+    {
+        size_t numMismatches {0};
+        numChecked = 0;
+        for (uint8_t numPages : {1, 2, 8})
+        {
+            const uint8_t maxY {static_cast<uint8_t>(numPages * 8 + 8)};
+            for (uint16_t pattern = 0; pattern <= 0xFF; pattern++)
+            {
+                for (uint8_t y1 = 0; y1 <= maxY; y1++)
+                {
+                    for (uint8_t y2 = 0; y2 <= maxY; y2++)
+                    {
+                        uint8_t expected[8];
+                        uint8_t actual[8];
+                        memset(actual, 0xA5, sizeof(actual));
+                        RasterizeReference(expected, numPages, y1, y2, static_cast<uint8_t>(pattern));
+                        ColumnRasterizer::Rasterize(actual, numPages, y1, y2, static_cast<uint8_t>(pattern));
+                        numChecked++;
+                        if (memcmp(expected, actual, numPages) != 0)
+                            numMismatches++;
+                    }
+                }
+            }
+        }
+        return numMismatches;
+    }
+
+    // columns as the renderers draw them: spans centred vertically, with every height
+    void MakeSpans(std::vector<Span>& spans, uint8_t screenHeight)
+    {
+        static const uint8_t patterns[] {0x80, 0x88, 0x92, 0xAA, 0xD5, 0xDB, 0xFB, 0xFF};
+        for (size_t i = 0; i < 4096; i++)
+        {
+            uint8_t height {static_cast<uint8_t>((i * 37) % (screenHeight + 1))};
+            uint8_t y1 {static_cast<uint8_t>(screenHeight / 2 - height / 2)};
+            spans.push_back({y1, static_cast<uint8_t>(y1 + height), patterns[i % 8]});
+        }
+    }
+
+    template <typename F>
+    void TimeColumns(const char* name, F rasterize, const std::vector<Span>& spans, uint8_t numPages,
+                     size_t numMismatches, const BenchUtils::Options& options)
+    {
+        const size_t numPasses {options.quick ? 20u : 200u};
+        std::vector<uint8_t> pages(numPages);
+        double bestNs {0.0f};
+        uint64_t bestCycles {0};
+        for (size_t pass = 0; pass < numPasses; pass++)
+        {
+            BenchUtils::Timer timer;
+            uint64_t startCycles {BenchUtils::ReadCycleCounter()};
+            for (const Span& span : spans)
+            {
+                rasterize(pages.data(), numPages, span.y1, span.y2, span.ditherPattern);
+                BenchUtils::DoNotOptimize(pages);
+            }
+            uint64_t cycles {BenchUtils::ReadCycleCounter() - startCycles};
+            double ns {timer.ElapsedNs()};
+            if ((pass == 0) || (ns < bestNs))
+            {
+                bestNs = ns;
+                bestCycles = cycles;
+            }
+        }
+
+        const double numColumns {static_cast<double>(spans.size())};
+        BenchUtils::PrintRow(name, {
+            numColumns,
+            static_cast<double>(numMismatches),
+            bestNs / numColumns,
+            static_cast<double>(bestCycles) / numColumns
+        });
+    }
+}
+
+bool ColumnBench::Run(const BenchUtils::Options& options)
+{
+    OffscreenGraphics& graphics {BenchUtils::GetGraphics()};
+    const uint8_t screenHeight {static_cast<uint8_t>(graphics.ScreenHeight)};
+    const uint8_t numPages {static_cast<uint8_t>(screenHeight / 8)};
+
+    size_t numChecked;
+    size_t numMismatches {Check(numChecked)};
+
+    std::vector<Span> spans;
+    MakeSpans(spans, screenHeight);
+
+    // (cycles are from the time stamp counter, so are 0 where there isn't one)
+    BenchUtils::PrintHeader("column", {"columns", "mismatches", "ns/col", "cycles/col"});
+    TimeColumns("column/perPixel", RasterizeReference, spans, numPages, 0, options);
+    TimeColumns("column/rasterizer", ColumnRasterizer::Rasterize, spans, numPages, numMismatches, options);
+
+    if (numMismatches)
+        fprintf(stderr, "column: %zu of %zu spans differ from the reference\n", numMismatches, numChecked);
+    return (numMismatches == 0);
+}
@@ -0,0 +1,24 @@
+//
+//  ColumnBench.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef ColumnBench_hpp
+#define ColumnBench_hpp
+
+#include "BenchUtils.hpp"
+
+// checks ColumnRasterizer against a straightforward pixel-by-pixel version for every possible
+// span and dither pattern, and compares the time taken per column
+class ColumnBench
+{
+public:
+    ColumnBench() = delete;
+    ~ColumnBench() = delete;
+
+    static bool Run(const BenchUtils::Options& options);
+};
+
+#endif /* ColumnBench_hpp */
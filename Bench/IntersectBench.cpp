@@ -0,0 +1,159 @@
+//
+//  IntersectBench.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "Camera.hpp"
+#include "CameraPaths.hpp"
+#include "GeomUtils.hpp"
+#include "IntersectBench.hpp"
+#include "WallSoa.hpp"
+
+namespace
+{
+    const char* GetKernelName(WallSoa::Kernel kernel)
+    {
+        switch (kernel)
+        {
+            case WallSoa::Kernel::Scalar: return "scalar";
+            case WallSoa::Kernel::Sse2: return "sse2";
+            case WallSoa::Kernel::Avx2: return "avx2";
+        }
+        return "?";
+    }
+
+    // (ScalarMax if the ray hits nothing)
+    Scalar FindClosestT(const std::vector<Wall>& walls, const Line& ray)
+    {
+        Scalar closestT {ScalarMax};
+        for (const Wall& wall : walls)
+        {
+            Vec2 intersection;
+            Scalar t, u;
+            if (GeomUtils::FindRayLineSegIntersection(ray, wall.seg, intersection, t, u) && (t < closestT))
+                closestT = t;
+        }
+        return closestT;
+    }
+
+    // finds every ray's closest hit, keeping the fastest of a few passes, in ns per ray
+    template <typename F>
+    double TimePerRay(const std::vector<Line>& rays, F findClosestT, const BenchUtils::Options& options)
+    {
+        const size_t numPasses {options.quick ? 3u : 20u};
+        double bestNs {0.0f};
+        for (size_t pass = 0; pass < numPasses; pass++)
+        {
+            BenchUtils::Timer timer;
+            for (const Line& ray : rays)
+                BenchUtils::DoNotOptimize(findClosestT(ray));
+            double ns {timer.ElapsedNs()};
+            if ((pass == 0) || (ns < bestNs))
+                bestNs = ns;
+        }
+        return bestNs / static_cast<double>(rays.size());
+    }
+
+    void PrintResult(const std::string& name, size_t numRays, size_t numWalls, double nsPerRay)
+    {
+        BenchUtils::PrintRow(name, {static_cast<double>(numRays), static_cast<double>(numWalls), nsPerRay,
+                                    static_cast<double>(numWalls) / nsPerRay * 1000.0f});
+    }
+
+    // returns false if the kernel doesn't find exactly the closest hit that GeomUtils does, for
+    // any of the rays, or says that a wall was hit there that wasn't
+    bool CheckKernel(const std::string& name, const WallSoa& soa, const std::vector<Wall>& walls,
+                     const std::vector<WallSoa::WallIdx>* pWallIdxs, const std::vector<Line>& rays,
+                     const std::vector<Scalar>& expectedTs)
+    {
+        for (size_t rayIdx = 0; rayIdx < rays.size(); rayIdx++)
+        {
+            const Line& ray {rays[rayIdx]};
+            Scalar t {ScalarMax};
+            WallSoa::WallIdx wallIdx {0};
+            const bool isHit {soa.FindClosestHit(ray, pWallIdxs ? pWallIdxs->data() : nullptr, walls.size(), t, wallIdx)};
+            Vec2 intersection;
+            Scalar wallT, u;
+            if ((isHit != (expectedTs[rayIdx] < ScalarMax)) || (t != expectedTs[rayIdx]) ||
+                (isHit && (!GeomUtils::FindRayLineSegIntersection(ray, walls[wallIdx].seg, intersection, wallT, u) || (wallT != t))))
+            {
+                fprintf(stderr, "intersect: %s finds a different hit for the ray from (%g, %g) to (%g, %g)\n", name.c_str(),
+                        static_cast<double>(ray.p1.x), static_cast<double>(ray.p1.y),
+                        static_cast<double>(ray.p2.x), static_cast<double>(ray.p2.y));
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool IntersectBench::Run(const BenchUtils::Options& options)
+{
+    BenchUtils::PrintHeader("intersect", {"rays", "walls/ray", "ns/ray", "M walls/s"});
+
+    // (the thousand-wall map, with every column's ray from some of the poses that the render
+    // suite uses)
+    std::vector<Wall> walls;
+    if (!BenchUtils::ReadWalls(BenchMapSourcesDir "/pillars.txt", walls))
+    {
+        fprintf(stderr, "intersect: could not read the walls from %s\n", BenchMapSourcesDir "/pillars.txt");
+        return false;
+    }
+    const uint8_t screenWidth {static_cast<uint8_t>(BenchUtils::GetGraphics().ScreenWidth)};
+    std::vector<Line> rays;
+    Camera camera({0.0f, 0.0f});
+    for (const CameraPaths::Pose& pose : CameraPaths::PillarsWalk(32))
+    {
+        camera.SetPose(pose.location, pose.headingRad);
+        Scalar percentWidth {-1.0f};
+        const Scalar percentWidthIncrement {2.0f / screenWidth};
+        for (uint8_t column = 0; column < screenWidth; column++, percentWidth += percentWidthIncrement)
+            rays.push_back({camera.location, camera.viewPlaneMiddle + camera.halfViewPlane * percentWidth});
+    }
+
+    std::vector<Scalar> expectedTs;
+    for (const Line& ray : rays)
+        expectedTs.push_back(FindClosestT(walls, ray));
+    PrintResult("geomutils", rays.size(), walls.size(),
+                TimePerRay(rays, [&walls](const Line& ray) { return FindClosestT(walls, ray); }, options));
+
+    // (the walls are also tested in a shuffled order, by index, as for the walls of a grid cell
+    // or a BVH leaf)
+    std::vector<WallSoa::WallIdx> wallIdxs;
+    for (size_t wallIdx = 0; wallIdx < walls.size(); wallIdx++)
+        wallIdxs.push_back(static_cast<WallSoa::WallIdx>(wallIdx));
+    std::shuffle(wallIdxs.begin(), wallIdxs.end(), std::mt19937(1));
+
+    WallSoa soa;
+    soa.Build(walls.data(), walls.size());
+    bool passed {true};
+    for (uint8_t k = 0; k <= static_cast<uint8_t>(WallSoa::GetBestKernel()); k++)
+    {
+        const WallSoa::Kernel kernel {static_cast<WallSoa::Kernel>(k)};
+        const std::string name {std::string("soa/") + GetKernelName(kernel)};
+        soa.SetKernel(kernel);
+        for (bool isGathered : {false, true})
+        {
+            const std::vector<WallSoa::WallIdx>* pWallIdxs {isGathered ? &wallIdxs : nullptr};
+            const std::string rowName {pWallIdxs ? (name + "/gathered") : name};
+            const WallSoa::WallIdx* pFirstIdx {pWallIdxs ? pWallIdxs->data() : nullptr};
+            PrintResult(rowName, rays.size(), walls.size(), TimePerRay(rays, [&soa, pFirstIdx, &walls](const Line& ray)
+            {
+                Scalar t {ScalarMax};
+                WallSoa::WallIdx wallIdx;
+                soa.FindClosestHit(ray, pFirstIdx, walls.size(), t, wallIdx);
+                return t;
+            }, options));
+            passed = CheckKernel(rowName, soa, walls, pWallIdxs, rays, expectedTs) && passed;
+        }
+    }
+
+    return passed;
+}
@@ -0,0 +1,25 @@
+//
+//  IntersectBench.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef IntersectBench_hpp
+#define IntersectBench_hpp
+
+#include "BenchUtils.hpp"
+
+// checks each of WallSoa's kernels against GeomUtils::FindRayLineSegIntersection() (which
+// must find exactly the same closest hits), and compares how many walls a second each of them
+// can test rays against
+class IntersectBench
+{
+public:
+    IntersectBench() = delete;
+    ~IntersectBench() = delete;
+
+    static bool Run(const BenchUtils::Options& options);
+};
+
+#endif /* IntersectBench_hpp */
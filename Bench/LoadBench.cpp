@@ -0,0 +1,142 @@
+//
+//  LoadBench.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "BspTree.hpp"
+#include "CameraPaths.hpp"
+#include "LoadBench.hpp"
+
+namespace
+{
+    // a checksum of everything that was loaded - all of the vertices, and the walls visited (in
+    // order) from each of the poses
+    uint32_t GetTreeChecksum(BspTree& bspTree, const std::vector<CameraPaths::Pose>& poses)
+    {
+        uint32_t checksum {0};
+        for (size_t vertexIdx = 0; vertexIdx < bspTree.GetNumVertices(); vertexIdx++)
+        {
+            const Vec2 vertex {bspTree.GetVertex(static_cast<BspTree::VertexIdx>(vertexIdx))};
+            checksum = (checksum * 31) + static_cast<uint32_t>(Fixed(vertex.x).GetEncoding());
+            checksum = (checksum * 31) + static_cast<uint32_t>(Fixed(vertex.y).GetEncoding());
+        }
+
+        Camera camera({0.0f, 0.0f});
+        for (const CameraPaths::Pose& pose : poses)
+        {
+            camera.SetPose(pose.location, pose.headingRad);
+            bspTree.TraverseRender(camera, [&checksum](BspTree::VertexIdx p1Idx, BspTree::VertexIdx p2Idx)
+            {
+                checksum = (checksum * 31) + (static_cast<uint32_t>(p1Idx) << 16) + p2Idx;
+                return true;
+            });
+        }
+        return checksum;
+    }
+
+    // the fastest of a number of runs of f
+    template <typename F>
+    double TimeBest(F f, size_t numRuns)
+    {
+        double bestNs {0.0f};
+        for (size_t run = 0; run < numRuns; run++)
+        {
+            BenchUtils::Timer timer;
+            f();
+            const double ns {timer.ElapsedNs()};
+            if ((run == 0) || (ns < bestNs))
+                bestNs = ns;
+        }
+        return bestNs;
+    }
+
+    void PrintResult(const std::string& name, size_t numRuns, size_t numWalls, size_t numBytes, double bestNs)
+    {
+        BenchUtils::PrintRow(name, {
+            static_cast<double>(numRuns),
+            static_cast<double>(numWalls),
+            static_cast<double>(numBytes),
+            bestNs / 1000.0f,
+            (numWalls > 0) ? bestNs / numWalls : 0.0f
+        });
+    }
+
+    bool ReadTree(const std::string& fileName, std::vector<uint8_t>& bytes)
+    {
+        if (!BenchUtils::ReadFile(fileName, bytes) || (BspTree::CheckBin(bytes.data(), bytes.size()) != BspTree::BinStatus::Ok))
+        {
+            fprintf(stderr, "load: could not read a valid tree from %s\n", fileName.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // returns false if the map couldn't be read, or the layouts loaded different trees (the
+    // compact tree is only compared if its coordinates didn't need rounding - see
+    // BspCompiler::GetCompactScale())
+    // (the trees must already have been compiled - see the bench_maps target)
+    bool RunScenario(const std::string& name, const std::vector<CameraPaths::Pose>& poses, bool isCompactExact,
+                     const BenchUtils::Options& options)
+    {
+        const std::string fileName {std::string(BenchMapsDir) + "/" + name};
+        std::vector<uint8_t> bytes, nativeBytes, compactBytes;
+        if (!ReadTree(fileName + ".bin", bytes) || !ReadTree(fileName + "_native.bin", nativeBytes) ||
+            !ReadTree(fileName + "_compact.bin", compactBytes))
+            return false;
+
+        const size_t numRuns {options.quick ? 5u : 100u};
+        BspTree bspTree;
+        BspTree nativeBspTree;
+        BspTree compactBspTree;
+
+        // (checking is part of loading, but is timed on its own too, as it is the same for both)
+        const double checkNs {TimeBest([&bytes]()
+        {
+            BenchUtils::DoNotOptimize(BspTree::CheckBin(bytes.data(), bytes.size()));
+        }, numRuns)};
+        const double portableNs {TimeBest([&bspTree, &bytes]() { bspTree.LoadBin(bytes.data()); }, numRuns)};
+        const double nativeNs {TimeBest([&nativeBspTree, &nativeBytes]() { nativeBspTree.LoadBin(nativeBytes.data()); }, numRuns)};
+        const double compactNs {TimeBest([&compactBspTree, &compactBytes]() { compactBspTree.LoadBin(compactBytes.data()); }, numRuns)};
+
+        // (a wall for each node, including the pieces of split walls)
+        const size_t numWalls {bspTree.GetNumNodes()};
+        PrintResult(name + "/check", numRuns, numWalls, bytes.size(), checkNs);
+        PrintResult(name + "/portable", numRuns, numWalls, bytes.size(), portableNs);
+        PrintResult(name + "/native", numRuns, numWalls, nativeBytes.size(), nativeNs);
+        PrintResult(name + "/compact", numRuns, numWalls, compactBytes.size(), compactNs);
+
+        bool passed {true};
+        const uint32_t checksum {GetTreeChecksum(bspTree, poses)};
+        if (GetTreeChecksum(nativeBspTree, poses) != checksum)
+        {
+            fprintf(stderr, "load: %s loads a different tree with native-endian sections\n", name.c_str());
+            passed = false;
+        }
+        if (isCompactExact && (GetTreeChecksum(compactBspTree, poses) != checksum))
+        {
+            fprintf(stderr, "load: %s loads a different tree in the compact layout\n", name.c_str());
+            passed = false;
+        }
+        return passed;
+    }
+}
+
+bool LoadBench::Run(const BenchUtils::Options& options)
+{
+    BenchUtils::PrintHeader("load", {"loads", "walls", "bytes", "us/load", "ns/wall"});
+    bool passed {true};
+    // (smileyFace's coordinates are rounded to fit the compact layout, but the pillars are all on
+    // whole numbers)
+    passed = RunScenario("smileyFace", CameraPaths::SmileyFaceWalk(100), false, options) && passed;
+#ifdef LargeBspTrees
+    passed = RunScenario("pillars", CameraPaths::PillarsWalk(100), true, options) && passed;
+    // (from the middle of the map, which is between pillars)
+    passed = RunScenario("pillars10k", CameraPaths::Spin({608.0f, 608.0f}, 100), true, options) && passed;
+#endif
+    return passed;
+}
@@ -0,0 +1,26 @@
+//
+//  LoadBench.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef LoadBench_hpp
+#define LoadBench_hpp
+
+#include "BenchUtils.hpp"
+
+// times loading compiled maps with BspTree::LoadBin(), in the portable (big-endian) layout vs.
+// with native-endian sections vs. in the compact layout (see BspTree::SerFlagNative and
+// BspTree::SerFlagCompact), up to a map of 10 thousand walls on the PC variant - and checks
+// that the layouts load the same tree
+class LoadBench
+{
+public:
+    LoadBench() = delete;
+    ~LoadBench() = delete;
+
+    static bool Run(const BenchUtils::Options& options);
+};
+
+#endif /* LoadBench_hpp */
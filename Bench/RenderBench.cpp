@@ -0,0 +1,417 @@
+//
+//  RenderBench.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+#include "RenderBench.hpp"
+#include "CameraPaths.hpp"
+#include "BspRenderer.hpp"
+#include "BspTreeBin.hpp"
+#include "Raycaster.hpp"
+
+namespace
+{
+    // CompareHeights() allows fewer than this many columns (per thousand) to be a pixel off, and
+    // none to be further off
+    constexpr size_t MaxOffByOnePerMille {5};
+    // (GetReferenceHeights() takes a ray that passes this close to a wall's end as hitting it, so
+    // that a ray can't slip through the corner between two walls there, when the raycaster's
+    // rounding closes it)
+    constexpr double ReferenceEndMargin {1.0 / 4096.0};
+
+    // renders every pose in the path once per pass, so that consecutive frames always
+    // come from different camera poses (as they would while moving in the game)
+    void RunScenario(const std::string& name,
+                     Renderer& renderer,
+                     Camera& camera,
+                     const std::vector<CameraPaths::Pose>& poses,
+                     const BenchUtils::Options& options)
+    {
+        const size_t numPasses {options.quick ? 2u : 20u};
+        OffscreenGraphics& graphics {BenchUtils::GetGraphics()};
+
+        // warm up caches etc.
+        for (const CameraPaths::Pose& pose : poses)
+        {
+            camera.SetPose(pose.location, pose.headingRad);
+            renderer.RenderScene();
+        }
+
+        std::vector<double> frameTimesNs;
+        frameTimesNs.reserve(numPasses * poses.size());
+        uint64_t nodesVisited {0};
+        uint64_t wallsVisited {0};
+        uint64_t columnsFilled {0};
+        uint64_t projectionsCached {0};
+        uint64_t projectionsComputed {0};
+
+        for (size_t pass = 0; pass < numPasses; pass++)
+        {
+            for (const CameraPaths::Pose& pose : poses)
+            {
+                camera.SetPose(pose.location, pose.headingRad);
+
+                BenchUtils::Timer timer;
+                renderer.RenderScene();
+                frameTimesNs.push_back(timer.ElapsedNs());
+
+                nodesVisited += renderer.GetStats().nodesVisited;
+                wallsVisited += renderer.GetStats().wallsVisited;
+                columnsFilled += renderer.GetStats().columnsFilled;
+                projectionsCached += renderer.GetStats().projectionsCached;
+                projectionsComputed += renderer.GetStats().projectionsComputed;
+            }
+        }
+
+        BenchUtils::Summary summary {frameTimesNs};
+        const double numFrames {static_cast<double>(summary.count)};
+        BenchUtils::PrintRow(name, {
+            numFrames,
+            summary.min,
+            summary.median,
+            summary.p99,
+            summary.median / static_cast<double>(graphics.ScreenWidth),
+            static_cast<double>(nodesVisited) / numFrames,
+            static_cast<double>(wallsVisited) / numFrames,
+            static_cast<double>(columnsFilled) / numFrames,
+            // (the share of wall end points that were already projected - 0 if there were none)
+            100.0f * static_cast<double>(projectionsCached) /
+                static_cast<double>(std::max<uint64_t>(projectionsCached + projectionsComputed, 1))
+        });
+    }
+
+    // returns false if the two renderers draw a different frame from any of the poses
+    bool CompareFrames(const std::string& name, Renderer& expected, Renderer& actual, Camera& camera,
+                       const std::vector<CameraPaths::Pose>& poses)
+    {
+        OffscreenGraphics& graphics {BenchUtils::GetGraphics()};
+        for (const CameraPaths::Pose& pose : poses)
+        {
+            camera.SetPose(pose.location, pose.headingRad);
+            expected.RenderScene();
+            const uint32_t checksum {graphics.GetScreenChecksum()};
+            actual.RenderScene();
+            if (graphics.GetScreenChecksum() != checksum)
+            {
+                fprintf(stderr, "render: %s draws a different frame from (%g, %g)\n", name.c_str(),
+                        static_cast<double>(pose.location.x), static_cast<double>(pose.location.y));
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // returns false if IsPathClear() doesn't give the same answer for the two raycasters, for
+    // paths between every pair of a sample of the poses' locations
+    bool ComparePaths(const std::string& name, const Raycaster& expected, const Raycaster& actual,
+                      const std::vector<CameraPaths::Pose>& poses)
+    {
+        const size_t step {std::max<size_t>(poses.size() / 16, 1)};
+        for (size_t from = 0; from < poses.size(); from += step)
+        {
+            for (size_t to = 0; to < poses.size(); to += step)
+            {
+                if (expected.IsPathClear(poses[from].location, poses[to].location) !=
+                    actual.IsPathClear(poses[from].location, poses[to].location))
+                {
+                    fprintf(stderr, "render: %s disagrees about the path from (%g, %g) to (%g, %g)\n", name.c_str(),
+                            static_cast<double>(poses[from].location.x), static_cast<double>(poses[from].location.y),
+                            static_cast<double>(poses[to].location.x), static_cast<double>(poses[to].location.y));
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // the column heights that the raycaster drew before it took the depth straight from how far
+    // along the ray a hit is - a ray for each column, tested against every wall, and the
+    // perpendicular depth from the hit's real distance (with a square root)
+    // (this is worked out in double precision even in the fixed-point build, from the same camera
+    // and walls, so that only the raycaster's rounding shows)
+    void GetReferenceHeights(const std::vector<Wall>& walls, const Camera& camera, uint8_t screenWidth,
+                             uint8_t screenHeight, std::vector<uint8_t>& heights)
+    {
+        heights.assign(screenWidth, 0);
+        const double px {static_cast<double>(camera.location.x)};
+        const double py {static_cast<double>(camera.location.y)};
+        Scalar percentWidth {-1.0f};
+        const Scalar percentWidthIncrement {2.0f / screenWidth};
+        for (uint8_t column = 0; column < screenWidth; column++, percentWidth += percentWidthIncrement)
+        {
+            const Vec2 viewPlanePoint {camera.viewPlaneMiddle + camera.halfViewPlane * percentWidth};
+            const double dx {static_cast<double>(viewPlanePoint.x) - px};
+            const double dy {static_cast<double>(viewPlanePoint.y) - py};
+            const double ratio {static_cast<double>(percentWidth) * static_cast<double>(camera.viewPlaneWidth) / 2.0 /
+                                static_cast<double>(camera.viewPlaneDist)};
+            double closest {std::numeric_limits<double>::max()};
+            for (const Wall& wall : walls)
+            {
+                // (as for GeomUtils::FindRayLineSegIntersection())
+                const double x1 {static_cast<double>(wall.seg.p1.x)};
+                const double y1 {static_cast<double>(wall.seg.p1.y)};
+                const double ex {static_cast<double>(wall.seg.p2.x) - x1};
+                const double ey {static_cast<double>(wall.seg.p2.y) - y1};
+                const double denominator {dx * ey - dy * ex};
+                if (denominator == 0.0)
+                    continue;
+                const double t {((x1 - px) * ey - (y1 - py) * ex) / denominator};
+                const double u {((x1 - px) * dy - (y1 - py) * dx) / denominator};
+                const double uMargin {ReferenceEndMargin / std::hypot(ex, ey)};
+                if ((t >= 0.0) && (u >= -uMargin) && (u <= 1.0 + uMargin))
+                    closest = std::min(closest, std::hypot(t * dx, t * dy) / std::sqrt(1.0 + ratio * ratio));
+            }
+            if (closest < std::numeric_limits<double>::max())
+            {
+                const double height {30.0 * screenHeight / closest};
+                heights[column] = static_cast<uint8_t>(std::min(height, static_cast<double>(screenHeight)));
+            }
+        }
+    }
+
+    // returns false if more than a few of the raycaster's column heights are a pixel off from the
+    // reference ones (rounding can move a wall's height across a whole pixel), or if any are
+    // further off
+    bool CompareHeights(const std::string& name, const std::vector<Wall>& walls, Renderer& raycaster, Camera& camera,
+                        const std::vector<CameraPaths::Pose>& poses)
+    {
+        OffscreenGraphics& graphics {BenchUtils::GetGraphics()};
+        const uint8_t screenWidth {static_cast<uint8_t>(graphics.ScreenWidth)};
+        const uint8_t screenHeight {static_cast<uint8_t>(graphics.ScreenHeight)};
+        std::vector<uint8_t> heights;
+        size_t numColumns {0};
+        size_t numOffByOne {0};
+        size_t numDifferent {0};
+        for (const CameraPaths::Pose& pose : poses)
+        {
+            camera.SetPose(pose.location, pose.headingRad);
+            raycaster.RenderScene();
+            GetReferenceHeights(walls, camera, screenWidth, screenHeight, heights);
+            for (uint8_t column = 0; column < screenWidth; column++)
+            {
+                const int expected {heights[column]};
+                const int actual {raycaster.GetColumnHeight(column)};
+                if ((abs(actual - expected) > 1) || ((actual == 0) != (expected == 0)))
+                    numDifferent++;
+                else if (actual != expected)
+                    numOffByOne++;
+            }
+            numColumns += screenWidth;
+        }
+
+        printf("%-30s %zu of %zu columns a pixel off, %zu further\n", (name + " heights").c_str(), numOffByOne,
+               numColumns, numDifferent);
+        if ((numOffByOne * 1000 >= numColumns * MaxOffByOnePerMille) || (numDifferent > 0))
+        {
+            fprintf(stderr, "render: %s draws too many columns at different heights from before\n", name.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // a serialized BVH that is a chain of numInner nodes, each with a leaf as its first child
+    // and the next one in the chain as its second (so it is numInner levels deep, though a stack
+    // of pending second children never holds more than one of them), ending in one more leaf
+    std::vector<uint8_t> MakeChainBvhBin(uint16_t numInner)
+    {
+        std::vector<uint8_t> bytes;
+        auto addUint16 = [&bytes](uint32_t n) { bytes.push_back(static_cast<uint8_t>(n >> 8)); bytes.push_back(static_cast<uint8_t>(n)); };
+        auto addUint = [&addUint16](uint32_t n) { addUint16(n >> 16); addUint16(n & 0xFFFF); };
+
+        const uint16_t numWalls {static_cast<uint16_t>(numInner + 1)};
+        const uint16_t numNodes {static_cast<uint16_t>(2 * numInner + 1)};
+        addUint(WallBvh::SerMagic);
+        addUint16(WallBvh::SerVersion);
+        addUint16(0);
+        addUint(static_cast<uint32_t>(WallBvh::SerHeaderSize + numNodes * WallBvh::SerNodeSize + numWalls * sizeof(WallBvh::WallIdx)));
+        addUint(0); // (the checksum, filled in below)
+        addUint16(numWalls);
+        addUint16(numNodes);
+        for (uint16_t nodeIdx = 0; nodeIdx < numNodes; nodeIdx++)
+        {
+            const bool isLeaf {(nodeIdx % 2 == 1) || (nodeIdx == numNodes - 1)};
+            addUint(0);
+            addUint(0);
+            addUint(0x20000);
+            addUint(0x10000);
+            addUint16(isLeaf ? nodeIdx / 2 : nodeIdx + 2);
+            addUint16(isLeaf ? 1 : 0);
+        }
+        for (uint16_t wallIdx = 0; wallIdx < numWalls; wallIdx++)
+            addUint16(wallIdx);
+
+        // (the checksum is at 12, and covers everything from 16 on and everything before itself)
+        const uint32_t crc {Serializer::Crc32(bytes.data(), 16, bytes.size() - 16, Serializer::Crc32(bytes.data(), 0, 12))};
+        for (size_t i = 0; i < 4; i++)
+            bytes[12 + i] = static_cast<uint8_t>(crc >> (24 - 8 * i));
+        return bytes;
+    }
+
+    // returns false if WallBvh::CheckBin() accepts a tree deeper than WallBvh::WalkRay()'s stack
+    // allows, or rejects one that is just deep enough
+    bool CheckDeepBvhBin()
+    {
+        const std::vector<uint8_t> deepest {MakeChainBvhBin(WallBvh::MaxDepth)};
+        const std::vector<uint8_t> tooDeep {MakeChainBvhBin(WallBvh::MaxDepth + 1)};
+        const bool passed {(WallBvh::CheckBin(deepest.data(), deepest.size(), WallBvh::MaxDepth + 1) == WallBvh::BinStatus::Ok) &&
+                           (WallBvh::CheckBin(tooDeep.data(), tooDeep.size(), WallBvh::MaxDepth + 2) == WallBvh::BinStatus::BadNode)};
+        if (!passed)
+            fprintf(stderr, "render: the depth of a BVH isn't checked properly when it is loaded\n");
+        return passed;
+    }
+
+    // every way of finding the walls that rays hit (see Raycaster::Search), which must agree -
+    // and a BVH built offline by bspc, and a BSP tree of the same walls, if there are any
+    bool RunRaycastScenarios(const std::string& name, const std::vector<Wall>& walls, Camera& camera,
+                             const std::vector<std::pair<std::string, std::vector<CameraPaths::Pose>>>& paths,
+                             const BenchUtils::Options& options, const std::vector<uint8_t>* pBvhBytes,
+                             const uint8_t* pBspBytes)
+    {
+        OffscreenGraphics& graphics {BenchUtils::GetGraphics()};
+        const uint8_t screenWidth {static_cast<uint8_t>(graphics.ScreenWidth)};
+        const uint8_t screenHeight {static_cast<uint8_t>(graphics.ScreenHeight)};
+        Raycaster allWalls(graphics.GetColumnBuffer(), screenWidth, screenHeight, BenchUtils::OnColRendered, camera,
+                           walls.data(), walls.size(), Raycaster::Search::AllWalls);
+        Raycaster grid(graphics.GetColumnBuffer(), screenWidth, screenHeight, BenchUtils::OnColRendered, camera,
+                       walls.data(), walls.size(), Raycaster::Search::Grid);
+        Raycaster bvh(graphics.GetColumnBuffer(), screenWidth, screenHeight, BenchUtils::OnColRendered, camera,
+                      walls.data(), walls.size(), Raycaster::Search::Bvh);
+        Raycaster loadedBvh(graphics.GetColumnBuffer(), screenWidth, screenHeight, BenchUtils::OnColRendered, camera,
+                            walls.data(), walls.size(), Raycaster::Search::Bvh);
+        if (pBvhBytes)
+            loadedBvh.LoadBvhBin(pBvhBytes->data());
+        BspTree bspTree;
+        if (pBspBytes)
+            bspTree.LoadBin(pBspBytes);
+        Raycaster bsp(graphics.GetColumnBuffer(), screenWidth, screenHeight, BenchUtils::OnColRendered, camera, bspTree);
+
+        bool passed {true};
+        for (const auto& path : paths)
+        {
+            const std::string pathName {"raycast/" + name + "/" + path.first};
+            RunScenario(pathName, allWalls, camera, path.second, options);
+            RunScenario(pathName + "/grid", grid, camera, path.second, options);
+            RunScenario(pathName + "/bvh", bvh, camera, path.second, options);
+            passed = CompareHeights(pathName, walls, allWalls, camera, path.second) && passed;
+            passed = CompareFrames(pathName + "/grid", allWalls, grid, camera, path.second) && passed;
+            passed = CompareFrames(pathName + "/bvh", allWalls, bvh, camera, path.second) && passed;
+            passed = ComparePaths(pathName + "/grid", allWalls, grid, path.second) && passed;
+            passed = ComparePaths(pathName + "/bvh", allWalls, bvh, path.second) && passed;
+            if (pBvhBytes)
+            {
+                RunScenario(pathName + "/bvh/bspc", loadedBvh, camera, path.second, options);
+                passed = CompareFrames(pathName + "/bvh/bspc", allWalls, loadedBvh, camera, path.second) && passed;
+                passed = ComparePaths(pathName + "/bvh/bspc", allWalls, loadedBvh, path.second) && passed;
+            }
+            if (pBspBytes)
+            {
+                RunScenario(pathName + "/bsp", bsp, camera, path.second, options);
+                passed = CompareFrames(pathName + "/bsp", allWalls, bsp, camera, path.second) && passed;
+                passed = ComparePaths(pathName + "/bsp", allWalls, bsp, path.second) && passed;
+            }
+        }
+        return passed;
+    }
+}
+
+bool RenderBench::Run(const BenchUtils::Options& options)
+{
+    OffscreenGraphics& graphics {BenchUtils::GetGraphics()};
+    const uint8_t screenWidth {static_cast<uint8_t>(graphics.ScreenWidth)};
+    const uint8_t screenHeight {static_cast<uint8_t>(graphics.ScreenHeight)};
+    const size_t numPoses {256};
+
+    BenchUtils::PrintHeader("render", {"frames", "min ns/frm", "med ns/frm", "p99 ns/frm", "med ns/col", "nodes/frm", "walls/frm", "cols fill/frm", "proj hit %"});
+
+    Camera camera({0.0f, 0.0f});
+
+    {
+        BspRenderer bspr(graphics.GetColumnBuffer(), screenWidth, screenHeight, BenchUtils::OnColRendered, camera);
+        bspr.LoadBin(smileyFaceBspTree);
+        RunScenario("bsp/smileyFace/walk", bspr, camera, CameraPaths::SmileyFaceWalk(numPoses), options);
+        RunScenario("bsp/smileyFace/spin", bspr, camera, CameraPaths::Spin({150.0f, 130.0f}, numPoses), options);
+    }
+
+    {
+        // (the tree is read from where it is, rather than copied - see BspTree::MapBin())
+        BspRenderer bspr(graphics.GetColumnBuffer(), screenWidth, screenHeight, BenchUtils::OnColRendered, camera);
+        bspr.MapBin(smileyFaceBspTree);
+        RunScenario("bsp/smileyFace/walk/mapped", bspr, camera, CameraPaths::SmileyFaceWalk(numPoses), options);
+    }
+
+    {
+        BspRenderer bspr(graphics.GetColumnBuffer(), screenWidth, screenHeight, BenchUtils::OnColRendered, camera);
+        bspr.LoadBin(basicAreaBspTree);
+        RunScenario("bsp/basicArea/walk", bspr, camera, CameraPaths::BasicAreaWalk(numPoses), options);
+        RunScenario("bsp/basicArea/spin", bspr, camera, CameraPaths::Spin({100.0f, 110.0f}, numPoses), options);
+    }
+
+#ifdef LargeBspTrees
+    // a thousand-wall map, for how rendering scales with the size of the map
+    {
+        std::vector<uint8_t> bytes;
+        if (!BenchUtils::ReadFile(BenchMapsDir "/pillars.bin", bytes) ||
+            (BspTree::CheckBin(bytes.data(), bytes.size()) != BspTree::BinStatus::Ok))
+        {
+            fprintf(stderr, "render: could not read a valid tree from %s\n", BenchMapsDir "/pillars.bin");
+            return false;
+        }
+        BspRenderer bspr(graphics.GetColumnBuffer(), screenWidth, screenHeight, BenchUtils::OnColRendered, camera);
+        bspr.LoadBin(bytes.data());
+        RunScenario("bsp/pillars/walk", bspr, camera, CameraPaths::PillarsWalk(numPoses), options);
+        RunScenario("bsp/pillars/spin", bspr, camera, CameraPaths::Spin({198.0f, 198.0f}, numPoses), options);
+    }
+#endif
+
+    // (the game's map, both as walls and as the BSP tree that the game loads)
+    bool passed {true};
+    std::vector<Wall> basicAreaWalls;
+    if (!BenchUtils::ReadWalls(BenchMapSourcesDir "/basicArea.txt", basicAreaWalls))
+    {
+        fprintf(stderr, "render: could not read the walls from %s\n", BenchMapSourcesDir "/basicArea.txt");
+        return false;
+    }
+    passed = RunRaycastScenarios("basicArea", basicAreaWalls, camera, {
+        {"walk", CameraPaths::BasicAreaWalk(numPoses)},
+        {"spin", CameraPaths::Spin({100.0f, 110.0f}, numPoses)}
+    }, options, nullptr, basicAreaBspTree) && passed;
+
+    // (the same thousand-wall map as for the BSP renderer - fewer poses, as testing every wall
+    // for every column is slow)
+    std::vector<Wall> pillarsWalls;
+    if (!BenchUtils::ReadWalls(BenchMapSourcesDir "/pillars.txt", pillarsWalls))
+    {
+        fprintf(stderr, "render: could not read the walls from %s\n", BenchMapSourcesDir "/pillars.txt");
+        return false;
+    }
+    // (the BSP tree is too big for the fixed-point build)
+    const uint8_t* pPillarsBsp {nullptr};
+#ifdef LargeBspTrees
+    std::vector<uint8_t> pillarsBsp;
+    if (BenchUtils::ReadFile(BenchMapsDir "/pillars.bin", pillarsBsp))
+        pPillarsBsp = pillarsBsp.data();
+#endif
+    std::vector<uint8_t> pillarsBvh;
+    if (!BenchUtils::ReadFile(BenchMapsDir "/pillars_bvh.bin", pillarsBvh) ||
+        (WallBvh::CheckBin(pillarsBvh.data(), pillarsBvh.size(), pillarsWalls.size()) != WallBvh::BinStatus::Ok))
+    {
+        fprintf(stderr, "render: could not read a valid BVH from %s\n", BenchMapsDir "/pillars_bvh.bin");
+        return false;
+    }
+    passed = RunRaycastScenarios("pillars", pillarsWalls, camera, {
+        {"walk", CameraPaths::PillarsWalk(numPoses / 4)},
+        {"spin", CameraPaths::Spin({198.0f, 198.0f}, numPoses / 4)}
+    }, options, &pillarsBvh, pPillarsBsp) && passed;
+
+    passed = CheckDeepBvhBin() && passed;
+    return passed;
+}
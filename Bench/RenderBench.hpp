@@ -0,0 +1,24 @@
+//
+//  RenderBench.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef RenderBench_hpp
+#define RenderBench_hpp
+
+#include "BenchUtils.hpp"
+
+// replays fixed camera paths through BspRenderer::RenderScene() and Raycaster::RenderScene()
+// and reports frame times along with how much work was done per frame
+class RenderBench
+{
+public:
+    RenderBench() = delete;
+    ~RenderBench() = delete;
+
+    static bool Run(const BenchUtils::Options& options);
+};
+
+#endif /* RenderBench_hpp */
@@ -0,0 +1,211 @@
+//
+//  TraversalBench.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "BspTree.hpp"
+#include "BspTreeBin.hpp"
+#include "CameraPaths.hpp"
+#include "Serializer.hpp"
+#include "TraversalBench.hpp"
+
+namespace
+{
+    // what the callbacks do with each wall - just enough to fold the visiting order into a
+    // checksum, so that the traversal itself is most of what's timed
+    class Visit
+    {
+    public:
+        void Add(BspTree::VertexIdx p1Idx, BspTree::VertexIdx p2Idx)
+        {
+            checksum = (checksum * 31) + (static_cast<uint32_t>(p1Idx) << 8) + p2Idx;
+            numWalls++;
+        }
+
+        uint32_t checksum {0};
+        size_t numWalls {0};
+    };
+
+    bool AddWall(BspTree::VertexIdx p1Idx, BspTree::VertexIdx p2Idx, void* ptr)
+    {
+        static_cast<Visit*>(ptr)->Add(p1Idx, p2Idx);
+        return true;
+    }
+
+    class Result
+    {
+    public:
+        double bestNs;
+        uint64_t bestCycles;
+        Visit visit; // (totals over all of the poses)
+    };
+
+    // traverses the tree from every pose, keeping the fastest of a few passes
+    template <typename F>
+    Result TimeTraversals(F traverse, const std::vector<CameraPaths::Pose>& poses, const BenchUtils::Options& options)
+    {
+        Camera camera({0.0f, 0.0f});
+        const size_t numPasses {options.quick ? 5u : 100u};
+        Result result {0.0f, 0, {}};
+        for (size_t pass = 0; pass < numPasses; pass++)
+        {
+            Visit visit;
+            BenchUtils::Timer timer;
+            uint64_t startCycles {BenchUtils::ReadCycleCounter()};
+            for (const CameraPaths::Pose& pose : poses)
+            {
+                camera.SetPose(pose.location, pose.headingRad);
+                traverse(camera, visit);
+            }
+            uint64_t cycles {BenchUtils::ReadCycleCounter() - startCycles};
+            double ns {timer.ElapsedNs()};
+            BenchUtils::DoNotOptimize(visit);
+            if ((pass == 0) || (ns < result.bestNs))
+                result = {ns, cycles, visit};
+        }
+        return result;
+    }
+
+    void PrintResult(const std::string& name, const Result& result, size_t numPoses)
+    {
+        const double numFrames {static_cast<double>(numPoses)};
+        const double numWalls {static_cast<double>(result.visit.numWalls)};
+        BenchUtils::PrintRow(name, {
+            numFrames,
+            numWalls / numFrames,
+            result.bestNs / numFrames,
+            (numWalls > 0) ? result.bestNs / numWalls : 0.0f,
+            static_cast<double>(result.bestCycles) / numFrames
+        });
+    }
+
+    // returns false if the different ways of traversing the tree visited different walls
+    bool RunScenario(const std::string& name, const uint8_t* bspTreeBin,
+                     const std::vector<CameraPaths::Pose>& poses, const BenchUtils::Options& options)
+    {
+        BspTree bspTree;
+        bspTree.LoadBin(bspTreeBin);
+        // (compact trees can't be used in place, so they have no "mapped" row)
+        const bool canMap {BspTree::CanMapBin(bspTreeBin)};
+        BspTree mappedBspTree;
+        if (canMap)
+            mappedBspTree.MapBin(bspTreeBin);
+
+        Result funcPtr {TimeTraversals([&bspTree](const Camera& camera, Visit& visit)
+        {
+            bspTree.TraverseRender(camera, AddWall, &visit);
+        }, poses, options)};
+        Result visitor {TimeTraversals([&bspTree](const Camera& camera, Visit& visit)
+        {
+            bspTree.TraverseRender(camera, [&visit](BspTree::VertexIdx p1Idx, BspTree::VertexIdx p2Idx)
+            {
+                visit.Add(p1Idx, p2Idx);
+                return true;
+            });
+        }, poses, options)};
+
+        // (the same as the visitor, but reading the tree in place - see BspTree::MapBin())
+        Result mapped {};
+        if (canMap)
+        {
+            mapped = TimeTraversals([&mappedBspTree](const Camera& camera, Visit& visit)
+            {
+                mappedBspTree.TraverseRender(camera, [&visit](BspTree::VertexIdx p1Idx, BspTree::VertexIdx p2Idx)
+                {
+                    visit.Add(p1Idx, p2Idx);
+                    return true;
+                });
+            }, poses, options);
+        }
+
+        PrintResult(name + "/funcPtr", funcPtr, poses.size());
+        PrintResult(name + "/visitor", visitor, poses.size());
+        if (canMap)
+            PrintResult(name + "/mapped", mapped, poses.size());
+
+        bool passed {true};
+        if ((funcPtr.visit.checksum != visitor.visit.checksum) || (funcPtr.visit.numWalls != visitor.visit.numWalls))
+        {
+            fprintf(stderr, "traversal: %s visits different walls with a visitor than with a function pointer\n", name.c_str());
+            passed = false;
+        }
+        if (canMap && ((mapped.visit.checksum != visitor.visit.checksum) || (mapped.visit.numWalls != visitor.visit.numWalls)))
+        {
+            fprintf(stderr, "traversal: %s visits different walls when it is used in place than when it is loaded\n", name.c_str());
+            passed = false;
+        }
+        return passed;
+    }
+
+    // returns false if a damaged copy of the tree isn't rejected by BspTree::CheckBin()
+    bool CheckDamagedBin(const std::string& name, const uint8_t* bspTreeBin)
+    {
+        size_t sizeOffset {8};
+        const size_t size {Serializer::DeSerUint(bspTreeBin, sizeOffset)};
+        if (size < BspTree::SerHeaderSize)
+        {
+            fprintf(stderr, "traversal: %s is too small to be a tree\n", name.c_str());
+            return false;
+        }
+        const std::vector<uint8_t> bytes(bspTreeBin, bspTreeBin + size);
+
+        std::vector<uint8_t> flipped {bytes};
+        flipped.back() ^= 0x01;
+
+        // a header that says the tree is shallower than it is, with the checksum fixed up to
+        // match, so that only the nodes can give it away (the depth is at offset 20, and the
+        // checksum at 12, covering everything from 16 on and everything before itself)
+        std::vector<uint8_t> shallow {bytes};
+        size_t depthOffset {20};
+        const uint16_t depth {static_cast<uint16_t>(Serializer::DeSerUint16(bytes.data(), depthOffset) - 1)};
+        shallow[20] = static_cast<uint8_t>(depth >> 8);
+        shallow[21] = static_cast<uint8_t>(depth);
+        const uint32_t crc {Serializer::Crc32(shallow.data(), 16, size - 16, Serializer::Crc32(shallow.data(), 0, 12))};
+        for (size_t i = 0; i < 4; i++)
+            shallow[12 + i] = static_cast<uint8_t>(crc >> (24 - 8 * i));
+
+        const bool passed {(BspTree::CheckBin(bytes.data(), size) == BspTree::BinStatus::Ok) &&
+                           (BspTree::CheckBin(bytes.data(), size - 1) == BspTree::BinStatus::BadSize) &&
+                           (BspTree::CheckBin(flipped.data(), size) == BspTree::BinStatus::BadChecksum) &&
+                           (BspTree::CheckBin(shallow.data(), size) == BspTree::BinStatus::BadNode)};
+        if (!passed)
+            fprintf(stderr, "traversal: %s isn't checked properly when it is loaded\n", name.c_str());
+        return passed;
+    }
+}
+
+bool TraversalBench::Run(const BenchUtils::Options& options)
+{
+    const size_t numPoses {options.quick ? 100u : 1000u};
+
+    // (cycles are from the time stamp counter, so are 0 where there isn't one)
+    BenchUtils::PrintHeader("traversal", {"frames", "walls/frame", "ns/frame", "ns/wall", "cycles/frame"});
+    bool passed {true};
+    passed = RunScenario("smileyFace", smileyFaceBspTree, CameraPaths::SmileyFaceWalk(numPoses), options) && passed;
+    passed = RunScenario("basicArea", basicAreaBspTree, CameraPaths::BasicAreaWalk(numPoses), options) && passed;
+    passed = CheckDamagedBin("smileyFace", smileyFaceBspTree) && passed;
+    passed = CheckDamagedBin("basicArea", basicAreaBspTree) && passed;
+#ifdef LargeBspTrees
+    std::vector<uint8_t> bytes;
+    if (!BenchUtils::ReadFile(BenchMapsDir "/pillars.bin", bytes))
+    {
+        fprintf(stderr, "traversal: could not read %s\n", BenchMapsDir "/pillars.bin");
+        passed = false;
+    }
+    else if (BspTree::CheckBin(bytes.data(), bytes.size()) != BspTree::BinStatus::Ok)
+    {
+        fprintf(stderr, "traversal: %s is not a valid tree\n", BenchMapsDir "/pillars.bin");
+        passed = false;
+    }
+    else
+    {
+        passed = RunScenario("pillars", bytes.data(), CameraPaths::PillarsWalk(numPoses), options) && passed;
+    }
+#endif
+    return passed;
+}
@@ -0,0 +1,26 @@
+//
+//  TraversalBench.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef TraversalBench_hpp
+#define TraversalBench_hpp
+
+#include "BenchUtils.hpp"
+
+// times walking the shipped BSP trees front to back with BspTree::TraverseRender(), calling
+// back through a function pointer vs. through an inlined visitor, and with the tree loaded into
+// RAM vs. used in place, and checks that they all visit the same walls in the same order (and
+// that a damaged tree is rejected before it is loaded)
+class TraversalBench
+{
+public:
+    TraversalBench() = delete;
+    ~TraversalBench() = delete;
+
+    static bool Run(const BenchUtils::Options& options);
+};
+
+#endif /* TraversalBench_hpp */
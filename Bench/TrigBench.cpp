@@ -0,0 +1,174 @@
+//
+//  TrigBench.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "TrigBench.hpp"
+#include "Trig.hpp"
+
+namespace
+{
+    // errors are printed in millionths, as they would otherwise all round to 0.0
+    constexpr double ErrScale {1000000.0f};
+
+    class ErrorStats
+    {
+    public:
+        void Add(double err)
+        {
+            err = std::fabs(err);
+            maxErr = std::max(maxErr, err);
+            sumSqErr += err * err;
+            count++;
+        }
+        double Max() const { return maxErr * ErrScale; }
+        double Rms() const { return (count ? std::sqrt(sumSqErr / static_cast<double>(count)) * ErrScale : 0.0f); }
+
+    private:
+        double maxErr {0.0f};
+        double sumSqErr {0.0f};
+        size_t count {0};
+    };
+
+    // the difference between two angles, in radians, allowing for wrapping around
+    double AngleDiff(double a, double b)
+    {
+        return std::remainder(a - b, 2.0f * M_PI);
+    }
+
+    // calls f for every input, keeping the fastest of a few passes, in ns per call
+    template <typename In, typename F>
+    double TimePerCall(const std::vector<In>& inputs, F f, const BenchUtils::Options& options)
+    {
+        const size_t numPasses {options.quick ? 3u : 30u};
+        double bestNs {0.0f};
+        for (size_t pass = 0; pass < numPasses; pass++)
+        {
+            BenchUtils::Timer timer;
+            for (const In& input : inputs)
+                BenchUtils::DoNotOptimize(f(input));
+            double ns {timer.ElapsedNs()};
+            if ((pass == 0) || (ns < bestNs))
+                bestNs = ns;
+        }
+        return bestNs / static_cast<double>(inputs.size());
+    }
+
+    void PrintResult(const std::string& name, size_t numInputs, const ErrorStats& err, double nsPerCall)
+    {
+        BenchUtils::PrintRow(name, {static_cast<double>(numInputs), err.Max(), err.Rms(), nsPerCall});
+    }
+}
+
+bool TrigBench::Run(const BenchUtils::Options& options)
+{
+    BenchUtils::PrintHeader("trig", {"inputs", "max err e-6", "rms err e-6", "ns/call"});
+
+    // every binary angle, and the same angles in radians for the math library
+    std::vector<Trig::Angle> angles;
+    std::vector<double> anglesRad;
+    for (uint32_t a = 0; a <= 0xFFFF; a++)
+    {
+        angles.push_back(static_cast<Trig::Angle>(a));
+        anglesRad.push_back(Trig::ToRadians(static_cast<Trig::Angle>(a)));
+    }
+
+    {
+        ErrorStats err;
+        for (Trig::Angle a : angles)
+            err.Add(static_cast<double>(Trig::ToFixedRadians(a)) - Trig::ToRadians(a));
+        PrintResult("toradians/fixed", angles.size(), err,
+                    TimePerCall(angles, [](Trig::Angle a) { return Trig::ToFixedRadians(a); }, options));
+        PrintResult("toradians/double", angles.size(), ErrorStats(),
+                    TimePerCall(angles, [](Trig::Angle a) { return Trig::ToRadians(a); }, options));
+    }
+
+    {
+        ErrorStats err;
+        for (Trig::Angle a : angles)
+            err.Add(static_cast<double>(Trig::Sin(a)) - std::sin(Trig::ToRadians(a)));
+        PrintResult("sin/table", angles.size(), err,
+                    TimePerCall(angles, [](Trig::Angle a) { return Trig::Sin(a); }, options));
+        PrintResult("sin/libm", angles.size(), ErrorStats(),
+                    TimePerCall(anglesRad, [](double a) { return std::sin(a); }, options));
+    }
+
+    {
+        ErrorStats err;
+        for (Trig::Angle a : angles)
+            err.Add(static_cast<double>(Trig::Cos(a)) - std::cos(Trig::ToRadians(a)));
+        PrintResult("cos/table", angles.size(), err,
+                    TimePerCall(angles, [](Trig::Angle a) { return Trig::Cos(a); }, options));
+        PrintResult("cos/libm", angles.size(), ErrorStats(),
+                    TimePerCall(anglesRad, [](double a) { return std::cos(a); }, options));
+    }
+
+    {
+        // (relative error where the tangent is large - close to a quarter turn either way, the
+        // tangent changes far faster than the angle's resolution, so those angles are skipped)
+        ErrorStats err;
+        for (Trig::Angle a : angles)
+        {
+            double ref {std::tan(Trig::ToRadians(a))};
+            if (std::fabs(ref) <= 10.0f)
+                err.Add((static_cast<double>(Trig::Tan(a)) - ref) / std::max(1.0, std::fabs(ref)));
+        }
+        PrintResult("tan/table", angles.size(), err,
+                    TimePerCall(angles, [](Trig::Angle a) { return Trig::Tan(a); }, options));
+        PrintResult("tan/libm", angles.size(), ErrorStats(),
+                    TimePerCall(anglesRad, [](double a) { return std::tan(a); }, options));
+    }
+
+    {
+        // points all around circles of a few different sizes (errors are in radians)
+        std::vector<std::pair<Scalar, Scalar>> points;
+        std::vector<std::pair<double, double>> pointsDouble;
+        for (double radius : {0.01, 1.0, 50.0, 300.0})
+        {
+            for (size_t i = 0; i < 4096; i++)
+            {
+                double angleRad {2.0f * M_PI * static_cast<double>(i) / 4096.0f};
+                Scalar y {radius * std::sin(angleRad)};
+                Scalar x {radius * std::cos(angleRad)};
+                points.push_back({y, x});
+                pointsDouble.push_back({static_cast<double>(y), static_cast<double>(x)});
+            }
+        }
+
+        ErrorStats err;
+        for (size_t i = 0; i < points.size(); i++)
+            err.Add(AngleDiff(Trig::ToRadians(Trig::Atan2(points[i].first, points[i].second)),
+                              std::atan2(pointsDouble[i].first, pointsDouble[i].second)));
+        PrintResult("atan2/table", points.size(), err,
+                    TimePerCall(points, [](const std::pair<Scalar, Scalar>& p) { return Trig::Atan2(p.first, p.second); }, options));
+        PrintResult("atan2/libm", points.size(), ErrorStats(),
+                    TimePerCall(pointsDouble, [](const std::pair<double, double>& p) { return std::atan2(p.first, p.second); }, options));
+    }
+
+    {
+        std::vector<Scalar> inputs;
+        std::vector<double> inputsDouble;
+        for (int32_t i = -4096; i <= 4096; i++)
+        {
+            Scalar n {static_cast<double>(i) / 4096.0f};
+            inputs.push_back(n);
+            inputsDouble.push_back(static_cast<double>(n));
+        }
+
+        ErrorStats err;
+        for (size_t i = 0; i < inputs.size(); i++)
+            err.Add(AngleDiff(Trig::ToRadians(Trig::Acos(inputs[i])), std::acos(inputsDouble[i])));
+        PrintResult("acos/table", inputs.size(), err,
+                    TimePerCall(inputs, [](Scalar n) { return Trig::Acos(n); }, options));
+        PrintResult("acos/libm", inputs.size(), ErrorStats(),
+                    TimePerCall(inputsDouble, [](double n) { return std::acos(n); }, options));
+    }
+
+    return true;
+}
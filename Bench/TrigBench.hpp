@@ -0,0 +1,24 @@
+//
+//  TrigBench.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef TrigBench_hpp
+#define TrigBench_hpp
+
+#include "BenchUtils.hpp"
+
+// checks the accuracy of the lookup-table trig. functions in Trig against the math library,
+// and compares their speed
+class TrigBench
+{
+public:
+    TrigBench() = delete;
+    ~TrigBench() = delete;
+
+    static bool Run(const BenchUtils::Options& options);
+};
+
+#endif /* TrigBench_hpp */
@@ -0,0 +1,98 @@
+//
+//  main.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+// benchmark suites for the renderers (and their building blocks), run headless
+//
+// usage: walls3duino_bench [--quick] [suite...]
+//   --quick  fewer repetitions (for a quick sanity check rather than real numbers)
+//   suite    one or more of the suites listed below (default: all of them)
+//
+// some suites also check results against reference implementations - the exit status is
+// non-zero if any of those checks fail
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BenchUtils.hpp"
+#include "ColumnBench.hpp"
+#include "IntersectBench.hpp"
+#include "LoadBench.hpp"
+#include "RenderBench.hpp"
+#include "TraversalBench.hpp"
+#include "TrigBench.hpp"
+
+namespace
+{
+    class Suite
+    {
+    public:
+        const char* name;
+        bool (*run)(const BenchUtils::Options& options); // returns false if a check failed
+    };
+
+    const Suite suites[]
+    {
+        { "render", RenderBench::Run },
+        { "trig", TrigBench::Run },
+        { "column", ColumnBench::Run },
+        { "traversal", TraversalBench::Run },
+        { "intersect", IntersectBench::Run },
+        { "load", LoadBench::Run },
+    };
+}
+
+int main(int argc, const char * argv[])
+{
+    BenchUtils::Options options;
+    std::vector<std::string> selected;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--quick"))
+        {
+            options.quick = true;
+        }
+        else if (argv[i][0] != '-')
+        {
+            selected.push_back(argv[i]);
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--quick] [suite...]" << std::endl;
+            std::cerr << "suites:";
+            for (const Suite& suite : suites)
+                std::cerr << " " << suite.name;
+            std::cerr << std::endl;
+            return 1;
+        }
+    }
+
+    for (const std::string& name : selected)
+    {
+        bool found {false};
+        for (const Suite& suite : suites)
+            found = found || (name == suite.name);
+        if (!found)
+        {
+            std::cerr << "unknown suite: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    bool passed {true};
+    for (const Suite& suite : suites)
+    {
+        bool run {selected.empty()};
+        for (const std::string& name : selected)
+            run = run || (name == suite.name);
+        if (run)
+            passed = suite.run(options) && passed;
+    }
+
+    return (passed ? 0 : 1);
+}
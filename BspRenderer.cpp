@@ -16,7 +16,9 @@ BspRenderer::BspRenderer(uint8_t* pPixelBuf,
                          ColRenderedCbType colRenderedCb,
                          const Camera& camera):
     Renderer(pPixelBuf, screenWidth, screenHeight, colRenderedCb, camera),
-    pHeightBuffer{new uint8_t[screenWidth]}
+    pHeightBuffer{new uint8_t[screenWidth]},
+    coverage{screenWidth},
+    projections{camera, screenWidth}
 {
 }
 
@@ -28,102 +30,195 @@ BspRenderer::~BspRenderer()
 void BspRenderer::LoadBin(const uint8_t* bytes)
 {
     bspTree.LoadBin(bytes);
+    projections.SetNumVertices(bspTree.GetNumVertices());
+}
+
+void BspRenderer::MapBin(const uint8_t* bytes)
+{
+    bspTree.MapBin(bytes);
+    projections.SetNumVertices(bspTree.GetNumVertices());
 }
 
 void BspRenderer::RenderScene()
 {
     BeginRender();
     memset(pHeightBuffer, 0, screenWidth * sizeof(uint8_t));
-    bspTree.TraverseRender(camera.location, RenderWallStatic, this);
+    coverage.Clear();
+    projections.BeginFrame();
+    bspTree.TraverseRender(camera,
+                           [this](BspTree::VertexIdx p1Idx, BspTree::VertexIdx p2Idx) { return RenderWall(p1Idx, p2Idx); },
+                           [this](const Vec2& boxMin, const Vec2& boxMax) { return IsBoxHidden(boxMin, boxMax); });
+#ifdef SDLSim
+    stats.projectionsCached = projections.GetNumHits();
+    stats.projectionsComputed = projections.GetNumMisses();
+    stats.nodesVisited = bspTree.GetNumNodesVisited();
+#endif
     for (uint8_t x = 0; x < screenWidth; x++)
         RenderColumn(x, pHeightBuffer[x]);
     EndRender();
 }
 
-bool BspRenderer::RenderWallStatic(const Wall& wall, void* bspRenderer)
+bool BspRenderer::RenderWall(BspTree::VertexIdx p1Idx, BspTree::VertexIdx p2Idx)
 {
-    return static_cast<BspRenderer*>(bspRenderer)->RenderWall(wall);
-}
+#ifdef SDLSim
+    stats.wallsVisited++;
+#endif
 
-bool BspRenderer::RenderWall(const Wall &wall)
-{
-    // but this doesn't mean that the wall is "in front of" the camera
-    // as per the camera's view direction
-    // cull any walls that are entirely behind the camera to reduce processing
-    if (!camera.IsBehind(wall.seg))
+    // (vertices are projected once, and then shared by all of the walls that use them)
+    const ProjectionCache::Projection* pProjection1 {projections.Get(p1Idx, bspTree)};
+    const ProjectionCache::Projection* pProjection2 {projections.Get(p2Idx, bspTree)};
+
+    bool p1IsOnScreen {false}, p2IsOnScreen {false};
+    uint8_t screenXP1 {0}, screenXP2 {0};
+    Scalar distP1 {0.0f}, distP2 {0.0f};
+
+    if (pProjection1 && pProjection2)
+    {
+        // (most walls are entirely on screen, and need nothing but the cache)
+        p1IsOnScreen = p2IsOnScreen = true;
+        screenXP1 = pProjection1->screenX;
+        distP1 = pProjection1->depth;
+        screenXP2 = pProjection2->screenX;
+        distP2 = pProjection2->depth;
+    }
+    else
     {
+        // otherwise the wall may need clipping, which is done in view space
+        Vec2 viewP1 {camera.ToViewSpace(bspTree.GetVertex(p1Idx))};
+        Vec2 viewP2 {camera.ToViewSpace(bspTree.GetVertex(p2Idx))};
+
+        // but this doesn't mean that the wall is "in front of" the camera
+        // as per the camera's view direction
+        // cull any walls that are entirely behind the camera to reduce processing
+        if ((viewP1.y < ProjectionCache::nearPlaneDist) && (viewP2.y < ProjectionCache::nearPlaneDist))
+            return !coverage.IsFull();
+
         // at this point, we can safely assume that the p2 vertex of the wall is to the right
         // of the p1 vertex in screen coordinates!
         
-        bool p1IsOnScreen {false}, p2IsOnScreen {false};
-        uint8_t screenXP1, screenXP2;
-        double distP1, distP2;
+        if (viewP1.y < ProjectionCache::nearPlaneDist)
+            viewP1 = ClipToNearPlane(viewP1, viewP2);
+        else if (viewP2.y < ProjectionCache::nearPlaneDist)
+            viewP2 = ClipToNearPlane(viewP2, viewP1);
         
         // get properties for screen x and distance for each vertex, with clipping
-        p1IsOnScreen = ClipAndGetAttributes(true, wall.seg, screenXP1, distP1);
-        p2IsOnScreen = ClipAndGetAttributes(false, wall.seg, screenXP2, distP2);
+        // (a vertex that is on screen can't have been clipped to the near plane, so its cached
+        // screen x can be used as is)
+        if (pProjection1)
+        {
+            p1IsOnScreen = true;
+            screenXP1 = pProjection1->screenX;
+            distP1 = pProjection1->depth;
+        }
+        else
+        {
+            p1IsOnScreen = ClipAndGetAttributes(true, viewP1, viewP2, screenXP1, distP1);
+        }
+        if (pProjection2)
+        {
+            p2IsOnScreen = true;
+            screenXP2 = pProjection2->screenX;
+            distP2 = pProjection2->depth;
+        }
+        else
+        {
+            p2IsOnScreen = ClipAndGetAttributes(false, viewP2, viewP1, screenXP2, distP2);
+        }
+    }
+
+    // if both (clipped) vertices are on screen, fill in the middle
+    // (but only the columns that closer walls haven't already filled)
+    if (p1IsOnScreen && p2IsOnScreen && (screenXP1 <= screenXP2))
+    {
+        Scalar columnHeightP1 {GetColumnHeightByDistance(distP1)};
+        Scalar columnHeightP2 {GetColumnHeightByDistance(distP2)};
+        
+        uint8_t screenXDifference {static_cast<uint8_t>(screenXP2 - screenXP1)};
+        Scalar columnHeightIncrement {screenXDifference > 0 ?
+                                      (columnHeightP2 - columnHeightP1) / static_cast<Scalar>(screenXDifference) :
+                                      0.0f};
         
-        // if both (clipped) vertices are on screen, fill in the middle
-        if (p1IsOnScreen && p2IsOnScreen)
+        uint8_t runStart {screenXP1};
+        while (coverage.FindOpen(runStart, screenXP2, runStart))
         {
-            double columnHeightP1 {GetColumnHeightByDistance(distP1)};
-            double columnHeightP2 {GetColumnHeightByDistance(distP2)};
+            uint8_t runEnd {coverage.FindOpenRunEnd(runStart, screenXP2)};
+            Scalar columnHeight {columnHeightP1 + columnHeightIncrement * static_cast<Scalar>(runStart - screenXP1)};
             
-            double columnHeight {columnHeightP1};
-            uint8_t screenXDifference {static_cast<uint8_t>(screenXP2 - screenXP1)};
-            double columnHeightIncrement {(columnHeightP2 - columnHeightP1) / static_cast<double>(screenXDifference)};
-            
-            for (uint8_t screenX = screenXP1; screenX <= screenXP2; screenX++)
+            for (uint8_t screenX = runStart; screenX <= runEnd; screenX++)
             {
-                if (pHeightBuffer[screenX] == 0)
-                    pHeightBuffer[screenX] = GetClippedHeight(columnHeight);
-
+                pHeightBuffer[screenX] = GetClippedHeight(columnHeight);
                 columnHeight += columnHeightIncrement;
             }
+            
+            coverage.CoverOpenRun(runStart, runEnd);
+#ifdef SDLSim
+            stats.columnsFilled += (runEnd - runStart + 1);
+#endif
+            
+            if (runEnd == screenXP2)
+                break;
+            runStart = runEnd + 1;
         }
-        // else the wall is in front of the camera, but entirely outside the field of view to the right
-        // or the left
     }
+    // else the wall is in front of the camera, but entirely outside the field of view to the right
+    // or the left
 
     // do not continue traversing/rendering the BSP tree if all columns
     // have been filled - since traversal happens near to far (opposite
     // of the painter's algorithm), this is a safe/correct optimization
-    bool cont {false};
-    for (uint8_t x = 0; x < screenWidth; x++)
-        if (pHeightBuffer[x] == 0)
-        {
-            cont = true;
-            break;
-        }
-        
-    return cont;
+    return !coverage.IsFull();
 }
 
-// (angleFromCamera could be figured out, but it is passed in for efficiency, as it has already been calculated)
-double BspRenderer::GetPerpendicularDistanceFromCameraByAngle(const Vec2& point, double angleFromCamera)
+// whether a box (around a subtree of walls) could only be drawn in columns which have already
+// been drawn, so that nothing inside it can be seen
+// (this is like checking a node's bounding box against the "solid segs" in the Doom engine)
+bool BspRenderer::IsBoxHidden(const Vec2& boxMin, const Vec2& boxMax) const
 {
-    double euclideanDistance {(point - camera.location).Mag()};
-    return euclideanDistance * cos(angleFromCamera);
+    // (there's no point projecting the box before anything has been drawn)
+    if (coverage.IsEmpty())
+        return false;
+
+    // everything inside the box is between its leftmost and rightmost corners on the screen,
+    // unless the box is (partly) behind the camera, when it could be anywhere
+    const Vec2 corners[] {boxMin, {boxMax.x, boxMin.y}, boxMax, {boxMin.x, boxMax.y}};
+    uint8_t fromX {static_cast<uint8_t>(screenWidth - 1)};
+    uint8_t toX {0};
+    for (const Vec2& corner : corners)
+    {
+        Vec2 viewP {camera.ToViewSpace(corner)};
+        if (viewP.y < ProjectionCache::nearPlaneDist)
+            return false;
+
+        uint8_t screenX {GetScreenXClamped(viewP)};
+        if (screenX < fromX) fromX = screenX;
+        if (screenX > toX) toX = screenX;
+    }
+
+    // (the corners' screen x may have been rounded differently from that of the walls' end
+    // points, so one more column is checked on each side)
+    if (fromX > 0) fromX--;
+    if (toX < screenWidth - 1) toX++;
+    return coverage.IsRangeCovered(fromX, toX);
 }
 
-double BspRenderer::GetAngleFromCamera(const Vec2& location)
+// the screen x of a view space point (in front of the camera), or the nearest edge of the
+// screen if the point is outside the field of view
+uint8_t BspRenderer::GetScreenXClamped(const Vec2& viewP) const
 {
-    Vec2 diffVectN {(location - camera.location).Norm()};
-    double absAngleFromCameraDir {GeomUtils::AngleBetweenNorm(camera.dirN, diffVectN)};
-    
-    // we need to do the cross product in order to tell if this angle
-    // is to the left of or the right of the camera's direction
-    return (camera.dirN.cross(diffVectN) > 0 ? absAngleFromCameraDir : -absAngleFromCameraDir);
+    if (projections.GetDistInsideFovEdge(true, viewP) < 0)
+        return 0;
+    if (projections.GetDistInsideFovEdge(false, viewP) < 0)
+        return (screenWidth - 1);
+    return projections.GetScreenX(viewP);
 }
 
-uint8_t BspRenderer::GetScreenXFromAngle(double angle)
+// moves a view space point which is too close to (or behind) the camera along the wall, to
+// where the wall crosses the near plane
+// (the other end of the wall must be past the near plane)
+Vec2 BspRenderer::ClipToNearPlane(const Vec2& viewP, const Vec2& viewPOther)
 {
-    // (see notebook for the math)
-    double opp {camera.viewPlaneDist * tan(angle)};
-    double percentWidth {opp / (camera.viewPlaneWidth / 2.0f)};
-    uint8_t screenX {static_cast<uint8_t>(static_cast<uint8_t>(percentWidth * static_cast<double>(screenWidth/2)) + screenWidth/2)};
-    
-    return screenX;
+    Scalar u {(ProjectionCache::nearPlaneDist - viewP.y) / (viewPOther.y - viewP.y)};
+    return viewP + (viewPOther - viewP) * u;
 }
 
 // this is kind of a silly function, but it must exist when dealing with unsigned numbers...
@@ -132,50 +227,35 @@ int32_t BspRenderer::UnsignedSub(uint32_t n1, uint32_t n2)
     return (static_cast<int32_t>(n1) - static_cast<int32_t>(n2));
 }
 
-bool BspRenderer::ClipAndGetAttributes(bool leftSide, const Line& wallSeg, uint8_t& screenX, double& dist)
+bool BspRenderer::ClipAndGetAttributes(bool leftSide, const Vec2& viewP, const Vec2& viewPOther, uint8_t& screenX, Scalar& dist)
 {
     bool pIsOnScreen {false};
-    Vec2 p {(leftSide ? wallSeg.p1 : wallSeg.p2)};
-    double angle {GetAngleFromCamera(p)};
-    
-    // TODO: is it accurate enough to use camera.leftmostVisibleAngle, vs. the angle
-    // from a line drawn from camera.location through the "middle" of the first pixel on the
-    // left side of the screen?
+    Wide<Scalar>::Type distInside {projections.GetDistInsideFovEdge(leftSide, viewP)};
     
     // if point is in the field of view
-    if (angle >= camera.leftmostVisibleAngle && angle <= camera.rightmostVisibleAngle)
+    if ((distInside >= 0) && (projections.GetDistInsideFovEdge(!leftSide, viewP) >= 0))
     {
         pIsOnScreen = true;
-        screenX = GetScreenXFromAngle(angle);
+        screenX = projections.GetScreenX(viewP);
+        dist = viewP.y;
     }
-    else
+    // perform clipping if necessary - if the point is outside of the field of view on its own
+    // side (to the left for p1, or to the right for p2), the wall is visible if the other end
+    // is inside that edge
+    else if (distInside < 0)
     {
-        // perform clipping if necessary
-        Line ray;
-        if (leftSide) // clip to the left of the camera's field of view
-        {
-            angle = camera.leftmostVisibleAngle;
-            ray = {camera.location, camera.leftmostViewPlaneEnd};
-        }
-        else // clip to the right of the camera's field of view
-        {
-            angle = camera.rightmostVisibleAngle;
-            ray = {camera.location, camera.rightmostViewPlaneEnd};
-        }
-        
-        double dummy;
-        if (GeomUtils::FindRayLineSegIntersection(ray, wallSeg, p, dummy))
+        Wide<Scalar>::Type distInsideOther {projections.GetDistInsideFovEdge(leftSide, viewPOther)};
+        if (distInsideOther > 0)
         {
+            // (the edge is crossed where the distance inside it is 0)
+            Scalar u {distInside / (distInside - distInsideOther)};
             pIsOnScreen = true;
             screenX = (leftSide ? 0 : (screenWidth - 1));
+            dist = viewP.y + (viewPOther.y - viewP.y) * u;
         }
-        // else no clipping was performed - the point is out of the field of
-        // view and the wall does not lie in the path of the edges of the field
-        // of view
     }
-    
-    if (pIsOnScreen)
-        dist = GetPerpendicularDistanceFromCameraByAngle(p, angle);
+    // else the point is out of the field of view on the opposite side (p1 to the right, or p2
+    // to the left), so the whole wall must be too
     
     return pIsOnScreen;
 }
@@ -11,6 +11,8 @@
 
 #include "Renderer.hpp"
 #include "BspTree.hpp"
+#include "CoverageBuffer.hpp"
+#include "ProjectionCache.hpp"
 
 class BspRenderer : public Renderer
 {
@@ -23,17 +25,19 @@ public:
     ~BspRenderer();
 
     void LoadBin(const uint8_t* bytes);
+    void MapBin(const uint8_t* bytes); // (see BspTree::MapBin())
+    // (e.g. for a Raycaster to render the same map)
+    const BspTree& GetBspTree() const { return bspTree; }
     
     void RenderScene() override;
     
 private:
-    static bool RenderWallStatic(const Wall& wall, void* bspRenderer);
-    bool RenderWall(const Wall& wall);
-    double GetPerpendicularDistanceFromCameraByAngle(const Vec2& point, double angleFromCamera);
-    double GetAngleFromCamera(const Vec2& location);
-    uint8_t GetScreenXFromAngle(double angle);
+    bool RenderWall(BspTree::VertexIdx p1Idx, BspTree::VertexIdx p2Idx);
+    bool IsBoxHidden(const Vec2& boxMin, const Vec2& boxMax) const;
+    uint8_t GetScreenXClamped(const Vec2& viewP) const;
+    Vec2 ClipToNearPlane(const Vec2& viewP, const Vec2& viewPOther);
     int32_t UnsignedSub(uint32_t n1, uint32_t n2);
-    bool ClipAndGetAttributes(bool leftSide, const Line& wallSeg, uint8_t& screenX, double& dist);
+    bool ClipAndGetAttributes(bool leftSide, const Vec2& viewP, const Vec2& viewPOther, uint8_t& screenX, Scalar& dist);
 
     BspTree bspTree;
 
@@ -42,6 +46,12 @@ private:
     // for pushing out to the display
     // (a value of 0 means either there is no wall intersection there, or it just hasn't been rendered yet)
     uint8_t* pHeightBuffer;
+
+    // which columns of the height buffer have been filled so far
+    CoverageBuffer coverage;
+
+    // the screen positions of the tree's vertices
+    ProjectionCache projections;
 };
 
 #endif /* BspRenderer_hpp */
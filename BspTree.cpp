@@ -16,6 +16,58 @@
 #include "GeomUtils.hpp"
 #include "Serializer.hpp"
 
+constexpr size_t BspTree::MaxNodes;
+constexpr size_t BspTree::MaxVertices;
+constexpr uint8_t BspTree::MaxDepth;
+constexpr uint32_t BspTree::SerMagic;
+constexpr uint16_t BspTree::SerVersion;
+constexpr uint16_t BspTree::SerFlagNative;
+constexpr uint16_t BspTree::SerFlagCompact;
+constexpr uint32_t BspTree::SerVerticesTag;
+constexpr uint32_t BspTree::SerNodesTag;
+constexpr uint16_t BspTree::SerNullIdx;
+constexpr size_t BspTree::SerHeaderSize;
+constexpr size_t BspTree::SerSectionSize;
+constexpr size_t BspTree::SerVertexSize;
+constexpr size_t BspTree::SerNodeSize;
+constexpr size_t BspTree::UnknownBinSize;
+
+namespace
+{
+    // where the flags are in the header
+    constexpr size_t SerFlagsOffset {6};
+    // where the checksum is in the header (it covers everything else, before and after it)
+    constexpr size_t SerCrcOffset {12};
+    constexpr size_t SerCrcSize {4};
+
+    // what SerFlagNative sections start at a multiple of
+    constexpr size_t SerNativeAlignment {8};
+
+    // how many numbers are read at a time when checking nodes, or copied at a time from
+    // SerFlagNative sections (this much is needed on the stack)
+    constexpr size_t NativeChunkSize {16};
+
+    // the most fractional bits that SerFlagCompact coordinates can have (i.e. those of a Fixed),
+    // and the range of the whole numbers of those units
+    constexpr uint8_t CompactMaxFracBits {16};
+    constexpr int32_t CompactMin {-32768};
+    constexpr int32_t CompactMax {32767};
+
+    // rays are tested against bounding boxes a little bigger than the boxes themselves, so that a
+    // ray that hits a wall right on the edge of its box (e.g. a wall along an axis, whose box has
+    // no width) never misses the box because of rounding
+    constexpr Scalar RayBoxMargin {1.0f / 256.0f};
+
+    // (each node is all 2-byte indices)
+    constexpr uint8_t NodeFields {BspTree::SerNodeSize / 2};
+    constexpr uint16_t NodesPerChunk {NativeChunkSize / NodeFields};
+
+    uint16_t DeSerIdx(const uint8_t* bytes, size_t& offset, bool isNative)
+    {
+        return (isNative ? Serializer::DeSerUint16LE(bytes, offset) : Serializer::DeSerUint16(bytes, offset));
+    }
+}
+
 // a generic error handling function for this module
 // this could be enhanced in the future if useful, but must be done in a cross-platform way
 // (cerr/cout and throw not supported on embedded platform)
@@ -24,148 +76,544 @@
     while (1) {}
 }
 
-BspTree::BspNode::BspNode(const uint8_t* bytes, size_t& offset):
-    wall{Line(bytes, offset)},
-    backNodeIdx{NullNodeIdx},
-    frontNodeIdx{NullNodeIdx}
+BspTree::BspTree():
+    nodes{nullptr},
+    vertices{nullptr},
+    pMappedBytes{nullptr},
+    mappedVerticesOffset{0},
+    mappedNodesOffset{0},
+    mappedIsNative{false},
+    numNodes{0},
+    numVertices{0}
+#ifdef SDLSim
+    , numNodesVisited{0}
+#endif
 {
+    static_assert((NullNodeIdx >= MaxNodes), "NullNodeIdx is not unique");
+    static_assert((static_cast<NodeIdx>(MaxNodes) == MaxNodes), "NodeIdx is too small");
+    static_assert((static_cast<NodeIdx>(SerNullIdx) == NullNodeIdx), "SerNullIdx doesn't map to NullNodeIdx");
+    static_assert((static_cast<VertexIdx>(MaxVertices - 1) == MaxVertices - 1), "VertexIdx is too small");
 }
 
-// this renders *front to back* (closest walls first), and also performs backface culling
-// (walls facing away from the camera are not rendered)
-bool BspTree::BspNode::TraverseRender(BspNode* nodes, const Vec2& cameraLoc, TraversalCbType renderFunc, void* ptr)
+BspTree::~BspTree()
 {
-    bool cont {true};
-    
-    // if the camera is in front of this node's wall
-    if (GeomUtils::GeomUtils::IsPointInFrontOfLine(wall.seg, cameraLoc))
+    Free();
+}
+
+BspTree::BinStatus BspTree::CheckBin(const uint8_t* bytes, size_t size)
+{
+    BinLayout layout;
+    return CheckBin(bytes, size, layout);
+}
+
+void BspTree::LoadBin(const uint8_t* bytes)
+{
+    Free();
+
+    BinLayout layout;
+    if (CheckBin(bytes, UnknownBinSize, layout) != BinStatus::Ok)
+        BspTree::Error();
+
+    // (exactly as much memory as the tree needs is allocated - there is no fixed limit on the
+    // size of a tree, other than what the index types can hold, and how much RAM there is)
+    if (layout.numVertices > 0)
     {
-        // render the nodes in front of this one, then this one, then the ones behind
-        // (front to back)
-        if (cont)
-           if (frontNodeIdx != NullNodeIdx) cont = nodes[frontNodeIdx].TraverseRender(nodes, cameraLoc, renderFunc, ptr);
-        if (cont)
-            cont = renderFunc(wall, ptr);
-        if (cont)
-           if (backNodeIdx != NullNodeIdx) cont = nodes[backNodeIdx].TraverseRender(nodes, cameraLoc, renderFunc, ptr);
+        vertices = static_cast<Vec2*>(malloc(sizeof(Vec2) * layout.numVertices));
+        if (!vertices)
+            BspTree::Error();
     }
-    // ... or in back
-    else
+    if (layout.numNodes > 0)
     {
-        // don't render the current node's wall, since it is not facing the right direction,
-        // but do potentially render its children
-        // since this wall is facing away from the camera, we render the ones in back of it
-        // (closer to the camera) before the ones in front of it (farther from the camera)
+        nodes = static_cast<BspNode*>(malloc(sizeof(BspNode) * layout.numNodes));
+        if (!nodes)
+            BspTree::Error();
+    }
 
-        if (cont)
-            if (backNodeIdx != NullNodeIdx) cont = nodes[backNodeIdx].TraverseRender(nodes, cameraLoc, renderFunc, ptr);
-        if (cont)
-            if (frontNodeIdx != NullNodeIdx) cont = nodes[frontNodeIdx].TraverseRender(nodes, cameraLoc, renderFunc, ptr);
+    if (layout.isCompact)
+    {
+        LoadCompact(bytes, layout);
+        numVertices = layout.numVertices;
+        numNodes = static_cast<NodeIdx>(layout.numNodes);
+        return;
+    }
+    if (layout.isNative)
+    {
+        LoadNativeVertices(bytes, layout);
+        LoadNativeNodes(bytes, layout);
+        numVertices = layout.numVertices;
+        numNodes = static_cast<NodeIdx>(layout.numNodes);
+        return;
     }
-    
-    // TODO: handle if camera is exactly on this node's line
-    // wikipedia: If that polygon lies in the plane containing P, add it to the *list of polygons* at node N.
-    // (I currenly don't have this set up as a list...)
 
-    return cont;
+    for (numVertices = 0; numVertices < layout.numVertices; numVertices++)
+        new(&vertices[numVertices]) Vec2(ReadVertex(bytes, layout.verticesOffset, false, static_cast<VertexIdx>(numVertices)));
+    for (numNodes = 0; numNodes < layout.numNodes; numNodes++)
+        nodes[numNodes] = ReadNode(bytes, layout.nodesOffset, false, numNodes);
 }
 
-BspTree::BspTree():
-    numNodes{0},
-    rootNodeIdx{NullNodeIdx}
+void BspTree::MapBin(const uint8_t* bytes)
 {
-    static_assert((Serializer::Fixed::Unfixed(SerNullNode) > 10000.0f) || (Serializer::Fixed::Unfixed(SerNullNode) < -10000.0f),
-                  "aliasing problem with SerNullNode and a node's (double) coordinate");
-
-    static_assert((NullNodeIdx > MaxNodes), "NullNodeIdx is not unique");
+    Free();
 
-    nodes = static_cast<BspNode*>(malloc(sizeof(BspNode) * MaxNodes));
-    if (!nodes)
+    // (every node is checked here, so that nothing has to be checked while traversing the tree)
+    BinLayout layout;
+    if ((CheckBin(bytes, UnknownBinSize, layout) != BinStatus::Ok) || layout.isCompact)
         BspTree::Error();
+
+    numVertices = layout.numVertices;
+    numNodes = static_cast<NodeIdx>(layout.numNodes);
+    mappedVerticesOffset = layout.verticesOffset;
+    mappedNodesOffset = layout.nodesOffset;
+    mappedIsNative = layout.isNative;
+    pMappedBytes = bytes;
 }
 
-BspTree::~BspTree()
+bool BspTree::CanMapBin(const uint8_t* bytes)
 {
-    delete nodes;
+    size_t offset {SerFlagsOffset};
+    return ((Serializer::DeSerUint16(bytes, offset) & SerFlagCompact) == 0);
 }
 
-void BspTree::LoadBin(const uint8_t* bytes)
+void BspTree::TraverseRender(const Camera& camera, TraversalCbType renderFunc, void* ptr)
+{
+    TraverseRender(camera, [renderFunc, ptr](VertexIdx p1Idx, VertexIdx p2Idx) { return renderFunc(p1Idx, p2Idx, ptr); });
+}
+
+bool BspTree::FindFirstHit(const Line& ray, VertexIdx& p1Idx, VertexIdx& p2Idx, Scalar& t) const
+{
+    bool isHit {false};
+    t = ScalarMax;
+    TraverseRay(ray, ScalarMax, [this, &ray, &isHit, &p1Idx, &p2Idx, &t](VertexIdx wallP1Idx, VertexIdx wallP2Idx)
+    {
+        Vec2 intersection;
+        Scalar hitT, u;
+        if (GeomUtils::FindRayLineSegIntersection(ray, {GetVertex(wallP1Idx), GetVertex(wallP2Idx)}, intersection, hitT, u) &&
+            (hitT < t))
+        {
+            isHit = true;
+            p1Idx = wallP1Idx;
+            p2Idx = wallP2Idx;
+            t = hitT;
+        }
+        return t;
+    });
+    return isHit;
+}
+
+bool BspTree::IsBoxOnRay(const Vec2& boxMin, const Vec2& boxMax, const Vec2& p, const Vec2& d, Scalar tFrom, Scalar tTo)
+{
+    Scalar tEnter {tFrom};
+    Scalar tLeave {tTo};
+    GeomUtils::ClipRayToSlab(p.x, d.x, boxMin.x - RayBoxMargin, boxMax.x + RayBoxMargin, tEnter, tLeave);
+    GeomUtils::ClipRayToSlab(p.y, d.y, boxMin.y - RayBoxMargin, boxMax.y + RayBoxMargin, tEnter, tLeave);
+    return (tEnter <= tLeave);
+}
+
+void BspTree::ClipRayToLine(const Line& line, const Vec2& p, const Vec2& d, Scalar tTo, bool& startInFront, Scalar& tNearEnd, Scalar& tFarStart)
+{
+    // how far the ray's start is inside the side of the line that it is on, and how quickly that
+    // changes along the ray (both scaled by the line's length, as for
+    // GeomUtils::IsPointInFrontOfLine())
+    const Vec2 lineD {line.p2 - line.p1};
+    const Wide<Scalar>::Type cross {(p - line.p1).CrossWide(lineD)};
+    startInFront = (cross < 0);
+    const Wide<Scalar>::Type dist {startInFront ? -cross : cross};
+    const Wide<Scalar>::Type crossD {d.CrossWide(lineD)};
+    const Wide<Scalar>::Type approach {startInFront ? crossD : -crossD};
+
+    // (the margin is scaled by a length at least that of the line, to err on the thick side
+    // without a square root)
+    const Wide<Scalar>::Type margin {Wide<Scalar>::Mul(RayBoxMargin, fabs(lineD.x) + fabs(lineD.y))};
+    tNearEnd = ScalarMax;
+    if (approach > 0)
+    {
+        tFarStart = (dist - margin) / approach;
+        // (the ray doesn't leave the side it starts on before tTo if it doesn't even get to the
+        // line)
+        if (tFarStart <= tTo)
+            tNearEnd = (dist + margin) / approach;
+    }
+    else
+    {
+        // (the ray never gets any closer to the line, so the other side is only reached if the
+        // ray starts on the line)
+        tFarStart = ((dist < margin) ? static_cast<Scalar>(0.0f) : ScalarMax);
+    }
+}
+
+BspTree::BinStatus BspTree::CheckBin(const uint8_t* bytes, size_t size, BinLayout& layout)
 {
-    // important note:
-    // in the original version of this function recursion was used such that each node,
-    // upon creation, would parse its own subtree
-    // because of memory limitations on the embedded hardware, this function now uses
-    // a loop with a stack, rather than recursion
+    if (size < SerHeaderSize)
+        return BinStatus::BadSize;
 
     size_t offset {0};
-    NodeStack ns;
-    bool done {false};
+    if (Serializer::DeSerUint(bytes, offset) != SerMagic)
+        return BinStatus::BadMagic;
+    if (Serializer::DeSerUint16(bytes, offset) != SerVersion)
+        return BinStatus::BadVersion;
+    const uint16_t flags {Serializer::DeSerUint16(bytes, offset)};
+    if (((flags & ~(SerFlagNative | SerFlagCompact)) != 0) || (flags == (SerFlagNative | SerFlagCompact)))
+        return BinStatus::BadFlags;
+    layout.isNative = ((flags & SerFlagNative) != 0);
+    layout.isCompact = ((flags & SerFlagCompact) != 0);
+
+    const uint32_t binSize {Serializer::DeSerUint(bytes, offset)};
+    if ((binSize < SerHeaderSize) || (binSize > size))
+        return BinStatus::BadSize;
+    const uint32_t crc {Serializer::DeSerUint(bytes, offset)};
+    const uint32_t headCrc {Serializer::Crc32(bytes, 0, SerCrcOffset)};
+    const size_t tailOffset {SerCrcOffset + SerCrcSize};
+    if (Serializer::Crc32(bytes, tailOffset, static_cast<size_t>(binSize) - tailOffset, headCrc) != crc)
+        return BinStatus::BadChecksum;
+
+    layout.numVertices = Serializer::DeSerUint16(bytes, offset);
+    layout.numNodes = Serializer::DeSerUint16(bytes, offset);
+    const uint16_t depth {Serializer::DeSerUint16(bytes, offset)};
+    const uint16_t numSections {Serializer::DeSerUint16(bytes, offset)};
+    if ((layout.numVertices > MaxVertices) || (layout.numNodes > MaxNodes) || (depth > MaxDepth))
+        return BinStatus::TooBig;
+    layout.depth = static_cast<uint8_t>(depth);
 
-    ParseAndPush(bytes, offset, ns, rootNodeIdx);
-    
-    while (!done)
+    // (the bounding box is for tools, and isn't needed here)
+    BinStatus status {CheckSections(bytes, static_cast<size_t>(binSize), numSections, layout)};
+    if ((status == BinStatus::Ok) && layout.isCompact)
+        return CheckCompact(bytes, layout);
+    PreorderCheck preorder {layout};
+    uint16_t fields[NativeChunkSize];
+    for (uint16_t first = 0; (first < layout.numNodes) && (status == BinStatus::Ok); first += NodesPerChunk)
     {
-        if (ns.Count() > 0)
+        const uint16_t count {ReadNodeFields(bytes, layout, first, fields)};
+        for (uint16_t i = 0; (i < count) && (status == BinStatus::Ok); i++)
         {
-            NodeStack::NodeItem& ni = ns.Peek();
-
-            if (ni.nodeIdx != NullNodeIdx)
-            {
-                if (ni.numChildrenProcessed == 0)
-                    ParseAndPush(bytes, offset, ns, nodes[ni.nodeIdx].backNodeIdx);
-                else if (ni.numChildrenProcessed == 1)
-                    ParseAndPush(bytes, offset, ns, nodes[ni.nodeIdx].frontNodeIdx);
-                else if (ni.numChildrenProcessed == 2)
-                    PopAndIncParent(ns);
-            }
-            else
-            {
-                PopAndIncParent(ns);
-            }
+            status = CheckNode(layout, first + i, &fields[i * NodeFields]);
+            if (status == BinStatus::Ok)
+                status = preorder.Visit(first + i, &fields[i * NodeFields]);
         }
-        else
+    }
+    if ((status == BinStatus::Ok) && !preorder.IsDone())
+        return BinStatus::BadNode;
+    return status;
+}
+
+// (size is the container's size, which the checksum has already shown to be right)
+BspTree::BinStatus BspTree::CheckSections(const uint8_t* bytes, size_t size, uint16_t numSections, BinLayout& layout)
+{
+    const size_t sectionsOffset {SerHeaderSize + static_cast<size_t>(numSections) * SerSectionSize};
+    if (sectionsOffset > size)
+        return BinStatus::BadSections;
+
+    bool foundVertices {false};
+    bool foundNodes {false};
+    size_t offset {SerHeaderSize};
+    for (uint16_t section = 0; section < numSections; section++)
+    {
+        const uint32_t tag {Serializer::DeSerUint(bytes, offset)};
+        const uint32_t sectionOffset {Serializer::DeSerUint(bytes, offset)};
+        const uint32_t sectionSize {Serializer::DeSerUint(bytes, offset)};
+        if ((sectionOffset < sectionsOffset) || (sectionOffset > size) || (sectionSize > size - sectionOffset) ||
+            (layout.isNative && (sectionOffset % SerNativeAlignment != 0)))
+            return BinStatus::BadSections;
+
+        // (the sizes of compact sections depend on what's in them, so CheckCompact() checks them)
+        if (tag == SerVerticesTag)
         {
-            done = true;
+            if (foundVertices || (!layout.isCompact && (sectionSize != layout.numVertices * SerVertexSize)))
+                return BinStatus::BadSections;
+            foundVertices = true;
+            layout.verticesOffset = static_cast<size_t>(sectionOffset);
+            layout.verticesSize = static_cast<size_t>(sectionSize);
         }
+        else if (tag == SerNodesTag)
+        {
+            if (foundNodes || (!layout.isCompact && (sectionSize != layout.numNodes * SerNodeSize)))
+                return BinStatus::BadSections;
+            foundNodes = true;
+            layout.nodesOffset = static_cast<size_t>(sectionOffset);
+            layout.nodesSize = static_cast<size_t>(sectionSize);
+        }
+    }
+
+    return ((foundVertices && foundNodes) ? BinStatus::Ok : BinStatus::BadSections);
+}
+
+BspTree::BinStatus BspTree::CheckNode(const BinLayout& layout, uint16_t nodeIdx, const uint16_t* fields)
+{
+    // (the third and fourth fields are the back and front children, and the rest are vertices)
+    // a child always comes after its parent, which also means that there can't be any cycles
+    for (uint8_t field = 0; field < NodeFields; field++)
+    {
+        const uint16_t idx {fields[field]};
+        if ((field == 2) || (field == 3))
+        {
+            if ((idx != SerNullIdx) && ((idx <= nodeIdx) || (idx >= layout.numNodes)))
+                return BinStatus::BadNode;
+        }
+        else if (idx >= layout.numVertices)
+        {
+            return BinStatus::BadNode;
+        }
+    }
+    return BinStatus::Ok;
+}
+
+// this decodes both of the sections, which must each hold exactly the vertices and nodes
+BspTree::BinStatus BspTree::CheckCompact(const uint8_t* bytes, const BinLayout& layout)
+{
+    Serializer::VarintStream vertexStream {bytes, layout.verticesOffset, layout.verticesOffset + layout.verticesSize};
+    uint8_t fracBits;
+    if (!vertexStream.ReadByte(fracBits) || (fracBits > CompactMaxFracBits))
+        return BinStatus::BadVertex;
+    int32_t x {0};
+    int32_t y {0};
+    for (size_t vertexIdx = 0; vertexIdx < layout.numVertices; vertexIdx++)
+        if (!ReadCompactVertex(vertexStream, x, y))
+            return BinStatus::BadVertex;
+    if (!vertexStream.IsAtEnd())
+        return BinStatus::BadSections;
+
+    Serializer::VarintStream nodeStream {bytes, layout.nodesOffset, layout.nodesOffset + layout.nodesSize};
+    PreorderCheck preorder {layout};
+    uint16_t fields[NodeFields];
+    for (uint16_t nodeIdx = 0; nodeIdx < layout.numNodes; nodeIdx++)
+    {
+        if (!ReadCompactNode(nodeStream, nodeIdx, fields))
+            return BinStatus::BadNode;
+        BinStatus status {CheckNode(layout, nodeIdx, fields)};
+        if (status == BinStatus::Ok)
+            status = preorder.Visit(nodeIdx, fields);
+        if (status != BinStatus::Ok)
+            return status;
     }
+    if (!preorder.IsDone())
+        return BinStatus::BadNode;
+    return (nodeStream.IsAtEnd() ? BinStatus::Ok : BinStatus::BadSections);
 }
 
-void BspTree::TraverseRender(const Vec2& cameraLoc, TraversalCbType renderFunc, void* ptr)
+BspTree::PreorderCheck::PreorderCheck(const BinLayout& layout):
+    maxDepth{layout.depth},
+    nextIdx{(layout.numNodes > 0) ? static_cast<uint16_t>(0) : SerNullIdx},
+    nextDepth{1},
+    numPending{0}
 {
-    if (rootNodeIdx != NullNodeIdx)
-        nodes[rootNodeIdx].TraverseRender(nodes, cameraLoc, renderFunc, ptr);
 }
 
-BspTree::NodeIdx BspTree::ParseNode(const uint8_t* bytes, size_t& offset)
+// (CheckNode() has already checked the node's indices)
+BspTree::BinStatus BspTree::PreorderCheck::Visit(uint16_t nodeIdx, const uint16_t* fields)
 {
-    NodeIdx nodeIdx {NullNodeIdx};
-    
-    // "peek" at the data to see whether or not there is a node there
-    int32_t identifier {Serializer::PeekInt(bytes, offset)};
-    if (identifier != SerNullNode)
+    // (the root is at depth 1, as the depth is the most walls on any path from it)
+    if ((nodeIdx != nextIdx) || (nextDepth > maxDepth))
+        return BinStatus::BadNode;
+
+    const uint16_t backIdx {fields[2]};
+    const uint16_t frontIdx {fields[3]};
+    if (((backIdx != SerNullIdx) || (frontIdx != SerNullIdx)) && (nextDepth >= maxDepth))
+        return BinStatus::BadNode;
+    if (backIdx != SerNullIdx)
+    {
+        // the back child's subtree comes straight after the node, and then the front child's
+        // (there is room for this, as each pending child's parent is on the path to the back
+        // child, which is at most maxDepth long)
+        if (backIdx != nodeIdx + 1)
+            return BinStatus::BadNode;
+        if (frontIdx != SerNullIdx)
+            pending[numPending++] = {frontIdx, static_cast<uint8_t>(nextDepth + 1)};
+        nextIdx = backIdx;
+        nextDepth++;
+    }
+    else if (frontIdx != SerNullIdx)
+    {
+        if (frontIdx != nodeIdx + 1)
+            return BinStatus::BadNode;
+        nextIdx = frontIdx;
+        nextDepth++;
+    }
+    else if (numPending > 0)
     {
-        new(&nodes[numNodes]) BspNode(bytes, offset);
+        const Pending& next {pending[--numPending]};
+        nextIdx = next.nodeIdx;
+        nextDepth = next.depth;
+    }
+    else
+    {
+        nextIdx = SerNullIdx;
+    }
+    return BinStatus::Ok;
+}
 
-        nodeIdx = numNodes;
-        numNodes++;
+uint16_t BspTree::ReadNodeFields(const uint8_t* bytes, const BinLayout& layout, uint16_t first, uint16_t* fields)
+{
+    const uint16_t count {static_cast<uint16_t>((layout.numNodes - first < NodesPerChunk) ? layout.numNodes - first : NodesPerChunk)};
+    size_t offset {layout.nodesOffset + first * SerNodeSize};
+    if (layout.isNative)
+    {
+        Serializer::DeSerUint16sLE(bytes, offset, count * NodeFields, fields);
     }
     else
     {
-        offset += 4; // make the "peek" official
+        for (uint16_t i = 0; i < count * NodeFields; i++)
+            fields[i] = Serializer::DeSerUint16(bytes, offset);
+    }
+    return count;
+}
+
+// (a null child, SerNullIdx, becomes NullNodeIdx when it is cut down to the size of a node index)
+BspTree::BspNode BspTree::ReadNode(const uint8_t* bytes, size_t nodesOffset, bool isNative, NodeIdx idx)
+{
+    size_t offset {nodesOffset + idx * SerNodeSize};
+    BspNode node;
+    node.p1Idx = static_cast<VertexIdx>(DeSerIdx(bytes, offset, isNative));
+    node.p2Idx = static_cast<VertexIdx>(DeSerIdx(bytes, offset, isNative));
+    node.backNodeIdx = static_cast<NodeIdx>(DeSerIdx(bytes, offset, isNative));
+    node.frontNodeIdx = static_cast<NodeIdx>(DeSerIdx(bytes, offset, isNative));
+    node.minXIdx = static_cast<VertexIdx>(DeSerIdx(bytes, offset, isNative));
+    node.minYIdx = static_cast<VertexIdx>(DeSerIdx(bytes, offset, isNative));
+    node.maxXIdx = static_cast<VertexIdx>(DeSerIdx(bytes, offset, isNative));
+    node.maxYIdx = static_cast<VertexIdx>(DeSerIdx(bytes, offset, isNative));
+    return node;
+}
+
+Vec2 BspTree::ReadVertex(const uint8_t* bytes, size_t verticesOffset, bool isNative, VertexIdx idx)
+{
+    size_t offset {verticesOffset + idx * SerVertexSize};
+    if (isNative)
+    {
+        Scalar x {static_cast<Scalar>(Serializer::DeSerFixedLE(bytes, offset))};
+        Scalar y {static_cast<Scalar>(Serializer::DeSerFixedLE(bytes, offset))};
+        return {x, y};
+    }
+    Scalar x {static_cast<Scalar>(Serializer::DeSerFixed(bytes, offset))};
+    Scalar y {static_cast<Scalar>(Serializer::DeSerFixed(bytes, offset))};
+    return {x, y};
+}
+
+// the coordinates are copied a chunk at a time, and then converted in a tight loop that the
+// compiler can vectorize
+void BspTree::LoadNativeVertices(const uint8_t* bytes, const BinLayout& layout)
+{
+    int32_t encodings[NativeChunkSize];
+    for (uint16_t first = 0; first < layout.numVertices; first += NativeChunkSize / 2)
+    {
+        const uint16_t count {static_cast<uint16_t>((static_cast<size_t>(layout.numVertices - first) < NativeChunkSize / 2) ?
+                                                    layout.numVertices - first : NativeChunkSize / 2)};
+        Serializer::DeSerIntsLE(bytes, layout.verticesOffset + first * SerVertexSize, count * 2, encodings);
+        for (uint16_t i = 0; i < count; i++)
+        {
+            new(&vertices[first + i]) Vec2(static_cast<Scalar>(Fixed::FromEncoding(encodings[i * 2])),
+                                           static_cast<Scalar>(Fixed::FromEncoding(encodings[i * 2 + 1])));
+        }
+    }
+}
+
+void BspTree::LoadNativeNodes(const uint8_t* bytes, const BinLayout& layout)
+{
+    // with 2-byte indices, the nodes are already laid out just as they are in RAM
+    if ((sizeof(BspNode) == SerNodeSize) && Serializer::IsHostLittleEndian)
+    {
+        Serializer::DeSerUint16sLE(bytes, layout.nodesOffset, layout.numNodes * NodeFields, reinterpret_cast<uint16_t*>(nodes));
+        return;
+    }
+
+    uint16_t fields[NativeChunkSize];
+    for (uint16_t first = 0; first < layout.numNodes; first += NodesPerChunk)
+    {
+        const uint16_t count {ReadNodeFields(bytes, layout, first, fields)};
+        for (uint16_t i = 0; i < count; i++)
+            nodes[first + i] = GetNodeFromFields(&fields[i * NodeFields]);
+    }
+}
+
+// (x and y are the previous vertex's coordinates, which this vertex's are relative to)
+bool BspTree::ReadCompactVertex(Serializer::VarintStream& stream, int32_t& x, int32_t& y)
+{
+    int32_t dx;
+    int32_t dy;
+    if (!stream.ReadSigned(dx) || !stream.ReadSigned(dy))
+        return false;
+    // (checked before adding, so that nothing can overflow)
+    if ((dx < CompactMin - CompactMax) || (dx > CompactMax - CompactMin) ||
+        (dy < CompactMin - CompactMax) || (dy > CompactMax - CompactMin))
+        return false;
+    x += dx;
+    y += dy;
+    return ((x >= CompactMin) && (x <= CompactMax) && (y >= CompactMin) && (y <= CompactMax));
+}
+
+// this gives the same fields as a node in a fixed-size section, for CheckNode()
+bool BspTree::ReadCompactNode(Serializer::VarintStream& stream, uint16_t nodeIdx, uint16_t* fields)
+{
+    // (p1, p2, the children, then the 4 vertices of the bounding box)
+    // (the children are a front offset and a back bit, so they can take one more bit than an index)
+    uint32_t values[NodeFields - 1];
+    for (uint8_t valueIdx = 0; valueIdx < NodeFields - 1; valueIdx++)
+    {
+        const uint32_t limit {(valueIdx == 2) ? (2u * SerNullIdx) : static_cast<uint32_t>(SerNullIdx)};
+        if (!stream.Read(values[valueIdx]) || (values[valueIdx] >= limit))
+            return false;
     }
 
-    return nodeIdx;
+    const uint32_t frontOffset {values[2] >> 1};
+    const uint32_t frontIdx {nodeIdx + frontOffset};
+    if (frontIdx >= SerNullIdx)
+        return false;
+    fields[0] = static_cast<uint16_t>(values[0]);
+    fields[1] = static_cast<uint16_t>(values[1]);
+    fields[2] = (((values[2] & 1) != 0) ? static_cast<uint16_t>(nodeIdx + 1) : SerNullIdx);
+    fields[3] = ((frontOffset != 0) ? static_cast<uint16_t>(frontIdx) : SerNullIdx);
+    for (uint8_t field = 4; field < NodeFields; field++)
+        fields[field] = static_cast<uint16_t>(values[field - 1]);
+    return true;
+}
+
+void BspTree::LoadCompact(const uint8_t* bytes, const BinLayout& layout)
+{
+    // (everything has already been checked)
+    Serializer::VarintStream vertexStream {bytes, layout.verticesOffset, layout.verticesOffset + layout.verticesSize};
+    uint8_t fracBits;
+    vertexStream.ReadByte(fracBits);
+    const int32_t scale {static_cast<int32_t>(1) << (CompactMaxFracBits - fracBits)};
+    int32_t x {0};
+    int32_t y {0};
+    for (uint16_t i = 0; i < layout.numVertices; i++)
+    {
+        ReadCompactVertex(vertexStream, x, y);
+        new(&vertices[i]) Vec2(static_cast<Scalar>(Fixed::FromEncoding(x * scale)),
+                               static_cast<Scalar>(Fixed::FromEncoding(y * scale)));
+    }
+
+    Serializer::VarintStream nodeStream {bytes, layout.nodesOffset, layout.nodesOffset + layout.nodesSize};
+    uint16_t fields[NodeFields];
+    for (uint16_t i = 0; i < layout.numNodes; i++)
+    {
+        ReadCompactNode(nodeStream, i, fields);
+        nodes[i] = GetNodeFromFields(fields);
+    }
 }
 
-void BspTree::ParseAndPush(const uint8_t *bytes, size_t &offset, BspTree::NodeStack &ns, NodeIdx& nodeIdx)
+// (a null child, SerNullIdx, becomes NullNodeIdx when it is cut down to the size of a node index)
+BspTree::BspNode BspTree::GetNodeFromFields(const uint16_t* fields)
 {
-    nodeIdx = ParseNode(bytes, offset);
-    ns.Push({nodeIdx, 0});
+    BspNode node;
+    node.p1Idx = static_cast<VertexIdx>(fields[0]);
+    node.p2Idx = static_cast<VertexIdx>(fields[1]);
+    node.backNodeIdx = static_cast<NodeIdx>(fields[2]);
+    node.frontNodeIdx = static_cast<NodeIdx>(fields[3]);
+    node.minXIdx = static_cast<VertexIdx>(fields[4]);
+    node.minYIdx = static_cast<VertexIdx>(fields[5]);
+    node.maxXIdx = static_cast<VertexIdx>(fields[6]);
+    node.maxYIdx = static_cast<VertexIdx>(fields[7]);
+    return node;
 }
 
-void BspTree::PopAndIncParent(NodeStack& ns)
+void BspTree::Free()
 {
-    ns.Pop();
-    if (ns.Count() > 0)
-        ns.Peek().numChildrenProcessed++;
+    free(nodes);
+    free(vertices);
+    nodes = nullptr;
+    vertices = nullptr;
+    pMappedBytes = nullptr;
+    mappedVerticesOffset = 0;
+    mappedNodesOffset = 0;
+    mappedIsNative = false;
+    numNodes = 0;
+    numVertices = 0;
 }
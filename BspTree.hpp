@@ -9,120 +9,548 @@
 #ifndef BspTree_hpp
 #define BspTree_hpp
 
+#include <stddef.h>
 #include <stdint.h>
+#include "Camera.hpp"
+#include "GeomUtils.hpp"
+#include "Serializer.hpp"
 #include "Vec2.hpp"
-#include "Wall.hpp"
 
 // this class represents a binary space partitioning tree, and is a much-scaled-back version of the class
 // of the same name in the walls3d program
 // it supports only loading a pre-built tree from memory (and does not support building the tree itself)
 // a number of steps have been taken to reduce the RAM footprint of this class (and subclasses) as much
 // as possible, due to very-tight memory constraints on the embedded hardware
+//
+// walls don't store their own end points - all of the tree's vertices are kept in one table, and
+// each wall refers to its two vertices by index, so vertices shared by walls (e.g. the corners of
+// a room) are only stored once
+//
+// a tree can either be copied into RAM (LoadBin()), or used in place (MapBin()), where it is read
+// straight out of the serialized bytes while it is traversed - that takes no RAM at all for the
+// tree (on the embedded hardware, the bytes are in flash), at the cost of slower traversal
+//
+// the size of the node and vertex indices, and so how big a tree can be, are chosen at compile
+// time (see LargeBspTrees below) - the embedded hardware needs the smallest ones possible, but a
+// PC can load trees with thousands of walls (e.g. for stress testing)
+//
+// serialized format (all numbers are big-endian, and coordinates are 16.16 fixed point - see
+// Fixed.hpp):
+//   header:   magic (4 bytes, SerMagic), format version (2 bytes, SerVersion), flags (2 bytes -
+//             for optional layouts, e.g. SerFlagNative - a loader rejects any that it doesn't
+//             know), size of the whole container (4 bytes), CRC-32 of the whole container
+//             apart from this field (4 bytes), number of vertices (2 bytes), number of nodes
+//             (2 bytes), depth, i.e. the most walls on any path from the root (2 bytes), number of
+//             sections (2 bytes), bounding box of all of the walls as min x, min y, max x, max y
+//             (4 bytes each)
+//   sections: a table of tag, offset from the start of the container, and size (4 bytes each),
+//             followed by the sections themselves - the vertices (SerVerticesTag) and nodes
+//             (SerNodesTag) must be there, and any other sections are skipped (so tools can add
+//             extra data without breaking the loader)
+//   vertices: x, y (4 bytes each)
+//   nodes:    p1's vertex index, p2's vertex index, back node index, front node index, then the
+//             indices of the vertices with the lowest x, lowest y, highest x and highest y in the
+//             node's subtree (i.e. its bounding box) (2 bytes each)
+//             - the root is node 0, nodes are in preorder (so children always come after their
+//             parents), and a missing child is SerNullIdx
+//             (all nodes are the same size, so any node can be found without reading the others)
+// with SerFlagNative, the numbers in the sections (but not the header or section table) are
+// little-endian instead, and each section starts at a multiple of 8 bytes, so that a PC (or the
+// AVR, which is also little-endian) can copy whole sections rather than read a byte at a time
+// with SerFlagCompact, the sections are much smaller (for fitting more maps in flash), but the
+// vertices and nodes have to be read in order, so such a tree can only be loaded (not mapped):
+//   vertices: the number of fractional bits of the coordinates (1 byte), then each vertex's x
+//             and y as whole numbers of those units, which must fit in 16 bits, as the (signed)
+//             difference from the previous vertex's (or from 0, for the first vertex)
+//   nodes:    p1's vertex index, p2's vertex index, the children (the front child's index minus
+//             this node's, or 0 if there's no front child, times 2, plus 1 if there is a back
+//             child - which is always the next node), then the bounding box's 4 vertex indices
+//   (all of these numbers are varints - see Serializer::VarintStream)
+// everything is checked (see CheckBin()) before anything is allocated, so a corrupt or
+// mismatched tree is caught up front rather than partway through loading it
+// uncomment this (or define it as a compiler flag) to use 16-bit node and vertex indices, for
+// trees of up to 65535 nodes and vertices - the CMake build does this for the floating-point
+// (i.e. PC) variant
+//#define LargeBspTrees
+
+// the limits on the trees that a BspTree can hold, which follow from its index types (these are
+// also the limits that offline tools should check trees against)
+// the maximum depth is the most walls on any path from the root, and is the size of the stack
+// used by BspTree::TraverseRender()
+template <typename NodeIdxType, typename VertexIdxType, size_t maxNodes, size_t maxVertices, uint8_t maxDepth>
+class BspTreeLimits
+{
+public:
+    BspTreeLimits() = delete;
+    ~BspTreeLimits() = delete;
+
+    using NodeIdx = NodeIdxType;
+    using VertexIdx = VertexIdxType;
+
+    static constexpr size_t MaxNodes {maxNodes};
+    static constexpr size_t MaxVertices {maxVertices};
+    static constexpr uint8_t MaxDepth {maxDepth};
+};
+
+template <typename NodeIdxType, typename VertexIdxType, size_t maxNodes, size_t maxVertices, uint8_t maxDepth>
+constexpr size_t BspTreeLimits<NodeIdxType, VertexIdxType, maxNodes, maxVertices, maxDepth>::MaxNodes;
+template <typename NodeIdxType, typename VertexIdxType, size_t maxNodes, size_t maxVertices, uint8_t maxDepth>
+constexpr size_t BspTreeLimits<NodeIdxType, VertexIdxType, maxNodes, maxVertices, maxDepth>::MaxVertices;
+template <typename NodeIdxType, typename VertexIdxType, size_t maxNodes, size_t maxVertices, uint8_t maxDepth>
+constexpr uint8_t BspTreeLimits<NodeIdxType, VertexIdxType, maxNodes, maxVertices, maxDepth>::MaxDepth;
+
+// 1-byte indices, and a stack small enough to leave room for everything else in the Arduino Uno's
+// 2 KB of RAM (the largest node index is reserved for "no node")
+using SmallBspTreeLimits = BspTreeLimits<uint8_t, uint8_t, 255, 256, 13>;
+// limited only by the 2-byte counts and indices in the serialized format
+using LargeBspTreeLimits = BspTreeLimits<uint16_t, uint16_t, 0xFFFF, 0xFFFF, 255>;
+
 class BspTree
 {
 public:
-    using TraversalCbType = bool (*)(const Wall&, void* ptr);
+#ifdef LargeBspTrees
+    using Limits = LargeBspTreeLimits;
+#else
+    using Limits = SmallBspTreeLimits;
+#endif
+
+    using VertexIdx = Limits::VertexIdx;
+
+    // p1 and p2 are the vertex indices of a wall's end points (see GetVertex())
+    using TraversalCbType = bool (*)(VertexIdx p1, VertexIdx p2, void* ptr);
+
+    // limits on the trees that can be loaded
+    static constexpr size_t MaxNodes {Limits::MaxNodes};
+    static constexpr size_t MaxVertices {Limits::MaxVertices};
+    static constexpr uint8_t MaxDepth {Limits::MaxDepth};
+
+    static constexpr uint32_t SerMagic {0x4253504D}; // "BSPM"
+    static constexpr uint16_t SerVersion {1};
+    static constexpr uint16_t SerFlagNative {0x0001}; // (see above)
+    static constexpr uint16_t SerFlagCompact {0x0002}; // (see above - the two can't be combined)
+    static constexpr uint32_t SerVerticesTag {0x56455254}; // "VERT"
+    static constexpr uint32_t SerNodesTag {0x4E4F4445}; // "NODE"
+    static constexpr uint16_t SerNullIdx {0xFFFF};
+    static constexpr size_t SerHeaderSize {40};
+    static constexpr size_t SerSectionSize {12}; // (of each entry in the section table)
+    static constexpr size_t SerVertexSize {8};
+    static constexpr size_t SerNodeSize {16};
+
+    // what CheckBin() found wrong with a serialized tree
+    enum class BinStatus : uint8_t
+    {
+        Ok,
+        BadMagic,
+        BadVersion,
+        BadFlags,    // layouts that this build doesn't know
+        BadSize,     // the container is bigger than the data that was given, or too small for its contents
+        BadChecksum,
+        TooBig,      // more nodes, vertices or depth than this build can handle
+        BadSections, // vertices or nodes missing, repeated, outside the container or the wrong size
+        BadNode,     // a node refers to a vertex or node that doesn't exist, isn't in preorder, or is
+                     // deeper than the depth in the header
+        BadVertex    // a compact vertex is outside the range of 16 bits
+    };
+    // (for bytes whose size isn't known, e.g. an array in PROGMEM - the size in the header is
+    // trusted then)
+    static constexpr size_t UnknownBinSize {static_cast<size_t>(-1)};
 
 private:
-    using NodeIdx = uint8_t;
-    static constexpr NodeIdx NullNodeIdx {0xFF};
+    using NodeIdx = Limits::NodeIdx;
+    static constexpr NodeIdx NullNodeIdx {static_cast<NodeIdx>(~0u)};
     [[noreturn]] static void Error();
 
     // this node class is the most optimized in terms of RAM footprint
     // (as it has the most instantiations)
+    // (the members are in the same order as in the serialized format, so that with 2-byte indices
+    // a little-endian machine can copy SerFlagNative nodes straight in)
     class BspNode
     {
     public:
-        BspNode(const uint8_t* bytes, size_t& offset);
-        ~BspNode() = default;
-        
-        bool TraverseRender(BspNode* nodes, const Vec2& cameraLoc, TraversalCbType renderFunc, void* ptr);
+        // the wall's end points (4 bytes each as fixed point, or 8-16 bytes as floating point,
+        // if they were stored here rather than in the vertex table)
+        VertexIdx p1Idx;
+        VertexIdx p2Idx;
 
         // while the original walls3d version of this class uses pointers here (like a typical
         // tree implementation would), we are instead using 1-byte indices, rather than 2-byte pointers
         // on the embedded hardware, in order to make this class as compact as possible
-        // (requires that we have less than 255 nodes total)
+        // (requires that we have less than 255 nodes total, unless LargeBspTrees is defined)
         NodeIdx backNodeIdx;
         NodeIdx frontNodeIdx;
 
-    private:
-        Wall wall;
+        // the bounding box of this node's wall and all of the walls below it, as the vertices
+        // with the lowest x, lowest y, highest x and highest y - so whole subtrees which can't be
+        // seen can be skipped (this is also much smaller than 4 coordinates of its own)
+        VertexIdx minXIdx;
+        VertexIdx minYIdx;
+        VertexIdx maxXIdx;
+        VertexIdx maxYIdx;
     };
-    
-    // a specialized helper class used for loading a tree from a file without
-    // using recursion
-    // (error handling is minimal/non-existent - it is assumed that this is used
-    // properly)
+
+    // a specialized helper class used for traversing the tree without using recursion - each
+    // item is a node whose near side (the side the camera is on) is being traversed, and
+    // whose wall and far side are still to come
+    // (the stack is sized for the deepest tree that LoadBin() accepts - CheckBin() makes sure
+    // that no node is deeper than the serialized tree's header says, which is at most MaxDepth)
+    typedef struct
+    {
+        NodeIdx nodeIdx;
+        bool cameraInFront;
+    } NodeItem;
+
+    // (for a ray, a node's far side is only walked over the part of the ray that can reach it)
+    typedef struct
+    {
+        NodeIdx nodeIdx;
+        Scalar tFrom;
+        Scalar tTo;
+        bool startInFront;
+    } RayNodeItem;
+
+    template <class Item>
     class NodeStack
     {
     public:
-        typedef struct
-        {
-            NodeIdx nodeIdx;
-            uint8_t numChildrenProcessed; // 0, 1, or 2 (only)
-        } NodeItem;
-
         NodeStack():
             count{0}
         {}
-        size_t Count() { return count; }
-        void Push(NodeItem&& ni)
+        bool IsEmpty() const { return (count == 0); }
+        void Push(Item&& item)
         {
             if (count >= MaxDepth)
                 BspTree::Error();
 
-            data[count++] = ni;
-        }
-        NodeItem& Peek()
-        {
-            if (count == 0)
-                BspTree::Error();
-                
-            return data[count - 1];
+            data[count++] = item;
         }
-        void Pop()
+        Item Pop()
         {
             if (count == 0)
                 BspTree::Error();
-                
-            count--;
+
+            return data[--count];
         }
-        
+
     private:
-        static constexpr uint8_t MaxDepth {14};
-        
         uint8_t count;
-        NodeItem data[MaxDepth];
+        Item data[MaxDepth];
     };
 
 public:
     BspTree();
     ~BspTree();
 
+    // checks everything about a serialized tree that LoadBin() and MapBin() rely on, without
+    // allocating anything (those call Error() for a tree that fails this, but a caller that can
+    // report errors can call this first)
+    static BinStatus CheckBin(const uint8_t* bytes, size_t size = UnknownBinSize);
+
+    // copies a serialized tree into RAM
     void LoadBin(const uint8_t* bytes);
-    void TraverseRender(const Vec2& cameraLoc, TraversalCbType renderFunc, void* ptr);
-    
+    // whether MapBin() can use a serialized tree (compact ones can only be loaded)
+    static bool CanMapBin(const uint8_t* bytes);
+    // uses a serialized tree where it is (it is checked here, but not copied), so the bytes must
+    // be kept as they are for as long as the tree is used (e.g. PROGMEM, or a const array or
+    // memory-mapped file on a PC)
+    void MapBin(const uint8_t* bytes);
+
+    // renders the tree's walls front to back - visitor(p1Idx, p2Idx) is called for each wall
+    // that faces the camera (and might be in its field of view), and returns false to stop the
+    // traversal (e.g. once the screen is full)
+    // isBoxHidden(boxMin, boxMax) is called for subtrees in the field of view, and returns true
+    // if nothing inside the box could be seen anyway (e.g. everywhere it would be on the screen
+    // has already been drawn), to skip the subtree
+    // these are templates, rather than taking function pointers, so that the callbacks can be
+    // inlined into the traversal loop
+    // (the return type only makes sure that this isn't picked for the function pointer version)
+    template <class Visitor, class OcclusionTest>
+    auto TraverseRender(const Camera& camera, Visitor&& visitor, OcclusionTest&& isBoxHidden)
+        -> decltype(isBoxHidden(Vec2(), Vec2()), void());
+    template <class Visitor>
+    void TraverseRender(const Camera& camera, Visitor&& visitor)
+    {
+        TraverseRender(camera, visitor, [](const Vec2&, const Vec2&) { return false; });
+    }
+    // (the same, for a plain function - this can't be inlined)
+    void TraverseRender(const Camera& camera, TraversalCbType renderFunc, void* ptr);
+
+    // walks the walls that a ray might hit, nearest first - visitor(p1Idx, p2Idx) is called for
+    // each wall (whichever way it faces) on the sides of the nodes' lines that the ray crosses,
+    // taking the side that the ray starts on first, and returns how far along the ray (as a
+    // multiple of its length, as for GeomUtils::FindRayLineSegIntersection()) anything is still
+    // of interest - the far side of a node is skipped if the ray only gets there beyond that, so
+    // returning the closest hit so far soon ends the walk (and returning a negative number stops
+    // it at once)
+    template <class Visitor>
+    void TraverseRay(const Line& ray, Scalar maxT, Visitor&& visitor) const
+    {
+        if (pMappedBytes)
+            TraverseRay<true>(ray, maxT, visitor);
+        else
+            TraverseRay<false>(ray, maxT, visitor);
+    }
+    // the first wall that the ray hits (false if none), and how far along the ray the hit is
+    bool FindFirstHit(const Line& ray, VertexIdx& p1Idx, VertexIdx& p2Idx, Scalar& t) const;
+
+    size_t GetNumNodes() const { return numNodes; }
+    size_t GetNumVertices() const { return numVertices; }
+    Vec2 GetVertex(VertexIdx idx) const { return (pMappedBytes ? ReadMappedVertex(idx) : vertices[idx]); }
+
+#ifdef SDLSim
+    // in the last traversal (including those whose subtrees were skipped)
+    uint16_t GetNumNodesVisited() const { return numNodesVisited; }
+#endif
+
 private:
-    NodeIdx ParseNode(const uint8_t* bytes, size_t& offset);
-    
-    // very-specially-purposed helper functions for otherwise-duplicated code in loading tree from file
-    void ParseAndPush(const uint8_t* bytes, size_t& offset, NodeStack& ns, NodeIdx& nodeIdx);
-    void PopAndIncParent(NodeStack& ns);
-    
+    // (isMapped is a template parameter so that whether the tree is used in place is only
+    // checked once per traversal, rather than for every node and vertex that is read)
+    template <bool isMapped, class Visitor, class OcclusionTest>
+    void Traverse(const Camera& camera, Visitor& visitor, OcclusionTest& isBoxHidden);
+
+    template <bool isMapped, class Visitor>
+    void TraverseRay(const Line& ray, Scalar maxT, Visitor& visitor) const;
+    // whether a ray (starting at p, in direction d) is in the box anywhere from tFrom to tTo
+    static bool IsBoxOnRay(const Vec2& boxMin, const Vec2& boxMax, const Vec2& p, const Vec2& d, Scalar tFrom, Scalar tTo);
+    // which side of a node's line a ray starts on, how far along the ray it is before the ray gets
+    // to the line (so that the other side can be reached), and how far before it is past the line
+    // (so that the side it starts on can't be) - ScalarMax if never, or if that is only after
+    // the ray gets to the line beyond tTo
+    static void ClipRayToLine(const Line& line, const Vec2& p, const Vec2& d, Scalar tTo, bool& startInFront, Scalar& tNearEnd, Scalar& tFarStart);
+
+    // where the parts of a serialized tree are, as found by CheckBin()
+    class BinLayout
+    {
+    public:
+        uint16_t numVertices;
+        uint16_t numNodes;
+        size_t verticesOffset;
+        size_t nodesOffset;
+        size_t verticesSize; // (in bytes)
+        size_t nodesSize;
+        bool isNative; // (see SerFlagNative)
+        bool isCompact; // (see SerFlagCompact)
+        uint8_t depth; // (from the header)
+    };
+
+    // follows a serialized tree's nodes in order, to check that they are in preorder (with each
+    // node's back child first), so that every node but the root has exactly one parent, and
+    // that no node is deeper than the depth in the header, which the traversal stacks rely on
+    // (the front children still to come are kept on a stack, as in the traversals, so this needs
+    // no more room than they do, and nothing has to be allocated)
+    class PreorderCheck
+    {
+    public:
+        explicit PreorderCheck(const BinLayout& layout);
+        BinStatus Visit(uint16_t nodeIdx, const uint16_t* fields);
+        // (whether every node that was referred to has been visited)
+        bool IsDone() const { return ((nextIdx == SerNullIdx) && (numPending == 0)); }
+
+    private:
+        class Pending
+        {
+        public:
+            uint16_t nodeIdx;
+            uint8_t depth;
+        };
+
+        uint8_t maxDepth;
+        uint16_t nextIdx; // (SerNullIdx once the whole tree has been visited)
+        uint8_t nextDepth;
+        uint8_t numPending;
+        Pending pending[MaxDepth];
+    };
+
+    static BinStatus CheckBin(const uint8_t* bytes, size_t size, BinLayout& layout);
+    static BinStatus CheckSections(const uint8_t* bytes, size_t size, uint16_t numSections, BinLayout& layout);
+    static BinStatus CheckNode(const BinLayout& layout, uint16_t nodeIdx, const uint16_t* fields);
+    static BinStatus CheckCompact(const uint8_t* bytes, const BinLayout& layout);
+    // reads the indices of as many nodes as fit in a chunk, starting from first (returns how many)
+    static uint16_t ReadNodeFields(const uint8_t* bytes, const BinLayout& layout, uint16_t first, uint16_t* fields);
+    // (these don't check anything, as CheckBin() already has)
+    static BspNode ReadNode(const uint8_t* bytes, size_t nodesOffset, bool isNative, NodeIdx idx);
+    static Vec2 ReadVertex(const uint8_t* bytes, size_t verticesOffset, bool isNative, VertexIdx idx);
+    static BspNode GetNodeFromFields(const uint16_t* fields);
+    // (these copy SerFlagNative sections in bulk)
+    void LoadNativeVertices(const uint8_t* bytes, const BinLayout& layout);
+    void LoadNativeNodes(const uint8_t* bytes, const BinLayout& layout);
+    // (these decode SerFlagCompact sections - the reads return false for bad data, but LoadCompact()
+    // doesn't check them, as CheckCompact() already has)
+    static bool ReadCompactVertex(Serializer::VarintStream& stream, int32_t& x, int32_t& y);
+    static bool ReadCompactNode(Serializer::VarintStream& stream, uint16_t nodeIdx, uint16_t* fields);
+    void LoadCompact(const uint8_t* bytes, const BinLayout& layout);
+    void Free();
+
+    template <bool isMapped>
+    BspNode GetNode(NodeIdx idx) const { return (isMapped ? ReadMappedNode(idx) : nodes[idx]); }
+    template <bool isMapped>
+    Vec2 GetVertex(VertexIdx idx) const { return (isMapped ? ReadMappedVertex(idx) : vertices[idx]); }
+    BspNode ReadMappedNode(NodeIdx idx) const { return ReadNode(pMappedBytes, mappedNodesOffset, mappedIsNative, idx); }
+    Vec2 ReadMappedVertex(VertexIdx idx) const { return ReadVertex(pMappedBytes, mappedVerticesOffset, mappedIsNative, idx); }
+
     // all nodes are stored here as a contiguous array in heap memory (vs. the typical implementation of
     // a tree in which the nodes would be allocated individually and scattered throughout memory)
     // this is done to reduce "wasted" memory on the embedded hardware by having a single heap allocation
     // rather than one per node - each allocation was found to have an overhead of 2 bytes
+    // (the same goes for the vertices)
     BspNode* nodes;
-    uint8_t numNodes;
-    NodeIdx rootNodeIdx; // should always be either 0 or BspNode::NullNodeIdx
-    
-    static constexpr size_t MaxNodes {50};
-        
-    // this value represents a "null node" in the serialized data, and is chosen to
-    // not conflict with any reasonable value for what is otherwise a fixed-point
-    // representation of an x coordinate in the case of a "real" node
-    static constexpr int32_t SerNullNode {static_cast<int32_t>(0x7FFFFFFF)};
+    Vec2* vertices;
+    // (only for a tree used in place, when nodes and vertices are null)
+    const uint8_t* pMappedBytes;
+    size_t mappedVerticesOffset;
+    size_t mappedNodesOffset;
+    bool mappedIsNative;
+    NodeIdx numNodes;
+    uint16_t numVertices;
+
+#ifdef SDLSim
+    // (mutable, as walking a ray doesn't change the tree)
+    mutable uint16_t numNodesVisited;
+#endif
 };
 
+template <class Visitor, class OcclusionTest>
+auto BspTree::TraverseRender(const Camera& camera, Visitor&& visitor, OcclusionTest&& isBoxHidden)
+    -> decltype(isBoxHidden(Vec2(), Vec2()), void())
+{
+    if (pMappedBytes)
+        Traverse<true>(camera, visitor, isBoxHidden);
+    else
+        Traverse<false>(camera, visitor, isBoxHidden);
+}
+
+// this renders *front to back* (closest walls first), and also performs backface culling
+// (walls facing away from the camera are not rendered) and frustum culling of whole subtrees
+// (those whose bounding boxes are entirely behind the camera or outside its field of view are
+// skipped, so a big map costs about as much as the part of it that is on screen), as well as
+// occlusion culling of subtrees, as decided by the caller
+// for each node, the side of its wall that the camera is on is traversed first, then the wall
+// itself (if the camera is in front of it), then the other side - this is done with a loop and
+// an explicit stack, rather than recursion, so that the stack space needed is small and known
+// in advance, and there are no calls per node
+template <bool isMapped, class Visitor, class OcclusionTest>
+void BspTree::Traverse(const Camera& camera, Visitor& visitor, OcclusionTest& isBoxHidden)
+{
+    NodeStack<NodeItem> ns;
+#ifdef SDLSim
+    numNodesVisited = 0;
+#endif
+
+    // (the root is always the first node)
+    NodeIdx nodeIdx {(numNodes > 0) ? static_cast<NodeIdx>(0) : NullNodeIdx};
+
+    while (true)
+    {
+        // go down the near side of each node as far as possible, remembering the nodes on the way
+        while (nodeIdx != NullNodeIdx)
+        {
+            const BspNode node {GetNode<isMapped>(nodeIdx)};
+#ifdef SDLSim
+            numNodesVisited++;
+#endif
+            const Vec2 boxMin {GetVertex<isMapped>(node.minXIdx).x, GetVertex<isMapped>(node.minYIdx).y};
+            const Vec2 boxMax {GetVertex<isMapped>(node.maxXIdx).x, GetVertex<isMapped>(node.maxYIdx).y};
+            if (camera.IsBoxOutsideView(boxMin, boxMax))
+                break;
+            // (a node without children only has its own wall, which is about as quick to check as
+            // its box)
+            if (((node.backNodeIdx != NullNodeIdx) || (node.frontNodeIdx != NullNodeIdx)) && isBoxHidden(boxMin, boxMax))
+                break;
+
+            bool cameraInFront {GeomUtils::IsPointInFrontOfLine({GetVertex<isMapped>(node.p1Idx), GetVertex<isMapped>(node.p2Idx)}, camera.location)};
+            ns.Push({nodeIdx, cameraInFront});
+            nodeIdx = (cameraInFront ? node.frontNodeIdx : node.backNodeIdx);
+        }
+
+        if (ns.IsEmpty())
+            break;
+
+        // the nearest remaining node's near side is done, so render its wall (if it faces the
+        // camera), and then go on to its far side
+        NodeItem ni {ns.Pop()};
+        const BspNode node {GetNode<isMapped>(ni.nodeIdx)};
+        if (ni.cameraInFront && !visitor(node.p1Idx, node.p2Idx))
+            break;
+        nodeIdx = (ni.cameraInFront ? node.backNodeIdx : node.frontNodeIdx);
+    }
+
+    // TODO: handle if camera is exactly on a node's line
+    // wikipedia: If that polygon lies in the plane containing P, add it to the *list of polygons* at node N.
+    // (I currenly don't have this set up as a list...)
+}
+
+// as for Traverse(), but for a ray rather than the camera's field of view - every wall is
+// visited, whichever way it faces, as a ray can hit the back of a wall
+// each node is walked with the part of the ray (from tFrom to tTo) that is in its half of the
+// space: the side of the node's line that the ray starts on is walked up to where the ray has
+// crossed the line, and the other side from where the ray gets to the line - so a node that the
+// ray doesn't cross only has one side walked, and the other side isn't walked at all if the ray
+// has already hit something before getting there
+// (the lines are treated as a little thick, as are the boxes, so that walls split by the tree's
+// lines, whose pieces may be rounded a little over to the other side, are never missed)
+template <bool isMapped, class Visitor>
+void BspTree::TraverseRay(const Line& ray, Scalar maxT, Visitor& visitor) const
+{
+    NodeStack<RayNodeItem> ns;
+#ifdef SDLSim
+    numNodesVisited = 0;
+#endif
+    const Vec2 d {ray.p2 - ray.p1};
+    NodeIdx nodeIdx {(numNodes > 0) ? static_cast<NodeIdx>(0) : NullNodeIdx};
+    Scalar tFrom {0.0f};
+    Scalar tTo {maxT};
+
+    while (true)
+    {
+        while ((nodeIdx != NullNodeIdx) && (tFrom <= tTo) && (tFrom <= maxT))
+        {
+            const BspNode node {GetNode<isMapped>(nodeIdx)};
+#ifdef SDLSim
+            numNodesVisited++;
+#endif
+            // (a node without children only has its own wall, which is quicker to check than
+            // whether the ray could reach it)
+            if ((node.backNodeIdx == NullNodeIdx) && (node.frontNodeIdx == NullNodeIdx))
+            {
+                maxT = visitor(node.p1Idx, node.p2Idx);
+                break;
+            }
+            // (nothing beyond maxT is of interest)
+            const Scalar tEnd {(tTo < maxT) ? tTo : maxT};
+            const Vec2 boxMin {GetVertex<isMapped>(node.minXIdx).x, GetVertex<isMapped>(node.minYIdx).y};
+            const Vec2 boxMax {GetVertex<isMapped>(node.maxXIdx).x, GetVertex<isMapped>(node.maxYIdx).y};
+            if (!IsBoxOnRay(boxMin, boxMax, ray.p1, d, tFrom, tEnd))
+                break;
+
+            bool startInFront;
+            Scalar tNearEnd, tFarStart;
+            ClipRayToLine({GetVertex<isMapped>(node.p1Idx), GetVertex<isMapped>(node.p2Idx)}, ray.p1, d, tEnd,
+                          startInFront, tNearEnd, tFarStart);
+            // (if the ray doesn't get to the line, it can't hit the node's wall either)
+            if (tFarStart <= tEnd)
+                ns.Push({nodeIdx, ((tFarStart > tFrom) ? tFarStart : tFrom), tTo, startInFront});
+            nodeIdx = (startInFront ? node.frontNodeIdx : node.backNodeIdx);
+            if (tNearEnd < tTo)
+                tTo = tNearEnd;
+        }
+
+        if ((maxT < 0.0f) || ns.IsEmpty())
+            break;
+
+        // the node's wall is on its line, so the ray can't hit it before getting to the far side
+        const RayNodeItem ri {ns.Pop()};
+        if (ri.tFrom > maxT)
+        {
+            nodeIdx = NullNodeIdx;
+            continue;
+        }
+        const BspNode node {GetNode<isMapped>(ri.nodeIdx)};
+        maxT = visitor(node.p1Idx, node.p2Idx);
+        if (maxT < 0.0f)
+            break;
+        nodeIdx = (ri.startInFront ? node.backNodeIdx : node.frontNodeIdx);
+        tFrom = ri.tFrom;
+        tTo = ri.tTo;
+    }
+}
+
 #endif /* BspTree_hpp */
@@ -10,130 +10,140 @@
 
 const unsigned char smileyFaceBspTree[] PROGMEM =
 {
-    /* Node: 0 */ 0x00, 0x3d, 0xe4, 0xe9, 0x00, 0xbb, 0xff, 0xbd, 0x00, 0x64, 0x00, 0x00, 0x00, 0xaa, 0x00, 0x00,  /* Back: 1, Front: 24 */
-    /* Node: 1 */ 0x00, 0x76, 0x5e, 0xd1, 0x00, 0x5e, 0x2d, 0xd7, 0x00, 0x67, 0x93, 0xe9, 0x00, 0x53, 0xe6, 0x4e,  /* Back: 2, Front: 14 */
-    /* Node: 2 */ 0x00, 0x4a, 0x62, 0xc9, 0x00, 0x6c, 0xca, 0x8e, 0x00, 0x5d, 0x9a, 0x9c, 0x00, 0x76, 0x3e, 0xd9,  /* Back: 3, Front: 9 */
-    /* Node: 3 */ 0x00, 0x4f, 0x5d, 0x4a, 0x00, 0x5b, 0xdc, 0xbf, 0x00, 0x4a, 0x62, 0xc9, 0x00, 0x6c, 0xca, 0x8e,  /* Back: 4, Front: 7 */
-    /* Node: 4 */ 0x00, 0x5d, 0x9a, 0x9c, 0x00, 0x76, 0x3e, 0xd9, 0x00, 0x73, 0xff, 0xd9, 0x00, 0x6a, 0x4f, 0xd6,  /* Back: 5, Front: -- */
-    /* Node: 5 */ 0x00, 0x73, 0xff, 0xd9, 0x00, 0x6a, 0x4f, 0xd6, 0x00, 0x76, 0x5e, 0xd1, 0x00, 0x5e, 0x2d, 0xd7,  /* Back: 6, Front: -- */
-    /* Node: 6 */ 0x00, 0x67, 0x93, 0xe9, 0x00, 0x53, 0xe6, 0x4e, 0x00, 0x4f, 0x5d, 0x4a, 0x00, 0x5b, 0xdc, 0xbf,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 7 */ 0x00, 0x19, 0x79, 0x8a, 0x00, 0x54, 0xba, 0xc4, 0x00, 0x18, 0xf1, 0x1a, 0x00, 0x44, 0xfc, 0x17,  /* Back: --, Front: 8 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 8 */ 0x00, 0x18, 0xf1, 0x1a, 0x00, 0x44, 0xfc, 0x17, 0x00, 0x31, 0x8f, 0x32, 0x00, 0x2e, 0x5c, 0xb3,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 9 */ 0x00, 0x4a, 0x30, 0xce, 0x00, 0x9d, 0x27, 0x22, 0x00, 0x3d, 0xe4, 0xe9, 0x00, 0xbb, 0xff, 0xbd,  /* Back: 10, Front: 12 */
-    /* Node: 10 */ 0x00, 0x6c, 0x21, 0xe0, 0x00, 0xa4, 0xab, 0x83, 0x00, 0x4a, 0x30, 0xce, 0x00, 0x9d, 0x27, 0x22,  /* Back: --, Front: 11 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 11 */ 0x00, 0x6f, 0x9a, 0x3d, 0x00, 0xa4, 0x85, 0x07, 0x00, 0x6c, 0x21, 0xe0, 0x00, 0xa4, 0xab, 0x83,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 12 */ 0x00, 0x25, 0x4f, 0x37, 0x00, 0xc7, 0x9c, 0x85, 0x00, 0x1d, 0x10, 0x85, 0x00, 0xbe, 0xc7, 0xb0,  /* Back: --, Front: 13 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 13 */ 0x00, 0x1d, 0x10, 0x85, 0x00, 0xbe, 0xc7, 0xb0, 0x00, 0x19, 0x79, 0x8a, 0x00, 0x54, 0xba, 0xc4,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 14 */ 0x00, 0xc0, 0x15, 0x3f, 0x00, 0x50, 0xda, 0x2b, 0x00, 0xab, 0xc3, 0x46, 0x00, 0x5a, 0x26, 0x63,  /* Back: 15, Front: 20 */
-    /* Node: 15 */ 0x00, 0xcf, 0xfa, 0x11, 0x00, 0x66, 0xa1, 0x7a, 0x00, 0xcd, 0x18, 0xe1, 0x00, 0x56, 0xe5, 0xcd,  /* Back: 16, Front: 19 */
-    /* Node: 16 */ 0x00, 0xab, 0xc3, 0x46, 0x00, 0x5a, 0x26, 0x63, 0x00, 0xb5, 0xb1, 0xb6, 0x00, 0x71, 0xf1, 0x3e,  /* Back: 17, Front: -- */
-    /* Node: 17 */ 0x00, 0xb5, 0xb1, 0xb6, 0x00, 0x71, 0xf1, 0x3e, 0x00, 0xcf, 0xfa, 0x11, 0x00, 0x66, 0xa1, 0x7a,  /* Back: 18, Front: -- */
-    /* Node: 18 */ 0x00, 0xcd, 0x18, 0xe1, 0x00, 0x56, 0xe5, 0xcd, 0x00, 0xc0, 0x15, 0x3f, 0x00, 0x50, 0xda, 0x2b,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 19 */ 0x00, 0xf8, 0x6f, 0x05, 0x00, 0x37, 0x11, 0x82, 0x01, 0x10, 0x27, 0xad, 0x00, 0x58, 0xaf, 0x15,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 20 */ 0x00, 0xe9, 0x4f, 0x25, 0x00, 0x21, 0xa2, 0xaa, 0x00, 0xf8, 0x6f, 0x05, 0x00, 0x37, 0x11, 0x82,  /* Back: --, Front: 21 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 21 */ 0x00, 0x31, 0x8f, 0x32, 0x00, 0x2e, 0x5c, 0xb3, 0x00, 0x39, 0x3a, 0xb0, 0x00, 0x27, 0x50, 0x52,  /* Back: --, Front: 22 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 22 */ 0x00, 0x39, 0x3a, 0xb0, 0x00, 0x27, 0x50, 0x52, 0x00, 0x96, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00,  /* Back: --, Front: 23 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 23 */ 0x00, 0x96, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0xe9, 0x4f, 0x25, 0x00, 0x21, 0xa2, 0xaa,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 24 */ 0x00, 0xcf, 0xab, 0x0f, 0x00, 0xb6, 0xbe, 0xda, 0x00, 0xd1, 0xb8, 0x01, 0x00, 0xa5, 0xb7, 0x4d,  /* Back: 25, Front: 38 */
-    /* Node: 25 */ 0x00, 0x92, 0x5d, 0x89, 0x00, 0xaf, 0x44, 0x0f, 0x00, 0xa1, 0xff, 0xf9, 0x00, 0xbd, 0x7b, 0x95,  /* Back: 26, Front: 31 */
-    /* Node: 26 */ 0x00, 0xb4, 0x00, 0x00, 0x00, 0xaa, 0x00, 0x00, 0x00, 0xcf, 0xab, 0x0f, 0x00, 0xb6, 0xbe, 0xda,  /* Back: 27, Front: 29 */
-    /* Node: 27 */ 0x00, 0xc4, 0x34, 0xaf, 0x00, 0xa0, 0xda, 0xd4, 0x00, 0xa3, 0x3f, 0x2c, 0x00, 0xa2, 0x48, 0x53,  /* Back: --, Front: 28 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 28 */ 0x00, 0xd3, 0x42, 0x0a, 0x00, 0x98, 0xee, 0xf2, 0x00, 0xc4, 0x34, 0xaf, 0x00, 0xa0, 0xda, 0xd4,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 29 */ 0x00, 0xa3, 0x3f, 0x2c, 0x00, 0xa2, 0x48, 0x53, 0x00, 0x85, 0x81, 0x18, 0x00, 0xa3, 0x92, 0x27,  /* Back: 30, Front: -- */
-    /* Node: 30 */ 0x00, 0xa1, 0xff, 0xf9, 0x00, 0xbd, 0x7b, 0x95, 0x00, 0xb4, 0x00, 0x00, 0x00, 0xaa, 0x00, 0x00,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 31 */ 0x00, 0x7b, 0xd1, 0xaf, 0x00, 0xbf, 0x97, 0x69, 0x00, 0x92, 0x5d, 0x89, 0x00, 0xaf, 0x44, 0x0f,  /* Back: 32, Front: 35 */
-    /* Node: 32 */ 0x00, 0x64, 0x00, 0x00, 0x00, 0xaa, 0x00, 0x00, 0x00, 0x7b, 0xd1, 0xaf, 0x00, 0xbf, 0x97, 0x69,  /* Back: 33, Front: 34 */
-    /* Node: 33 */ 0x00, 0x85, 0x81, 0x18, 0x00, 0xa3, 0x92, 0x27, 0x00, 0x6f, 0x9a, 0x3d, 0x00, 0xa4, 0x85, 0x07,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 34 */ 0x00, 0x43, 0xbc, 0x33, 0x00, 0xe8, 0x33, 0x8b, 0x00, 0x25, 0x4f, 0x37, 0x00, 0xc7, 0x9c, 0x85,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 35 */ 0x00, 0xc7, 0x91, 0xc4, 0x00, 0xfa, 0x01, 0x0d, 0x00, 0x98, 0x3b, 0xaa, 0x01, 0x04, 0x7a, 0x79,  /* Back: --, Front: 36 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 36 */ 0x00, 0x98, 0x3b, 0xaa, 0x01, 0x04, 0x7a, 0x79, 0x00, 0x50, 0xe6, 0x77, 0x00, 0xf6, 0x4d, 0x8a,  /* Back: --, Front: 37 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 37 */ 0x00, 0x50, 0xe6, 0x77, 0x00, 0xf6, 0x4d, 0x8a, 0x00, 0x43, 0xbc, 0x33, 0x00, 0xe8, 0x33, 0x8b,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 38 */ 0x00, 0xd1, 0xb8, 0x01, 0x00, 0xa5, 0xb7, 0x4d, 0x00, 0xf2, 0x6e, 0x5d, 0x00, 0xa6, 0x59, 0xd6,  /* Back: 39, Front: 44 */
-    /* Node: 39 */ 0x00, 0xd9, 0x24, 0x45, 0x00, 0x95, 0xd6, 0x45, 0x00, 0xd3, 0x42, 0x0a, 0x00, 0x98, 0xee, 0xf2,  /* Back: 40, Front: 42 */
-    /* Node: 40 */ 0x01, 0x1d, 0xdb, 0x65, 0x00, 0x71, 0xac, 0xae, 0x01, 0x1c, 0xe3, 0xdb, 0x00, 0xa7, 0x2c, 0xcd,  /* Back: --, Front: 41 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 41 */ 0x00, 0xf2, 0x6e, 0x5d, 0x00, 0xa6, 0x59, 0xd6, 0x00, 0xd9, 0x24, 0x45, 0x00, 0x95, 0xd6, 0x45,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 42 */ 0x01, 0x1d, 0xf4, 0x8a, 0x00, 0x6c, 0x3d, 0x83, 0x01, 0x1d, 0xdb, 0x65, 0x00, 0x71, 0xac, 0xae,  /* Back: --, Front: 43 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 43 */ 0x01, 0x10, 0x27, 0xad, 0x00, 0x58, 0xaf, 0x15, 0x01, 0x1d, 0xf4, 0x8a, 0x00, 0x6c, 0x3d, 0x83,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 44 */ 0x01, 0x1c, 0xe3, 0xdb, 0x00, 0xa7, 0x2c, 0xcd, 0x01, 0x1c, 0xde, 0xaa, 0x00, 0xa8, 0x4c, 0x09,  /* Back: --, Front: 45 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 45 */ 0x01, 0x1c, 0xde, 0xaa, 0x00, 0xa8, 0x4c, 0x09, 0x01, 0x02, 0xe5, 0x0a, 0x00, 0xd5, 0x54, 0x96,  /* Back: --, Front: 46 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 46 */ 0x01, 0x02, 0xe5, 0x0a, 0x00, 0xd5, 0x54, 0x96, 0x00, 0xd9, 0x37, 0xd2, 0x00, 0xf6, 0x19, 0x52,  /* Back: --, Front: 47 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 47 */ 0x00, 0xd9, 0x37, 0xd2, 0x00, 0xf6, 0x19, 0x52, 0x00, 0xc7, 0x91, 0xc4, 0x00, 0xfa, 0x01, 0x0d,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
+    /* Header */ 0x42, 0x53, 0x50, 0x4d, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x04, 0xc0, 0x4d, 0x0c, 0xf1, 0x47,  /* Version: 1, Size: 1216, CRC: 0x4d0cf147 */
+    /* Counts */ 0x00, 0x30, 0x00, 0x30, 0x00, 0x07, 0x00, 0x02,  /* Vertices: 48, Nodes: 48, Depth: 7, Sections: 2 */
+    /* Bounds */ 0x00, 0x18, 0xf1, 0x1a, 0x00, 0x14, 0x00, 0x00, 0x01, 0x1d, 0xf4, 0x8a, 0x01, 0x04, 0x7a, 0x79,  /* (24.941803, 20) - (285.955231, 260.478409) */
+    /* Section: VERT */ 0x56, 0x45, 0x52, 0x54, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x01, 0x80,  /* Offset: 64, Size: 384 */
+    /* Section: NODE */ 0x4e, 0x4f, 0x44, 0x45, 0x00, 0x00, 0x01, 0xc0, 0x00, 0x00, 0x03, 0x00,  /* Offset: 448, Size: 768 */
+    /* Vertex: 0 */ 0x00, 0x3d, 0xe4, 0xe9, 0x00, 0xbb, 0xff, 0xbd,  /* (61.8941803, 187.998978) */
+    /* Vertex: 1 */ 0x00, 0x64, 0x00, 0x00, 0x00, 0xaa, 0x00, 0x00,  /* (100, 170) */
+    /* Vertex: 2 */ 0x00, 0x76, 0x5e, 0xd1, 0x00, 0x5e, 0x2d, 0xd7,  /* (118.370377, 94.1790619) */
+    /* Vertex: 3 */ 0x00, 0x67, 0x93, 0xe9, 0x00, 0x53, 0xe6, 0x4e,  /* (103.577774, 83.8996277) */
+    /* Vertex: 4 */ 0x00, 0x4a, 0x62, 0xc9, 0x00, 0x6c, 0xca, 0x8e,  /* (74.3858795, 108.791229) */
+    /* Vertex: 5 */ 0x00, 0x5d, 0x9a, 0x9c, 0x00, 0x76, 0x3e, 0xd9,  /* (93.6039429, 118.245499) */
+    /* Vertex: 6 */ 0x00, 0x4f, 0x5d, 0x4a, 0x00, 0x5b, 0xdc, 0xbf,  /* (79.3644104, 91.8622894) */
+    /* Vertex: 7 */ 0x00, 0x73, 0xff, 0xd9, 0x00, 0x6a, 0x4f, 0xd6,  /* (115.999405, 106.311859) */
+    /* Vertex: 8 */ 0x00, 0x19, 0x79, 0x8a, 0x00, 0x54, 0xba, 0xc4,  /* (25.474762, 84.7295532) */
+    /* Vertex: 9 */ 0x00, 0x18, 0xf1, 0x1a, 0x00, 0x44, 0xfc, 0x17,  /* (24.941803, 68.984726) */
+    /* Vertex: 10 */ 0x00, 0x31, 0x8f, 0x32, 0x00, 0x2e, 0x5c, 0xb3,  /* (49.5593567, 46.3621063) */
+    /* Vertex: 11 */ 0x00, 0x4a, 0x30, 0xce, 0x00, 0x9d, 0x27, 0x22,  /* (74.1906433, 157.152863) */
+    /* Vertex: 12 */ 0x00, 0x6c, 0x21, 0xe0, 0x00, 0xa4, 0xab, 0x83,  /* (108.132324, 164.669968) */
+    /* Vertex: 13 */ 0x00, 0x6f, 0x9a, 0x3d, 0x00, 0xa4, 0x85, 0x07,  /* (111.602493, 164.519638) */
+    /* Vertex: 14 */ 0x00, 0x25, 0x4f, 0x37, 0x00, 0xc7, 0x9c, 0x85,  /* (37.309433, 199.611404) */
+    /* Vertex: 15 */ 0x00, 0x1d, 0x10, 0x85, 0x00, 0xbe, 0xc7, 0xb0,  /* (29.0645294, 190.780029) */
+    /* Vertex: 16 */ 0x00, 0xc0, 0x15, 0x3f, 0x00, 0x50, 0xda, 0x2b,  /* (192.082993, 80.8522186) */
+    /* Vertex: 17 */ 0x00, 0xab, 0xc3, 0x46, 0x00, 0x5a, 0x26, 0x63,  /* (171.762787, 90.1499481) */
+    /* Vertex: 18 */ 0x00, 0xcf, 0xfa, 0x11, 0x00, 0x66, 0xa1, 0x7a,  /* (207.976822, 102.630768) */
+    /* Vertex: 19 */ 0x00, 0xcd, 0x18, 0xe1, 0x00, 0x56, 0xe5, 0xcd,  /* (205.097183, 86.8976593) */
+    /* Vertex: 20 */ 0x00, 0xb5, 0xb1, 0xb6, 0x00, 0x71, 0xf1, 0x3e,  /* (181.694183, 113.942352) */
+    /* Vertex: 21 */ 0x00, 0xf8, 0x6f, 0x05, 0x00, 0x37, 0x11, 0x82,  /* (248.43367, 55.0683899) */
+    /* Vertex: 22 */ 0x01, 0x10, 0x27, 0xad, 0x00, 0x58, 0xaf, 0x15,  /* (272.154984, 88.6839142) */
+    /* Vertex: 23 */ 0x00, 0xe9, 0x4f, 0x25, 0x00, 0x21, 0xa2, 0xaa,  /* (233.309158, 33.6354065) */
+    /* Vertex: 24 */ 0x00, 0x39, 0x3a, 0xb0, 0x00, 0x27, 0x50, 0x52,  /* (57.229248, 39.3137512) */
+    /* Vertex: 25 */ 0x00, 0x96, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00,  /* (150, 20) */
+    /* Vertex: 26 */ 0x00, 0xcf, 0xab, 0x0f, 0x00, 0xb6, 0xbe, 0xda,  /* (207.668198, 182.745514) */
+    /* Vertex: 27 */ 0x00, 0xd1, 0xb8, 0x01, 0x00, 0xa5, 0xb7, 0x4d,  /* (209.718765, 165.716019) */
+    /* Vertex: 28 */ 0x00, 0x92, 0x5d, 0x89, 0x00, 0xaf, 0x44, 0x0f,  /* (146.365372, 175.265854) */
+    /* Vertex: 29 */ 0x00, 0xa1, 0xff, 0xf9, 0x00, 0xbd, 0x7b, 0x95,  /* (161.999893, 189.482742) */
+    /* Vertex: 30 */ 0x00, 0xb4, 0x00, 0x00, 0x00, 0xaa, 0x00, 0x00,  /* (180, 170) */
+    /* Vertex: 31 */ 0x00, 0xc4, 0x34, 0xaf, 0x00, 0xa0, 0xda, 0xd4,  /* (196.205795, 160.854797) */
+    /* Vertex: 32 */ 0x00, 0xa3, 0x3f, 0x2c, 0x00, 0xa2, 0x48, 0x53,  /* (163.246765, 162.282516) */
+    /* Vertex: 33 */ 0x00, 0xd3, 0x42, 0x0a, 0x00, 0x98, 0xee, 0xf2,  /* (211.257965, 152.93338) */
+    /* Vertex: 34 */ 0x00, 0x85, 0x81, 0x18, 0x00, 0xa3, 0x92, 0x27,  /* (133.504272, 163.570908) */
+    /* Vertex: 35 */ 0x00, 0x7b, 0xd1, 0xaf, 0x00, 0xbf, 0x97, 0x69,  /* (123.819077, 191.591446) */
+    /* Vertex: 36 */ 0x00, 0x43, 0xbc, 0x33, 0x00, 0xe8, 0x33, 0x8b,  /* (67.7351532, 232.20134) */
+    /* Vertex: 37 */ 0x00, 0xc7, 0x91, 0xc4, 0x00, 0xfa, 0x01, 0x0d,  /* (199.569397, 250.004105) */
+    /* Vertex: 38 */ 0x00, 0x98, 0x3b, 0xaa, 0x01, 0x04, 0x7a, 0x79,  /* (152.233063, 260.478409) */
+    /* Vertex: 39 */ 0x00, 0x50, 0xe6, 0x77, 0x00, 0xf6, 0x4d, 0x8a,  /* (80.9002533, 246.302887) */
+    /* Vertex: 40 */ 0x00, 0xf2, 0x6e, 0x5d, 0x00, 0xa6, 0x59, 0xd6,  /* (242.431107, 166.350922) */
+    /* Vertex: 41 */ 0x00, 0xd9, 0x24, 0x45, 0x00, 0x95, 0xd6, 0x45,  /* (217.141678, 149.83699) */
+    /* Vertex: 42 */ 0x01, 0x1d, 0xdb, 0x65, 0x00, 0x71, 0xac, 0xae,  /* (285.85701, 113.67453) */
+    /* Vertex: 43 */ 0x01, 0x1c, 0xe3, 0xdb, 0x00, 0xa7, 0x2c, 0xcd,  /* (284.89006, 167.175003) */
+    /* Vertex: 44 */ 0x01, 0x1d, 0xf4, 0x8a, 0x00, 0x6c, 0x3d, 0x83,  /* (285.955231, 108.24028) */
+    /* Vertex: 45 */ 0x01, 0x1c, 0xde, 0xaa, 0x00, 0xa8, 0x4c, 0x09,  /* (284.869781, 168.297012) */
+    /* Vertex: 46 */ 0x01, 0x02, 0xe5, 0x0a, 0x00, 0xd5, 0x54, 0x96,  /* (258.894684, 213.330414) */
+    /* Vertex: 47 */ 0x00, 0xd9, 0x37, 0xd2, 0x00, 0xf6, 0x19, 0x52,  /* (217.218048, 246.098907) */
+    /* Node: 0 */ 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x18, 0x00, 0x09, 0x00, 0x19, 0x00, 0x2c, 0x00, 0x26,  /* Back: 1, Front: 24 */
+    /* Node: 1 */ 0x00, 0x02, 0x00, 0x03, 0x00, 0x02, 0x00, 0x0e, 0x00, 0x09, 0x00, 0x19, 0x00, 0x16, 0x00, 0x0e,  /* Back: 2, Front: 14 */
+    /* Node: 2 */ 0x00, 0x04, 0x00, 0x05, 0x00, 0x03, 0x00, 0x09, 0x00, 0x09, 0x00, 0x0a, 0x00, 0x02, 0x00, 0x0e,  /* Back: 3, Front: 9 */
+    /* Node: 3 */ 0x00, 0x06, 0x00, 0x04, 0x00, 0x04, 0x00, 0x07, 0x00, 0x09, 0x00, 0x0a, 0x00, 0x02, 0x00, 0x05,  /* Back: 4, Front: 7 */
+    /* Node: 4 */ 0x00, 0x05, 0x00, 0x07, 0x00, 0x05, 0xff, 0xff, 0x00, 0x06, 0x00, 0x03, 0x00, 0x02, 0x00, 0x05,  /* Back: 5, Front: -- */
+    /* Node: 5 */ 0x00, 0x07, 0x00, 0x02, 0x00, 0x06, 0xff, 0xff, 0x00, 0x06, 0x00, 0x03, 0x00, 0x02, 0x00, 0x07,  /* Back: 6, Front: -- */
+    /* Node: 6 */ 0x00, 0x03, 0x00, 0x06, 0xff, 0xff, 0xff, 0xff, 0x00, 0x06, 0x00, 0x03, 0x00, 0x03, 0x00, 0x06,  /* Back: --, Front: -- */
+    /* Node: 7 */ 0x00, 0x08, 0x00, 0x09, 0xff, 0xff, 0x00, 0x08, 0x00, 0x09, 0x00, 0x0a, 0x00, 0x0a, 0x00, 0x08,  /* Back: --, Front: 8 */
+    /* Node: 8 */ 0x00, 0x09, 0x00, 0x0a, 0xff, 0xff, 0xff, 0xff, 0x00, 0x09, 0x00, 0x0a, 0x00, 0x0a, 0x00, 0x09,  /* Back: --, Front: -- */
+    /* Node: 9 */ 0x00, 0x0b, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x08, 0x00, 0x0d, 0x00, 0x0e,  /* Back: 10, Front: 12 */
+    /* Node: 10 */ 0x00, 0x0c, 0x00, 0x0b, 0xff, 0xff, 0x00, 0x0b, 0x00, 0x0b, 0x00, 0x0b, 0x00, 0x0d, 0x00, 0x0c,  /* Back: --, Front: 11 */
+    /* Node: 11 */ 0x00, 0x0d, 0x00, 0x0c, 0xff, 0xff, 0xff, 0xff, 0x00, 0x0c, 0x00, 0x0d, 0x00, 0x0d, 0x00, 0x0c,  /* Back: --, Front: -- */
+    /* Node: 12 */ 0x00, 0x0e, 0x00, 0x0f, 0xff, 0xff, 0x00, 0x0d, 0x00, 0x08, 0x00, 0x08, 0x00, 0x0e, 0x00, 0x0e,  /* Back: --, Front: 13 */
+    /* Node: 13 */ 0x00, 0x0f, 0x00, 0x08, 0xff, 0xff, 0xff, 0xff, 0x00, 0x08, 0x00, 0x08, 0x00, 0x0f, 0x00, 0x0f,  /* Back: --, Front: -- */
+    /* Node: 14 */ 0x00, 0x10, 0x00, 0x11, 0x00, 0x0f, 0x00, 0x14, 0x00, 0x0a, 0x00, 0x19, 0x00, 0x16, 0x00, 0x14,  /* Back: 15, Front: 20 */
+    /* Node: 15 */ 0x00, 0x12, 0x00, 0x13, 0x00, 0x10, 0x00, 0x13, 0x00, 0x11, 0x00, 0x15, 0x00, 0x16, 0x00, 0x14,  /* Back: 16, Front: 19 */
+    /* Node: 16 */ 0x00, 0x11, 0x00, 0x14, 0x00, 0x11, 0xff, 0xff, 0x00, 0x11, 0x00, 0x10, 0x00, 0x12, 0x00, 0x14,  /* Back: 17, Front: -- */
+    /* Node: 17 */ 0x00, 0x14, 0x00, 0x12, 0x00, 0x12, 0xff, 0xff, 0x00, 0x14, 0x00, 0x10, 0x00, 0x12, 0x00, 0x14,  /* Back: 18, Front: -- */
+    /* Node: 18 */ 0x00, 0x13, 0x00, 0x10, 0xff, 0xff, 0xff, 0xff, 0x00, 0x10, 0x00, 0x10, 0x00, 0x13, 0x00, 0x13,  /* Back: --, Front: -- */
+    /* Node: 19 */ 0x00, 0x15, 0x00, 0x16, 0xff, 0xff, 0xff, 0xff, 0x00, 0x15, 0x00, 0x15, 0x00, 0x16, 0x00, 0x16,  /* Back: --, Front: -- */
+    /* Node: 20 */ 0x00, 0x17, 0x00, 0x15, 0xff, 0xff, 0x00, 0x15, 0x00, 0x0a, 0x00, 0x19, 0x00, 0x15, 0x00, 0x15,  /* Back: --, Front: 21 */
+    /* Node: 21 */ 0x00, 0x0a, 0x00, 0x18, 0xff, 0xff, 0x00, 0x16, 0x00, 0x0a, 0x00, 0x19, 0x00, 0x17, 0x00, 0x0a,  /* Back: --, Front: 22 */
+    /* Node: 22 */ 0x00, 0x18, 0x00, 0x19, 0xff, 0xff, 0x00, 0x17, 0x00, 0x18, 0x00, 0x19, 0x00, 0x17, 0x00, 0x18,  /* Back: --, Front: 23 */
+    /* Node: 23 */ 0x00, 0x19, 0x00, 0x17, 0xff, 0xff, 0xff, 0xff, 0x00, 0x19, 0x00, 0x19, 0x00, 0x17, 0x00, 0x17,  /* Back: --, Front: -- */
+    /* Node: 24 */ 0x00, 0x1a, 0x00, 0x1b, 0x00, 0x19, 0x00, 0x26, 0x00, 0x0e, 0x00, 0x16, 0x00, 0x2c, 0x00, 0x26,  /* Back: 25, Front: 38 */
+    /* Node: 25 */ 0x00, 0x1c, 0x00, 0x1d, 0x00, 0x1a, 0x00, 0x1f, 0x00, 0x0e, 0x00, 0x21, 0x00, 0x21, 0x00, 0x26,  /* Back: 26, Front: 31 */
+    /* Node: 26 */ 0x00, 0x1e, 0x00, 0x1a, 0x00, 0x1b, 0x00, 0x1d, 0x00, 0x22, 0x00, 0x21, 0x00, 0x21, 0x00, 0x1d,  /* Back: 27, Front: 29 */
+    /* Node: 27 */ 0x00, 0x1f, 0x00, 0x20, 0xff, 0xff, 0x00, 0x1c, 0x00, 0x20, 0x00, 0x21, 0x00, 0x21, 0x00, 0x20,  /* Back: --, Front: 28 */
+    /* Node: 28 */ 0x00, 0x21, 0x00, 0x1f, 0xff, 0xff, 0xff, 0xff, 0x00, 0x1f, 0x00, 0x21, 0x00, 0x21, 0x00, 0x1f,  /* Back: --, Front: -- */
+    /* Node: 29 */ 0x00, 0x20, 0x00, 0x22, 0x00, 0x1e, 0xff, 0xff, 0x00, 0x22, 0x00, 0x20, 0x00, 0x1e, 0x00, 0x1d,  /* Back: 30, Front: -- */
+    /* Node: 30 */ 0x00, 0x1d, 0x00, 0x1e, 0xff, 0xff, 0xff, 0xff, 0x00, 0x1d, 0x00, 0x1e, 0x00, 0x1e, 0x00, 0x1d,  /* Back: --, Front: -- */
+    /* Node: 31 */ 0x00, 0x23, 0x00, 0x1c, 0x00, 0x20, 0x00, 0x23, 0x00, 0x0e, 0x00, 0x22, 0x00, 0x25, 0x00, 0x26,  /* Back: 32, Front: 35 */
+    /* Node: 32 */ 0x00, 0x01, 0x00, 0x23, 0x00, 0x21, 0x00, 0x22, 0x00, 0x0e, 0x00, 0x22, 0x00, 0x22, 0x00, 0x24,  /* Back: 33, Front: 34 */
+    /* Node: 33 */ 0x00, 0x22, 0x00, 0x0d, 0xff, 0xff, 0xff, 0xff, 0x00, 0x0d, 0x00, 0x22, 0x00, 0x22, 0x00, 0x0d,  /* Back: --, Front: -- */
+    /* Node: 34 */ 0x00, 0x24, 0x00, 0x0e, 0xff, 0xff, 0xff, 0xff, 0x00, 0x0e, 0x00, 0x0e, 0x00, 0x24, 0x00, 0x24,  /* Back: --, Front: -- */
+    /* Node: 35 */ 0x00, 0x25, 0x00, 0x26, 0xff, 0xff, 0x00, 0x24, 0x00, 0x24, 0x00, 0x24, 0x00, 0x25, 0x00, 0x26,  /* Back: --, Front: 36 */
+    /* Node: 36 */ 0x00, 0x26, 0x00, 0x27, 0xff, 0xff, 0x00, 0x25, 0x00, 0x24, 0x00, 0x24, 0x00, 0x26, 0x00, 0x26,  /* Back: --, Front: 37 */
+    /* Node: 37 */ 0x00, 0x27, 0x00, 0x24, 0xff, 0xff, 0xff, 0xff, 0x00, 0x24, 0x00, 0x24, 0x00, 0x27, 0x00, 0x27,  /* Back: --, Front: -- */
+    /* Node: 38 */ 0x00, 0x1b, 0x00, 0x28, 0x00, 0x27, 0x00, 0x2c, 0x00, 0x25, 0x00, 0x16, 0x00, 0x2c, 0x00, 0x25,  /* Back: 39, Front: 44 */
+    /* Node: 39 */ 0x00, 0x29, 0x00, 0x21, 0x00, 0x28, 0x00, 0x2a, 0x00, 0x21, 0x00, 0x16, 0x00, 0x2c, 0x00, 0x2b,  /* Back: 40, Front: 42 */
+    /* Node: 40 */ 0x00, 0x2a, 0x00, 0x2b, 0xff, 0xff, 0x00, 0x29, 0x00, 0x29, 0x00, 0x2a, 0x00, 0x2a, 0x00, 0x2b,  /* Back: --, Front: 41 */
+    /* Node: 41 */ 0x00, 0x28, 0x00, 0x29, 0xff, 0xff, 0xff, 0xff, 0x00, 0x29, 0x00, 0x29, 0x00, 0x28, 0x00, 0x28,  /* Back: --, Front: -- */
+    /* Node: 42 */ 0x00, 0x2c, 0x00, 0x2a, 0xff, 0xff, 0x00, 0x2b, 0x00, 0x16, 0x00, 0x16, 0x00, 0x2c, 0x00, 0x2a,  /* Back: --, Front: 43 */
+    /* Node: 43 */ 0x00, 0x16, 0x00, 0x2c, 0xff, 0xff, 0xff, 0xff, 0x00, 0x16, 0x00, 0x16, 0x00, 0x2c, 0x00, 0x2c,  /* Back: --, Front: -- */
+    /* Node: 44 */ 0x00, 0x2b, 0x00, 0x2d, 0xff, 0xff, 0x00, 0x2d, 0x00, 0x25, 0x00, 0x2b, 0x00, 0x2b, 0x00, 0x25,  /* Back: --, Front: 45 */
+    /* Node: 45 */ 0x00, 0x2d, 0x00, 0x2e, 0xff, 0xff, 0x00, 0x2e, 0x00, 0x25, 0x00, 0x2d, 0x00, 0x2d, 0x00, 0x25,  /* Back: --, Front: 46 */
+    /* Node: 46 */ 0x00, 0x2e, 0x00, 0x2f, 0xff, 0xff, 0x00, 0x2f, 0x00, 0x25, 0x00, 0x2e, 0x00, 0x2e, 0x00, 0x25,  /* Back: --, Front: 47 */
+    /* Node: 47 */ 0x00, 0x2f, 0x00, 0x25, 0xff, 0xff, 0xff, 0xff, 0x00, 0x25, 0x00, 0x2f, 0x00, 0x2f, 0x00, 0x25,  /* Back: --, Front: -- */
 };
 
 const unsigned char basicAreaBspTree[] PROGMEM =
 {
-    /* Node: 0 */ 0x00, 0x0a, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0xd2, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00,  /* Back: --, Front: 1 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 1 */ 0x00, 0x28, 0x00, 0x00, 0x00, 0x5a, 0x00, 0x00, 0x00, 0x46, 0x00, 0x00, 0x00, 0x46, 0x00, 0x00,  /* Back: 2, Front: 7 */
-    /* Node: 2 */ 0x00, 0x14, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x5a, 0x00, 0x00,  /* Back: 3, Front: 6 */
-    /* Node: 3 */ 0x00, 0x32, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00,  /* Back: 4, Front: 5 */
-    /* Node: 4 */ 0x00, 0x46, 0x00, 0x00, 0x00, 0x46, 0x00, 0x00, 0x00, 0x32, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 5 */ 0x00, 0x0a, 0x00, 0x00, 0x00, 0x2d, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 6 */ 0x00, 0x0a, 0x00, 0x00, 0x00, 0x6e, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x2d, 0x00, 0x00,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 7 */ 0x00, 0xd2, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0xd2, 0x00, 0x00, 0x00, 0xd2, 0x00, 0x00,  /* Back: --, Front: 8 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 8 */ 0x00, 0xbe, 0x00, 0x00, 0x00, 0xbe, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0xaa, 0x00, 0x00,  /* Back: 9, Front: 11 */
-    /* Node: 9 */ 0x00, 0xd2, 0x00, 0x00, 0x00, 0xd2, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0xd2, 0x00, 0x00,  /* Back: --, Front: 10 */
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 10 */ 0x00, 0x0a, 0x00, 0x00, 0x00, 0xd2, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x76, 0x00, 0x00,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
-    /* Node: 11 */ 0x00, 0x0a, 0x00, 0x00, 0x00, 0x76, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x6e, 0x00, 0x00,  /* Back: --, Front: -- */
-    0x7f, 0xff, 0xff, 0xff, 
-    0x7f, 0xff, 0xff, 0xff, 
+    /* Header */ 0x42, 0x53, 0x50, 0x4d, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0xb7, 0xf0, 0x3e, 0x70, 0xec,  /* Version: 1, Size: 183, CRC: 0xf03e70ec */
+    /* Counts */ 0x00, 0x0d, 0x00, 0x0c, 0x00, 0x06, 0x00, 0x02,  /* Vertices: 13, Nodes: 12, Depth: 6, Sections: 2 */
+    /* Bounds */ 0x00, 0x0a, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0xd2, 0x00, 0x00, 0x00, 0xd2, 0x00, 0x00,  /* (10, 10) - (210, 210) */
+    /* Section: VERT */ 0x56, 0x45, 0x52, 0x54, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x23,  /* Offset: 64, Size: 35 */
+    /* Section: NODE */ 0x4e, 0x4f, 0x44, 0x45, 0x00, 0x00, 0x00, 0x63, 0x00, 0x00, 0x00, 0x54,  /* Offset: 99, Size: 84 */
+    /* Scale */ 0x00,  /* Fractional bits: 0 */
+    /* Vertex: 0 */ 0x14, 0x14,  /* (10, 10) */
+    /* Vertex: 1 */ 0x90, 0x03, 0x00,  /* (210, 10) */
+    /* Vertex: 2 */ 0xd3, 0x02, 0xa0, 0x01,  /* (40, 90) */
+    /* Vertex: 3 */ 0x3c, 0x27,  /* (70, 70) */
+    /* Vertex: 4 */ 0x63, 0x13,  /* (20, 60) */
+    /* Vertex: 5 */ 0x3c, 0x27,  /* (50, 40) */
+    /* Vertex: 6 */ 0x4f, 0x0a,  /* (10, 45) */
+    /* Vertex: 7 */ 0x00, 0x82, 0x01,  /* (10, 110) */
+    /* Vertex: 8 */ 0x90, 0x03, 0xc8, 0x01,  /* (210, 210) */
+    /* Vertex: 9 */ 0x27, 0x27,  /* (190, 190) */
+    /* Vertex: 10 */ 0x63, 0x27,  /* (140, 170) */
+    /* Vertex: 11 */ 0x83, 0x02, 0x50,  /* (10, 210) */
+    /* Vertex: 12 */ 0x00, 0xb7, 0x01,  /* (10, 118) */
+    /* Node: 0 */ 0x00, 0x01, 0x02, 0x00, 0x00, 0x01, 0x0b,  /* Back: --, Front: 1 */
+    /* Node: 1 */ 0x02, 0x03, 0x0d, 0x06, 0x00, 0x01, 0x0b,  /* Back: 2, Front: 7 */
+    /* Node: 2 */ 0x04, 0x02, 0x09, 0x06, 0x00, 0x03, 0x07,  /* Back: 3, Front: 6 */
+    /* Node: 3 */ 0x05, 0x04, 0x05, 0x06, 0x00, 0x03, 0x03,  /* Back: 4, Front: 5 */
+    /* Node: 4 */ 0x03, 0x05, 0x00, 0x05, 0x05, 0x03, 0x03,  /* Back: --, Front: -- */
+    /* Node: 5 */ 0x06, 0x00, 0x00, 0x06, 0x00, 0x06, 0x06,  /* Back: --, Front: -- */
+    /* Node: 6 */ 0x07, 0x06, 0x00, 0x07, 0x06, 0x07, 0x07,  /* Back: --, Front: -- */
+    /* Node: 7 */ 0x01, 0x08, 0x02, 0x0b, 0x01, 0x01, 0x08,  /* Back: --, Front: 8 */
+    /* Node: 8 */ 0x09, 0x0a, 0x07, 0x0b, 0x07, 0x08, 0x0b,  /* Back: 9, Front: 11 */
+    /* Node: 9 */ 0x08, 0x0b, 0x02, 0x0b, 0x0c, 0x08, 0x08,  /* Back: --, Front: 10 */
+    /* Node: 10 */ 0x0b, 0x0c, 0x00, 0x0b, 0x0c, 0x0b, 0x0b,  /* Back: --, Front: -- */
+    /* Node: 11 */ 0x0c, 0x07, 0x00, 0x0c, 0x07, 0x0c, 0x0c,  /* Back: --, Front: -- */
 };
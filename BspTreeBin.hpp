@@ -16,6 +16,8 @@
 #endif
 
 extern const unsigned char smileyFaceBspTree[] PROGMEM;
+// (in the compact layout, which takes half the flash, but can only be loaded - see
+// BspTree::SerFlagCompact)
 extern const unsigned char basicAreaBspTree[] PROGMEM;
 
 #endif /* BspTreeBin_hpp */
@@ -8,41 +8,46 @@
 
 #include <math.h>
 #include "Camera.hpp"
-#include "Mat2.hpp"
 #include "Utils.hpp"
 #include "GeomUtils.hpp"
 
 Camera::Camera(const Vec2& location):
     location{location}
 {
-    // cache the normalized versions of the vectors
-    UpdateNormalizedVectors();
-    
-    // compute angles of extremities of viewable area
-    // angles are defined as positive going to the right of the camera direction,
-    // and negative going to the left
-    rightmostVisibleAngle = atan((viewPlaneWidth / 2.0f) / viewPlaneDist);
-    leftmostVisibleAngle = -rightmostVisibleAngle;
-    
+    UpdateDirectionVectors();
     UpdateViewPlaneVectors();
 }
 
-void Camera::Rotate(double angleRad)
+// puts the camera at an absolute location and heading (as opposed to moving it relative
+// to where it is now)
+void Camera::SetPose(const Vec2& newLocation, Scalar headingRad)
 {
-    Mat2 rotMat {Mat2::Rot(angleRad)};
-    dir *= rotMat;
-    halfViewPlane *= rotMat;
-    UpdateNormalizedVectors();
+    location = newLocation;
+    heading = Trig::FromRadians(headingRad);
+    UpdateDirectionVectors();
     UpdateViewPlaneVectors();
-};
+}
 
-void Camera::MoveForward(double distance)
+void Camera::Rotate(Scalar angleRad)
+{
+    Rotate(Trig::FromRadians(angleRad));
+}
+
+// (positive angles turn to the right)
+void Camera::Rotate(Trig::Angle angle)
+{
+    heading += angle;
+    UpdateDirectionVectors();
+    UpdateViewPlaneVectors();
+}
+
+void Camera::MoveForward(Scalar distance)
 {
     location += (dirN * distance);
     UpdateViewPlaneVectors();
 }
 
-void Camera::Strafe(double distanceToRight)
+void Camera::Strafe(Scalar distanceToRight)
 {
     location += (halfViewPlaneN * distanceToRight);
     UpdateViewPlaneVectors();
@@ -58,15 +63,59 @@ bool Camera::IsBehind(const Line &l) const
     return (IsBehind(l.p1) && IsBehind(l.p2));
 }
 
-void Camera::UpdateNormalizedVectors()
+// whether an axis-aligned box (e.g. around some walls) is entirely behind the camera, or
+// entirely past the left or right edge of the field of view, so that nothing inside it can
+// be seen
+// (a box that is outside the field of view, but not entirely past any one of those, e.g. one
+// off to the side of the camera straddling its plane, is not detected - that's rare enough)
+bool Camera::IsBoxOutsideView(const Vec2& boxMin, const Vec2& boxMax) const
+{
+    return (IsBoxOutsideHalfPlane(dirN, boxMin, boxMax) ||
+            IsBoxOutsideHalfPlane(leftEdgeNormal, boxMin, boxMax) ||
+            IsBoxOutsideHalfPlane(rightEdgeNormal, boxMin, boxMax));
+}
+
+// whether all of a box is outside the half plane through the camera's location, on the side
+// that "normal" points into
+// only the box's corner which is furthest in the normal's direction needs to be checked -
+// if that one is outside, all of them are
+bool Camera::IsBoxOutsideHalfPlane(const Vec2& normal, const Vec2& boxMin, const Vec2& boxMax) const
+{
+    Vec2 corner {((normal.x >= 0) ? boxMax.x : boxMin.x) - location.x,
+                 ((normal.y >= 0) ? boxMax.y : boxMin.y) - location.y};
+    return ((Wide<Scalar>::Mul(corner.x, normal.x) + Wide<Scalar>::Mul(corner.y, normal.y)) < 0);
+}
+
+// transforms a point from world space into the camera's space, where x is the distance to the
+// right of the view direction, and y is the distance in front of the camera (i.e. the
+// perpendicular distance, as used for column heights)
+Vec2 Camera::ToViewSpace(const Vec2& p) const
 {
-    dirN = dir.Norm();
-    halfViewPlaneN = halfViewPlane.Norm();
+    Vec2 fromCamera {p - location};
+    return {fromCamera * halfViewPlaneN, fromCamera * dirN};
+}
+
+void Camera::UpdateDirectionVectors()
+{
+    // a heading of 0 looks along +y, with the right side of the view plane towards -x,
+    // and positive headings turn to the right
+    Scalar sinHeading {Trig::Sin(heading)};
+    Scalar cosHeading {Trig::Cos(heading)};
+    dirN = {-sinHeading, cosHeading};
+    halfViewPlaneN = {-cosHeading, -sinHeading};
+    dir = dirN * viewPlaneDist;
+    halfViewPlane = halfViewPlaneN * (viewPlaneWidth / 2.0f);
+
+    // (a point is inside the left edge if its angle to the right of the view direction is at
+    // least that of the view plane's left end, i.e. x / y >= -(viewPlaneWidth / 2) / viewPlaneDist in
+    // view space - see ToViewSpace() - and similarly for the right edge)
+    leftEdgeNormal = dirN * (viewPlaneWidth / 2.0f) + halfViewPlaneN * viewPlaneDist;
+    rightEdgeNormal = dirN * (viewPlaneWidth / 2.0f) - halfViewPlaneN * viewPlaneDist;
 }
 
+// (this is called whenever the camera moves or turns)
 void Camera::UpdateViewPlaneVectors()
 {
     viewPlaneMiddle = location + dir;
-    leftmostViewPlaneEnd = viewPlaneMiddle - halfViewPlane;
-    rightmostViewPlaneEnd = viewPlaneMiddle + halfViewPlane;
+    generation++;
 }
@@ -11,6 +11,8 @@
 
 #include "Vec2.hpp"
 #include "Line.hpp"
+#include "Trig.hpp"
+#include "Fixed.hpp"
 
 //              * location  -
 //             /|\          ^
@@ -31,19 +33,28 @@ public:
     Camera(const Vec2& location);
     ~Camera() = default;
     
-    void Rotate(double angleRad);
-    void MoveForward(double distance);
-    void Strafe(double distanceToRight);
+    void SetPose(const Vec2& newLocation, Scalar headingRad);
+    void Rotate(Scalar angleRad);
+    void Rotate(Trig::Angle angle);
+    void MoveForward(Scalar distance);
+    void Strafe(Scalar distanceToRight);
     bool IsBehind(const Vec2& p) const;
     bool IsBehind(const Line& l) const;
+    bool IsBoxOutsideView(const Vec2& boxMin, const Vec2& boxMax) const;
+    Vec2 ToViewSpace(const Vec2& p) const;
+
+    // changes whenever the camera moves or turns (wrapping around), so that anything computed
+    // from the camera's pose can tell whether it is still valid (see ProjectionCache)
+    uint16_t GetGeneration() const { return generation; }
     
-    const double viewPlaneWidth {5.0f}; // maps to screen width
-    const double viewPlaneDist {5.0f};
+    const Scalar viewPlaneWidth {5.0f}; // maps to screen width
+    const Scalar viewPlaneDist {5.0f};
     
     Vec2 location;
     
     // relative to location
     // magnitude represents distance to view plane
+    // (a heading of 0 means that the camera is looking "up" the y axis)
     Vec2 dir {0.0f, viewPlaneDist};
     
     // a vector that starts at the end of the "dir" vector,
@@ -53,14 +64,21 @@ public:
     // normalized versions of the above angles, just as an optimization
     Vec2 dirN, halfViewPlaneN;
 
-    // (cached upfront during creation of camera so this doesn't have to be
-    // computed over and over in BSP rendering algorithm)
-    double leftmostVisibleAngle, rightmostVisibleAngle;
+    // perpendicular to the left and right edges of the field of view (the lines from the camera
+    // through the ends of the view plane), pointing into it
+    Vec2 leftEdgeNormal, rightEdgeNormal;
+
     Vec2 viewPlaneMiddle;
-    Vec2 leftmostViewPlaneEnd, rightmostViewPlaneEnd;
 
 private:
-    void UpdateNormalizedVectors();
+    // (the direction vectors are always recomputed from this, rather than being rotated
+    // themselves, so that errors can't accumulate over many rotations)
+    Trig::Angle heading {0};
+
+    uint16_t generation {0};
+
+    bool IsBoxOutsideHalfPlane(const Vec2& normal, const Vec2& boxMin, const Vec2& boxMax) const;
+    void UpdateDirectionVectors();
     void UpdateViewPlaneVectors();
 };
 
@@ -0,0 +1,48 @@
+//
+//  ColumnRasterizer.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include "ColumnRasterizer.hpp"
+
+void ColumnRasterizer::Rasterize(uint8_t* pPages, uint8_t numPages, uint8_t y1, uint8_t y2, uint8_t ditherPattern)
+{
+    const uint16_t columnHeight {static_cast<uint16_t>(numPages * 8)};
+    if (y2 > columnHeight)
+        y2 = static_cast<uint8_t>(columnHeight);
+
+    // (an empty span means an empty column)
+    if (y1 >= y2)
+    {
+        for (uint8_t pageNum = 0; pageNum < numPages; pageNum++)
+            pPages[pageNum] = 0x00;
+        return;
+    }
+
+    const uint8_t firstPage {static_cast<uint8_t>(y1 >> 3)};
+    const uint8_t lastPage {static_cast<uint8_t>((y2 - 1) >> 3)};
+
+    // pixels from y1 down in the first page, and up to (y2 - 1) in the last page
+    uint8_t firstMask {static_cast<uint8_t>(0xFF << (y1 & 0x07))};
+    uint8_t lastMask {static_cast<uint8_t>(0xFF >> (7 - ((y2 - 1) & 0x07)))};
+    if (firstPage == lastPage)
+        firstMask &= lastMask;
+
+    uint8_t pageNum {0};
+    for (; pageNum < firstPage; pageNum++)
+        pPages[pageNum] = 0x00;
+
+    pPages[pageNum++] = (firstMask & ditherPattern);
+
+    if (firstPage != lastPage)
+    {
+        for (; pageNum < lastPage; pageNum++)
+            pPages[pageNum] = ditherPattern;
+        pPages[pageNum++] = (lastMask & ditherPattern);
+    }
+
+    for (; pageNum < numPages; pageNum++)
+        pPages[pageNum] = 0x00;
+}
@@ -0,0 +1,31 @@
+//
+//  ColumnRasterizer.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef ColumnRasterizer_hpp
+#define ColumnRasterizer_hpp
+
+#include <stdint.h>
+
+// fills in one screen column of the display's pixel format: a column is a run of "pages" of
+// 8 vertical pixels, one byte each, with the least significant bit at the top
+//
+// rather than testing every pixel, each page is made from a mask - a page is either entirely
+// outside of the lit span (0x00), entirely inside it (0xFF), or one of the two pages holding
+// the ends of the span, which are a single shift each - so the cost is a few operations per
+// page instead of per pixel
+class ColumnRasterizer
+{
+public:
+    ColumnRasterizer() = delete;
+    ~ColumnRasterizer() = delete;
+
+    // lights pixels [y1, y2) of the column (anything past the end of the column is ignored),
+    // with the dither pattern applied to every page
+    static void Rasterize(uint8_t* pPages, uint8_t numPages, uint8_t y1, uint8_t y2, uint8_t ditherPattern);
+};
+
+#endif /* ColumnRasterizer_hpp */
@@ -0,0 +1,107 @@
+//
+//  CoverageBuffer.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <string.h>
+#include "CoverageBuffer.hpp"
+
+CoverageBuffer::CoverageBuffer(uint8_t width):
+    width{width},
+    numBytes{static_cast<uint8_t>((static_cast<uint16_t>(width) + 7) / 8)},
+    numOpen{width}
+{
+    pBits = new uint8_t[numBytes];
+    Clear();
+}
+
+CoverageBuffer::~CoverageBuffer()
+{
+    delete[] pBits;
+}
+
+void CoverageBuffer::Clear()
+{
+    memset(pBits, 0, numBytes);
+
+    // any bits past the last column (in the last byte) are permanently "covered", so that
+    // searches never have to check against the width
+    if (width & 0x07)
+        pBits[numBytes - 1] = static_cast<uint8_t>(0xFF << (width & 0x07));
+
+    numOpen = width;
+}
+
+bool CoverageBuffer::FindOpen(uint8_t from, uint8_t to, uint8_t& x) const
+{
+    uint8_t byteIdx {static_cast<uint8_t>(from >> 3)};
+    const uint8_t lastByteIdx {static_cast<uint8_t>(to >> 3)};
+
+    // (ignore columns before "from" in the first byte)
+    uint8_t open {static_cast<uint8_t>(~pBits[byteIdx] & (0xFF << (from & 0x07)))};
+
+    while (!open)
+    {
+        if (byteIdx == lastByteIdx)
+            return false;
+        open = static_cast<uint8_t>(~pBits[++byteIdx]);
+    }
+
+    x = static_cast<uint8_t>((byteIdx << 3) + LowestSetBit(open));
+    return (x <= to);
+}
+
+uint8_t CoverageBuffer::FindOpenRunEnd(uint8_t x, uint8_t to) const
+{
+    uint8_t byteIdx {static_cast<uint8_t>(x >> 3)};
+    const uint8_t lastByteIdx {static_cast<uint8_t>(to >> 3)};
+
+    // (ignore columns before x in the first byte)
+    uint8_t covered {static_cast<uint8_t>(pBits[byteIdx] & (0xFF << (x & 0x07)))};
+
+    while (!covered)
+    {
+        if (byteIdx == lastByteIdx)
+            return to;
+        covered = pBits[++byteIdx];
+    }
+
+    // the run ends just before the next covered column
+    uint8_t runEnd {static_cast<uint8_t>((byteIdx << 3) + LowestSetBit(covered) - 1)};
+    return (runEnd < to ? runEnd : to);
+}
+
+void CoverageBuffer::CoverOpenRun(uint8_t from, uint8_t to)
+{
+    uint8_t firstByteIdx {static_cast<uint8_t>(from >> 3)};
+    uint8_t lastByteIdx {static_cast<uint8_t>(to >> 3)};
+    uint8_t firstMask {static_cast<uint8_t>(0xFF << (from & 0x07))};
+    uint8_t lastMask {static_cast<uint8_t>(0xFF >> (7 - (to & 0x07)))};
+
+    if (firstByteIdx == lastByteIdx)
+    {
+        pBits[firstByteIdx] |= (firstMask & lastMask);
+    }
+    else
+    {
+        pBits[firstByteIdx] |= firstMask;
+        for (uint8_t byteIdx = firstByteIdx + 1; byteIdx < lastByteIdx; byteIdx++)
+            pBits[byteIdx] = 0xFF;
+        pBits[lastByteIdx] |= lastMask;
+    }
+
+    numOpen -= (to - from + 1);
+}
+
+uint8_t CoverageBuffer::LowestSetBit(uint8_t byte)
+{
+    uint8_t bit {0};
+    while (!(byte & 0x01))
+    {
+        byte >>= 1;
+        bit++;
+    }
+    return bit;
+}
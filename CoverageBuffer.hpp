@@ -0,0 +1,56 @@
+//
+//  CoverageBuffer.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef CoverageBuffer_hpp
+#define CoverageBuffer_hpp
+
+#include <stdint.h>
+
+// keeps track of which screen columns have already been drawn in a frame, similar in spirit to
+// the "solid segs" list in the Doom engine
+// rather than a list of spans, this uses one bit per column (16 bytes for a 128-pixel-wide screen),
+// which is both smaller and simpler on the embedded hardware - runs of columns that are already
+// drawn are skipped 8 columns at a time, and a count of columns still open means that checking
+// whether the whole screen has been drawn is a single comparison
+class CoverageBuffer
+{
+public:
+    CoverageBuffer(uint8_t width);
+    ~CoverageBuffer();
+
+    void Clear();
+    bool IsEmpty() const { return (numOpen == width); }
+    bool IsFull() const { return (numOpen == 0); }
+    bool IsCovered(uint8_t x) const { return (pBits[x >> 3] & (1 << (x & 0x07))); }
+    // whether all of columns [from, to] are covered
+    bool IsRangeCovered(uint8_t from, uint8_t to) const
+    {
+        uint8_t x;
+        return !FindOpen(from, to, x);
+    }
+
+    // finds the first column in [from, to] that is not yet covered
+    // returns false if all of them are covered
+    bool FindOpen(uint8_t from, uint8_t to, uint8_t& x) const;
+
+    // given an open column x, finds the last column of the run of open columns starting at x
+    // (stopping at column "to")
+    uint8_t FindOpenRunEnd(uint8_t x, uint8_t to) const;
+
+    // marks columns [from, to] as covered - they must all currently be open
+    void CoverOpenRun(uint8_t from, uint8_t to);
+
+private:
+    static uint8_t LowestSetBit(uint8_t byte);
+
+    uint8_t* pBits; // one bit per column, set once the column is covered
+    const uint8_t width;
+    const uint8_t numBytes;
+    uint8_t numOpen;
+};
+
+#endif /* CoverageBuffer_hpp */
@@ -0,0 +1,131 @@
+//
+//  Fixed.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include "Fixed.hpp"
+#include "Trig.hpp"
+
+namespace
+{
+    // integer square root (floor) of a 64-bit number, one result bit at a time
+    uint32_t ISqrt(uint64_t n)
+    {
+        uint64_t result {0};
+        uint64_t bit {static_cast<uint64_t>(1) << 62};
+
+        while (bit > n)
+            bit >>= 2;
+
+        // (written without branches, as which way each bit goes is about as predictable as a coin toss)
+        while (bit != 0)
+        {
+            uint64_t trial {result + bit};
+            uint64_t mask {static_cast<uint64_t>(0) - static_cast<uint64_t>(n >= trial)};
+            n -= trial & mask;
+            result = (result >> 1) + (bit & mask);
+            bit >>= 2;
+        }
+
+        return static_cast<uint32_t>(result);
+    }
+
+    uint64_t Abs(int64_t n)
+    {
+        return (n < 0 ? static_cast<uint64_t>(-(n + 1)) + 1 : static_cast<uint64_t>(n));
+    }
+}
+
+Fixed operator/(Fixed lhs, Fixed rhs)
+{
+    int64_t num {static_cast<int64_t>(lhs.encoding) * Fixed::One};
+
+    // saturate if the result would be out of range
+    // (this is the same test as in Doom's FixedDiv())
+    if ((Abs(lhs.encoding) >> 14) >= Abs(rhs.encoding))
+        return (((lhs.encoding ^ rhs.encoding) < 0) ? Fixed::Min() : Fixed::Max());
+
+    return Fixed::FromEncoding(static_cast<int32_t>(num / rhs.encoding));
+}
+
+Fixed operator/(FixedProduct lhs, FixedProduct rhs)
+{
+    // the result needs 16 more fractional bits than the quotient of the two 32.32 encodings
+    // gives - shift the numerator up if there's room, otherwise shift the denominator down
+    // (losing a little precision, but only for what would be large results anyway)
+    int64_t num {lhs.encoding};
+    int64_t den {rhs.encoding};
+    uint8_t shift {16};
+    while ((shift > 0) && (Abs(num) < (static_cast<uint64_t>(1) << 62)))
+    {
+        num *= 2;
+        shift--;
+    }
+    den /= (static_cast<int64_t>(1) << shift);
+
+    if (den == 0)
+        return (num < 0 ? Fixed::Min() : Fixed::Max());
+
+    int64_t quotient {num / den};
+    if (quotient > INT32_MAX)
+        return Fixed::Max();
+    if (quotient < INT32_MIN)
+        return Fixed::Min();
+    return Fixed::FromEncoding(static_cast<int32_t>(quotient));
+}
+
+Fixed fabs(Fixed f)
+{
+    return (f < 0 ? -f : f);
+}
+
+FixedProduct fabs(FixedProduct p)
+{
+    return (p < 0 ? -p : p);
+}
+
+Fixed sqrt(Fixed f)
+{
+    // sqrt(n * 2^16) * 2^8 = sqrt(n * 2^32), so this only needs one integer square root
+    if (f.GetEncoding() <= 0)
+        return 0;
+    return Fixed::FromEncoding(static_cast<int32_t>(ISqrt(static_cast<uint64_t>(f.GetEncoding()) << 16)));
+}
+
+Fixed sqrt(FixedProduct p)
+{
+    // the encoding has 32 fractional bits, so its integer square root has 16, as a Fixed does
+    if (p.GetEncoding() <= 0)
+        return 0;
+    return Fixed::FromEncoding(static_cast<int32_t>(ISqrt(static_cast<uint64_t>(p.GetEncoding()))));
+}
+
+// (these go through the lookup tables in Trig, so never touch floating point)
+Fixed sin(Fixed angleRad)
+{
+    return static_cast<Fixed>(Trig::Sin(Trig::FromRadians(angleRad)));
+}
+
+Fixed cos(Fixed angleRad)
+{
+    return static_cast<Fixed>(Trig::Cos(Trig::FromRadians(angleRad)));
+}
+
+Fixed tan(Fixed angleRad)
+{
+    return static_cast<Fixed>(Trig::Tan(Trig::FromRadians(angleRad)));
+}
+
+Fixed atan(Fixed f)
+{
+    // (the angle is between a quarter turn either way, so the ones past a half turn are negative)
+    const Trig::Angle angle {Trig::Atan2(static_cast<Scalar>(f), 1)};
+    return ((angle < Trig::HalfTurn) ? Trig::ToFixedRadians(angle) : -Trig::ToFixedRadians(static_cast<Trig::Angle>(-angle)));
+}
+
+Fixed acos(Fixed f)
+{
+    return Trig::ToFixedRadians(Trig::Acos(static_cast<Scalar>(f)));
+}
@@ -0,0 +1,204 @@
+//
+//  Fixed.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef Fixed_hpp
+#define Fixed_hpp
+
+#include <stdint.h>
+
+// a 16.16 fixed-point number, usable as a drop-in replacement for double in the math classes
+// (see Scalar.hpp) - on the embedded hardware, which has no floating point unit, this makes
+// arithmetic much cheaper
+//
+// the range is only about +/- 32768, with a resolution of about 0.000015, so some care is needed:
+// * multiplication wraps around if the result is out of range (as int arithmetic would), which
+//   can easily happen for e.g. the cross product of two map-sized vectors - see FixedProduct
+//   below for how to deal with that
+// * division saturates at the largest/smallest value instead of overflowing (which also
+//   makes division by 0 safe)
+class Fixed
+{
+public:
+    constexpr Fixed():
+        encoding{0}
+    {}
+    constexpr Fixed(int number):
+        encoding{static_cast<int32_t>(number) * One}
+    {}
+    constexpr Fixed(long number):
+        encoding{static_cast<int32_t>(number) * One}
+    {}
+    constexpr Fixed(unsigned int number):
+        encoding{static_cast<int32_t>(number) * One}
+    {}
+    constexpr Fixed(unsigned long number):
+        encoding{static_cast<int32_t>(number) * One}
+    {}
+    constexpr Fixed(double number):
+        encoding{static_cast<int32_t>(number * res + (number < 0.0f ? -0.5f : 0.5f))}
+    {}
+    constexpr Fixed(float number):
+        Fixed(static_cast<double>(number))
+    {}
+    ~Fixed() = default;
+
+    static constexpr Fixed FromEncoding(int32_t encoding) { return Fixed(encoding, 0); }
+    constexpr int32_t GetEncoding() const { return encoding; }
+
+    constexpr double Unfixed() const { return Unfixed(encoding); }
+
+    // a (public) constexpr version of this function is useful for static_asserts
+    static constexpr double Unfixed(int32_t encoding)
+    {
+        return (static_cast<double>(encoding) / res);
+    }
+
+    static constexpr Fixed Max() { return FromEncoding(INT32_MAX); }
+    static constexpr Fixed Min() { return FromEncoding(INT32_MIN); }
+
+    // conversions out are explicit, so that there is never any doubt about which
+    // arithmetic is being done
+    // (conversions to integers truncate towards 0, as they would for a double)
+    explicit constexpr operator double() const { return Unfixed(); }
+    explicit constexpr operator float() const { return static_cast<float>(Unfixed()); }
+    explicit constexpr operator int8_t() const { return static_cast<int8_t>(Truncate()); }
+    explicit constexpr operator uint8_t() const { return static_cast<uint8_t>(Truncate()); }
+    explicit constexpr operator int16_t() const { return static_cast<int16_t>(Truncate()); }
+    explicit constexpr operator uint16_t() const { return static_cast<uint16_t>(Truncate()); }
+    explicit constexpr operator int32_t() const { return Truncate(); }
+    explicit constexpr operator uint32_t() const { return static_cast<uint32_t>(Truncate()); }
+
+    friend constexpr Fixed operator+(Fixed lhs, Fixed rhs) { return FromEncoding(lhs.encoding + rhs.encoding); }
+    friend constexpr Fixed operator-(Fixed lhs, Fixed rhs) { return FromEncoding(lhs.encoding - rhs.encoding); }
+    friend constexpr Fixed operator-(Fixed f) { return FromEncoding(-f.encoding); }
+    friend constexpr Fixed operator*(Fixed lhs, Fixed rhs)
+    {
+        return FromEncoding(static_cast<int32_t>((static_cast<int64_t>(lhs.encoding) * rhs.encoding) >> 16));
+    }
+    friend Fixed operator/(Fixed lhs, Fixed rhs);
+
+    Fixed& operator+=(Fixed rhs) { encoding += rhs.encoding; return *this; }
+    Fixed& operator-=(Fixed rhs) { encoding -= rhs.encoding; return *this; }
+    Fixed& operator*=(Fixed rhs) { *this = *this * rhs; return *this; }
+    Fixed& operator/=(Fixed rhs) { *this = *this / rhs; return *this; }
+
+    friend constexpr bool operator==(Fixed lhs, Fixed rhs) { return (lhs.encoding == rhs.encoding); }
+    friend constexpr bool operator!=(Fixed lhs, Fixed rhs) { return (lhs.encoding != rhs.encoding); }
+    friend constexpr bool operator<(Fixed lhs, Fixed rhs) { return (lhs.encoding < rhs.encoding); }
+    friend constexpr bool operator>(Fixed lhs, Fixed rhs) { return (lhs.encoding > rhs.encoding); }
+    friend constexpr bool operator<=(Fixed lhs, Fixed rhs) { return (lhs.encoding <= rhs.encoding); }
+    friend constexpr bool operator>=(Fixed lhs, Fixed rhs) { return (lhs.encoding >= rhs.encoding); }
+
+private:
+    // (the dummy argument keeps this from being confused with the public int constructor)
+    constexpr Fixed(int32_t encoding, int):
+        encoding{encoding}
+    {}
+
+    constexpr int32_t Truncate() const
+    {
+        return (encoding >= 0 ? (encoding >> 16) : -((-encoding) >> 16));
+    }
+
+    int32_t encoding;
+
+    static constexpr int32_t One {static_cast<int32_t>(1) << 16};
+
+    // resolution of a fixed-point number (the amount that the LSB in the fractional part represents)
+    static constexpr double res {static_cast<double>(One)};
+};
+
+// the exact product of two Fixed numbers (32.32 fixed point, in 64 bits) - for intermediate results
+// which would overflow a Fixed, such as cross products used for side-of-line tests, or squared
+// magnitudes
+// these support only what is needed for that: adding/subtracting/comparing products, and then
+// dividing one product by another (or taking the square root of one) to get back to a Fixed
+class FixedProduct
+{
+public:
+    constexpr FixedProduct():
+        encoding{0}
+    {}
+    constexpr FixedProduct(int number):
+        encoding{static_cast<int64_t>(number) * One}
+    {}
+    constexpr FixedProduct(double number):
+        encoding{static_cast<int64_t>(number * static_cast<double>(One))}
+    {}
+    constexpr FixedProduct(Fixed f):
+        encoding{static_cast<int64_t>(f.GetEncoding()) * (static_cast<int64_t>(1) << 16)}
+    {}
+    constexpr FixedProduct(Fixed lhs, Fixed rhs):
+        encoding{static_cast<int64_t>(lhs.GetEncoding()) * rhs.GetEncoding()}
+    {}
+    ~FixedProduct() = default;
+
+    constexpr int64_t GetEncoding() const { return encoding; }
+
+    // (wraps around if the value is out of range for a Fixed)
+    constexpr Fixed ToFixed() const { return Fixed::FromEncoding(static_cast<int32_t>(encoding >> 16)); }
+
+    friend constexpr FixedProduct operator+(FixedProduct lhs, FixedProduct rhs) { return FromEncoding(lhs.encoding + rhs.encoding); }
+    friend constexpr FixedProduct operator-(FixedProduct lhs, FixedProduct rhs) { return FromEncoding(lhs.encoding - rhs.encoding); }
+    friend constexpr FixedProduct operator-(FixedProduct p) { return FromEncoding(-p.encoding); }
+
+    // the ratio of two products, saturating like Fixed division
+    friend Fixed operator/(FixedProduct lhs, FixedProduct rhs);
+
+    friend constexpr bool operator==(FixedProduct lhs, FixedProduct rhs) { return (lhs.encoding == rhs.encoding); }
+    friend constexpr bool operator!=(FixedProduct lhs, FixedProduct rhs) { return (lhs.encoding != rhs.encoding); }
+    friend constexpr bool operator<(FixedProduct lhs, FixedProduct rhs) { return (lhs.encoding < rhs.encoding); }
+    friend constexpr bool operator>(FixedProduct lhs, FixedProduct rhs) { return (lhs.encoding > rhs.encoding); }
+    friend constexpr bool operator<=(FixedProduct lhs, FixedProduct rhs) { return (lhs.encoding <= rhs.encoding); }
+    friend constexpr bool operator>=(FixedProduct lhs, FixedProduct rhs) { return (lhs.encoding >= rhs.encoding); }
+
+private:
+    static constexpr FixedProduct FromEncoding(int64_t encoding) { return FixedProduct(encoding, 0); }
+    constexpr FixedProduct(int64_t encoding, int):
+        encoding{encoding}
+    {}
+
+    int64_t encoding;
+
+    static constexpr int64_t One {static_cast<int64_t>(1) << 32};
+};
+
+// math library functions for fixed point (found through argument-dependent lookup, so generic code
+// can call e.g. sqrt(n) regardless of whether n is a double or a Fixed)
+Fixed fabs(Fixed f);
+FixedProduct fabs(FixedProduct p);
+Fixed sqrt(Fixed f);
+Fixed sqrt(FixedProduct p);
+Fixed sin(Fixed angleRad);
+Fixed cos(Fixed angleRad);
+Fixed tan(Fixed angleRad);
+Fixed atan(Fixed f);
+Fixed acos(Fixed f);
+
+// for intermediate results that need twice the range/precision of T - e.g. for a cross product
+// of two vectors, Wide<T>::Mul(a.x, b.y) - Wide<T>::Mul(a.y, b.x)
+// for floating point, there's nothing to do, but for fixed point this uses a FixedProduct
+// (Narrow() cuts a result back down to a T, rounding as T's own multiplication does)
+template<typename T>
+class Wide
+{
+public:
+    typedef T Type;
+    static constexpr T Mul(T lhs, T rhs) { return lhs * rhs; }
+    static constexpr T Narrow(T wide) { return wide; }
+};
+
+template<>
+class Wide<Fixed>
+{
+public:
+    typedef FixedProduct Type;
+    static constexpr FixedProduct Mul(Fixed lhs, Fixed rhs) { return FixedProduct(lhs, rhs); }
+    static constexpr Fixed Narrow(FixedProduct wide) { return wide.ToFixed(); }
+};
+
+#endif /* Fixed_hpp */
@@ -9,16 +9,17 @@
 #include "Game.hpp"
 #include "BspTreeBin.hpp"
 
-constexpr Wall Game::walls[];
-
 Game::Game(uint8_t* pPixelBuf,
            uint8_t screenWidth,
            uint8_t screenHeight,
            Renderer::ColRenderedCbType colRenderedCb):
     camera({60.0f, 15.0f}),
     bspr(pPixelBuf, screenWidth, screenHeight, colRenderedCb, camera)
-    //rc(pPixelBuf, screenWidth, screenHeight, colRenderedCb, camera, walls, 9)
+    // (the raycaster renders the BSP renderer's map, rather than a list of walls of its own)
+    //rc(pPixelBuf, screenWidth, screenHeight, colRenderedCb, camera, bspr.GetBspTree())
 {
+    // (MapBin() could be used instead, to render the tree straight from flash without copying it
+    // into RAM - this is slower, but leaves room for much bigger maps)
     //bspr.LoadBin(basicAreaBspTree);
     bspr.LoadBin(smileyFaceBspTree);
 }
@@ -29,17 +30,17 @@ void Game::ProcessFrame()
     //rc.RenderScene();
 }
 
-void Game::RotateCamera(double angleRad)
+void Game::RotateCamera(Scalar angleRad)
 {
     camera.Rotate(angleRad);
 }
 
-void Game::MoveCamera(double distance)
+void Game::MoveCamera(Scalar distance)
 {
     camera.MoveForward(distance);
 }
 
-void Game::StrafeCamera(double distanceToRight)
+void Game::StrafeCamera(Scalar distanceToRight)
 {
     camera.Strafe(distanceToRight);
 }
@@ -10,7 +10,6 @@
 #define Game_hpp
 
 #include <stdint.h>
-#include "Wall.hpp"
 #include "Line.hpp"
 #include "Camera.hpp"
 #include "BspRenderer.hpp"
@@ -25,27 +24,11 @@ public:
          Renderer::ColRenderedCbType colRenderedCb);
     void ProcessFrame();
     void ToggleRenderers();
-    void RotateCamera(double angleRad);
-    void MoveCamera(double distance);
-    void StrafeCamera(double distanceToRight);
+    void RotateCamera(Scalar angleRad);
+    void MoveCamera(Scalar distance);
+    void StrafeCamera(Scalar distanceToRight);
     
 private:
-    static constexpr Wall walls[]
-    {
-        // area bounding box
-        { { {  10.0f,  10.0f }, { 210.0f,  10.0f } } },
-        { { { 210.0f,  10.0f }, { 210.0f, 210.0f } } },
-        { { { 210.0f, 210.0f }, {  10.0f, 210.0f } } },
-        { { {  10.0f, 210.0f }, {  10.0f,  10.0f } } },
-        // standalone wall
-        { { { 190.0f, 190.0f }, { 140.0f, 170.0f } } },
-        // interior "box"
-        { { {  20.0f,  60.0f }, {  40.0f,  90.0f } } },
-        { { {  40.0f,  90.0f }, {  70.0f,  70.0f } } },
-        { { {  70.0f,  70.0f }, {  50.0f,  40.0f } } },
-        { { {  50.0f,  40.0f }, {  20.0f,  60.0f } } },
-    };
-
     Camera camera;
     BspRenderer bspr;
     //Raycaster rc;
@@ -8,6 +8,9 @@
 
 #include <math.h>
 #include "GeomUtils.hpp"
+#include "Trig.hpp"
+
+constexpr Scalar GeomUtils::fpNegligible;
 
 // follows this convention:
 //
@@ -22,7 +25,8 @@
 // camera is in "front" of the line/wall
 bool GeomUtils::IsPointInFrontOfLine(const Line& l, const Vec2& p)
 {
-    return ((p - l.p1).cross(l.p2 - l.p1) < 0);
+    // (the sign of a cross product is needed exactly, so use the version that can't overflow)
+    return ((p - l.p1).CrossWide(l.p2 - l.p1) < 0);
 }
 
 bool GeomUtils::IsLineSegInFrontOfLine(const Line& line, const Line& lineSeg)
@@ -30,20 +34,25 @@ bool GeomUtils::IsLineSegInFrontOfLine(const Line& line, const Line& lineSeg)
     return (IsPointInFrontOfLine(line, lineSeg.p1) && IsPointInFrontOfLine(line, lineSeg.p2));
 }
 
-bool GeomUtils::FindRayLineSegIntersection(const Line& ray, const Line& seg, Vec2& intersection, double& u)
+bool GeomUtils::FindRayLineSegIntersection(const Line& ray, const Line& seg, Vec2& intersection, Scalar& u)
 {
-    double dummy;
+    Scalar dummy;
     return FindRayLineSegIntersection(false, false, ray, seg, intersection, dummy, u);
 }
 
-bool GeomUtils::FindLineLineSegIntersection(const Line& line, const Line& seg, Vec2& intersection, double& t, double& u)
+bool GeomUtils::FindRayLineSegIntersection(const Line& ray, const Line& seg, Vec2& intersection, Scalar& t, Scalar& u)
+{
+    return FindRayLineSegIntersection(false, false, ray, seg, intersection, t, u);
+}
+
+bool GeomUtils::FindLineLineSegIntersection(const Line& line, const Line& seg, Vec2& intersection, Scalar& t, Scalar& u)
 {
     return FindRayLineSegIntersection(true, false, line, seg, intersection, t, u);
 }
 
-bool GeomUtils::FindRayLineIntersection(const Line& ray, const Line& line, Vec2& intersection, double& t)
+bool GeomUtils::FindRayLineIntersection(const Line& ray, const Line& line, Vec2& intersection, Scalar& t)
 {
-    double dummy;
+    Scalar dummy;
     return FindRayLineSegIntersection(false, true, ray, line, intersection, t, dummy);
 }
 
@@ -65,8 +74,8 @@ bool GeomUtils::FindLineLineIntersection(const Line& l1, const Line& l2, Vec2& i
             intersection.x = l1.p1.x;
             
             // get l2 into the form: y = m2*x + b2
-            double m2 {GetSlope(l2)};
-            double b2 {GetYIntercept(m2, l2.p1)};
+            Scalar m2 {GetSlope(l2)};
+            Scalar b2 {GetYIntercept(m2, l2.p1)};
             
             // y = mx + b for line 2
             intersection.y = m2 * intersection.x + b2;
@@ -82,8 +91,8 @@ bool GeomUtils::FindLineLineIntersection(const Line& l1, const Line& l2, Vec2& i
         intersection.x = l2.p1.x;
         
         // get l1 into the form: y = m1*x + b1
-        double m1 {GetSlope(l1)};
-        double b1 {GetYIntercept(m1, l1.p1)};
+        Scalar m1 {GetSlope(l1)};
+        Scalar b1 {GetYIntercept(m1, l1.p1)};
         
         // y = mx + b for line 1
         intersection.y = m1 * intersection.x + b1;
@@ -92,12 +101,12 @@ bool GeomUtils::FindLineLineIntersection(const Line& l1, const Line& l2, Vec2& i
     else
     {
         // get l1 into the form: y = m1*x + b1
-        double m1 {GetSlope(l1)};
-        double b1 {GetYIntercept(m1, l1.p1)};
+        Scalar m1 {GetSlope(l1)};
+        Scalar b1 {GetYIntercept(m1, l1.p1)};
         
         // get l2 into the form: y = m2*x + b2
-        double m2 {GetSlope(l2)};
-        double b2 {GetYIntercept(m2, l2.p1)};
+        Scalar m2 {GetSlope(l2)};
+        Scalar b2 {GetYIntercept(m2, l2.p1)};
         
         // parallel, possibly overlapping, lines - no clear intersection
         if (m1 == m2)
@@ -120,17 +129,39 @@ bool GeomUtils::FindLineLineIntersection(const Line& l1, const Line& l2, Vec2& i
     return intersectionFound;
 }
 
-double GeomUtils::AngleBetween(const Vec2& v1, const Vec2& v2)
+void GeomUtils::ClipRayToSlab(Scalar p, Scalar d, Scalar slabMin, Scalar slabMax, Scalar& tEnter, Scalar& tLeave)
+{
+    if (d == 0.0f)
+    {
+        if ((p < slabMin) || (p > slabMax))
+            tLeave = -1.0f;
+        return;
+    }
+
+    Scalar t1 {(slabMin - p) / d};
+    Scalar t2 {(slabMax - p) / d};
+    if (t1 > t2)
+    {
+        const Scalar t {t1};
+        t1 = t2;
+        t2 = t;
+    }
+    if (t1 > tEnter) tEnter = t1;
+    if (t2 < tLeave) tLeave = t2;
+}
+
+Scalar GeomUtils::AngleBetween(const Vec2& v1, const Vec2& v2)
 {
     // could also be asin(v1.cross(v2) / (v1.Mag() * v2.Mag()))
-    return acos((v1 * v2) / (v1.Mag() * v2.Mag()));
+    // (by table lookup - see Trig)
+    return Trig::ToScalarRadians(Trig::Acos((v1 * v2) / (v1.Mag() * v2.Mag())));
 }
 
 // a faster version of angleBetweenVectors, if the vectors have already been normalized
-double GeomUtils::AngleBetweenNorm(const Vec2& v1, const Vec2& v2)
+Scalar GeomUtils::AngleBetweenNorm(const Vec2& v1, const Vec2& v2)
 {
     // could also be asin(v1 * v2)
-    return acos(v1 * v2);
+    return Trig::ToScalarRadians(Trig::Acos(v1 * v2));
 }
 
 // finds the point of intersection of a ray (line w/ starting point and no end), starting
@@ -141,7 +172,7 @@ double GeomUtils::AngleBetweenNorm(const Vec2& v1, const Vec2& v2)
 //
 // argument "lineSegIsActuallyLine" is kind of a hack - set this to true if you actually
 // want to do a ray/line intersection instead of a ray/line segment intersection
-bool GeomUtils::FindRayLineSegIntersection(bool rayIsActuallyLine, bool lineSegIsActuallyLine, const Line& ray, const Line& seg, Vec2& intersection, double& t, double& u)
+bool GeomUtils::FindRayLineSegIntersection(bool rayIsActuallyLine, bool lineSegIsActuallyLine, const Line& ray, const Line& seg, Vec2& intersection, Scalar& t, Scalar& u)
 {
     bool intersectionFound {false};
     
@@ -157,12 +188,12 @@ bool GeomUtils::FindRayLineSegIntersection(bool rayIsActuallyLine, bool lineSegI
     // just some things that appear in both equations
     // and can be calculated just once:
     Vec2 segStartMinusRayStart {seg.p1 - ray.p1};
-    double rCrossS {r.cross(s)};
+    const Wide<Scalar>::Type rCrossS {r.CrossWide(s)};
     
     if (fabs(rCrossS) > fpNegligible)
     {
-        t = segStartMinusRayStart.cross(s) / rCrossS;
-        u = segStartMinusRayStart.cross(r) / rCrossS;
+        t = segStartMinusRayStart.CrossWide(s) / rCrossS;
+        u = segStartMinusRayStart.CrossWide(r) / rCrossS;
         
         // for a ray/line segment intersection, the following must be
         // true (see notes)
@@ -184,17 +215,17 @@ bool GeomUtils::FindRayLineSegIntersection(bool rayIsActuallyLine, bool lineSegI
     return intersectionFound;
 }
 
-double GeomUtils::GetSlope(const Vec2& a, const Vec2& b)
+Scalar GeomUtils::GetSlope(const Vec2& a, const Vec2& b)
 {
     return ((b.y - a.y) / (b.x - a.x));
 }
 
-double GeomUtils::GetSlope(const Line& l)
+Scalar GeomUtils::GetSlope(const Line& l)
 {
     return GetSlope(l.p1, l.p2);
 }
 
-double GeomUtils::GetYIntercept(double slope, const Vec2& a)
+Scalar GeomUtils::GetYIntercept(Scalar slope, const Vec2& a)
 {
     return (a.y - slope * a.x);
 }
@@ -21,23 +21,33 @@ public:
     static bool IsPointInFrontOfLine(const Line& l, const Vec2& p);
     static bool IsLineSegInFrontOfLine(const Line& line, const Line& lineSeg);
     
-    static bool FindRayLineSegIntersection(const Line& ray, const Line& seg, Vec2& intersection, double& u);
-    static bool FindLineLineSegIntersection(const Line& line, const Line& seg, Vec2& intersection, double& t, double& u);
-    static bool FindRayLineIntersection(const Line& ray, const Line& line, Vec2& intersection, double& t);
+    static bool FindRayLineSegIntersection(const Line& ray, const Line& seg, Vec2& intersection, Scalar& u);
+    // (t is how far along the ray the intersection is, as a multiple of the ray's length)
+    static bool FindRayLineSegIntersection(const Line& ray, const Line& seg, Vec2& intersection, Scalar& t, Scalar& u);
+    static bool FindLineLineSegIntersection(const Line& line, const Line& seg, Vec2& intersection, Scalar& t, Scalar& u);
+    static bool FindRayLineIntersection(const Line& ray, const Line& line, Vec2& intersection, Scalar& t);
     static bool FindLineLineIntersection(const Line& l1, const Line& l2, Vec2& intersection);
+
+    // narrows [tEnter, tLeave] to where a ray is between slabMin and slabMax along one axis (p and
+    // d are the ray's start and direction along that axis, and the t's are multiples of the ray's
+    // length) - clipping to both axes' slabs clips the ray to a box, which it misses if this
+    // leaves tEnter > tLeave
+    static void ClipRayToSlab(Scalar p, Scalar d, Scalar slabMin, Scalar slabMax, Scalar& tEnter, Scalar& tLeave);
     
-    static double AngleBetween(const Vec2& v1, const Vec2& v2);
-    static double AngleBetweenNorm(const Vec2& v1, const Vec2& v2);
+    static Scalar AngleBetween(const Vec2& v1, const Vec2& v2);
+    static Scalar AngleBetweenNorm(const Vec2& v1, const Vec2& v2);
+
+    // a "negligible" amount for floating-point values
+    // (WallSoa's kernels use this too, so that they find exactly the hits that
+    // FindRayLineSegIntersection() does)
+    static constexpr Scalar fpNegligible {0.00001f};
     
 private:
     static bool FindRayLineSegIntersection(bool rayIsActuallyLine, bool lineSegIsActuallyLine, const Line& ray,
-                                           const Line& seg, Vec2& intersection, double& t, double& u);
-    static double GetSlope(const Vec2& a, const Vec2& b);
-    static double GetSlope(const Line& l);
-    static double GetYIntercept(double slope, const Vec2& a);
-    
-    // a "negligible" amount for floating-point values
-    static constexpr double fpNegligible {0.00001f};
+                                           const Line& seg, Vec2& intersection, Scalar& t, Scalar& u);
+    static Scalar GetSlope(const Vec2& a, const Vec2& b);
+    static Scalar GetSlope(const Line& l);
+    static Scalar GetYIntercept(Scalar slope, const Vec2& a);
 };
 
 #endif /* GeomUtils_hpp */
@@ -0,0 +1,68 @@
+//
+//  OffscreenGraphics.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <cstring>
+#include <fstream>
+#include "OffscreenGraphics.hpp"
+
+constexpr uint32_t OffscreenGraphics::ScreenWidth;
+constexpr uint32_t OffscreenGraphics::ScreenHeight;
+constexpr uint32_t OffscreenGraphics::ScreenHeightPages;
+
+OffscreenGraphics::OffscreenGraphics():
+    pPixelBuf{new uint8_t[ScreenWidth * ScreenHeightPages]},
+    pColumnBuf{new uint8_t[ScreenHeightPages]},
+    currColumn{0},
+    columnsRendered{0}
+{
+    memset(pPixelBuf.get(), 0, ScreenWidth * ScreenHeightPages);
+    memset(pColumnBuf.get(), 0, ScreenHeightPages);
+}
+
+void OffscreenGraphics::EndColumn()
+{
+    for (uint32_t pageNum = 0; pageNum < ScreenHeightPages; pageNum++)
+        pPixelBuf[pageNum * ScreenWidth + currColumn] = pColumnBuf[pageNum];
+
+    if (++currColumn == ScreenWidth)
+        currColumn = 0;
+
+    columnsRendered++;
+}
+
+uint32_t OffscreenGraphics::GetScreenChecksum() const
+{
+    // FNV-1a
+    uint32_t hash {2166136261u};
+    for (uint32_t i = 0; i < ScreenWidth * ScreenHeightPages; i++)
+    {
+        hash ^= pPixelBuf[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool OffscreenGraphics::WritePbm(const std::string& fileName) const
+{
+    std::ofstream out(fileName);
+    if (!out)
+        return false;
+
+    out << "P1\n" << ScreenWidth << " " << ScreenHeight << "\n";
+    for (uint32_t y = 0; y < ScreenHeight; y++)
+    {
+        for (uint32_t x = 0; x < ScreenWidth; x++)
+        {
+            uint8_t pageData {pPixelBuf[(y / 8) * ScreenWidth + x]};
+            // (in PBM, 1 is black - lit pixels are shown as white, like on the display)
+            out << (((pageData >> (y % 8)) & 0x01) ? '0' : '1');
+        }
+        out << "\n";
+    }
+
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,53 @@
+//
+//  OffscreenGraphics.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef OffscreenGraphics_hpp
+#define OffscreenGraphics_hpp
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// this class stands in for the SDLSim Graphics class (and so for the SSD1306 display) in builds
+// that have no window - it accepts columns in the same vertical-addressing-mode column buffer,
+// but just collects them into an in-memory frame buffer, so the renderers can be driven at full
+// speed and their output can still be inspected
+//
+// the frame buffer is arranged as in SSD1306 horizontal addressing mode (see Graphics.hpp)
+class OffscreenGraphics
+{
+public:
+    OffscreenGraphics();
+    OffscreenGraphics(const OffscreenGraphics&) = delete;
+    OffscreenGraphics& operator=(const OffscreenGraphics&) = delete;
+    ~OffscreenGraphics() = default;
+
+    void EndColumn();
+    uint8_t* GetColumnBuffer() { return pColumnBuf.get(); }
+    const uint8_t* GetScreenBuffer() const { return pPixelBuf.get(); }
+
+    // total number of columns received so far
+    uint64_t GetColumnsRendered() const { return columnsRendered; }
+
+    // a cheap hash of the frame buffer contents, for comparing output between builds/runs
+    uint32_t GetScreenChecksum() const;
+
+    // writes the frame buffer out as a (plain text) PBM image
+    bool WritePbm(const std::string& fileName) const;
+
+    static constexpr uint32_t ScreenWidth {128u};
+    static constexpr uint32_t ScreenHeight {64u};
+    static constexpr uint32_t ScreenHeightPages {ScreenHeight/8};
+
+private:
+    std::unique_ptr<uint8_t[]> pPixelBuf;
+    std::unique_ptr<uint8_t[]> pColumnBuf;
+    uint32_t currColumn;
+    uint64_t columnsRendered;
+};
+
+#endif /* OffscreenGraphics_hpp */
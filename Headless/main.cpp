@@ -0,0 +1,94 @@
+//
+//  main.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+// runs the game without a window or any input, with the camera following a fixed,
+// scripted path, as fast as possible
+//
+// usage: walls3duino_headless [--frames N] [--checksums] [--pbm file]
+//   --frames N   number of frames to render (default 1000)
+//   --checksums  print a checksum of every rendered frame (for comparing builds)
+//   --pbm file   save the last rendered frame as a PBM image
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "Game.hpp"
+#include "OffscreenGraphics.hpp"
+
+OffscreenGraphics graphics;
+
+void OnColRendered();
+
+int main(int argc, const char * argv[])
+{
+    uint32_t numFrames {1000};
+    bool printChecksums {false};
+    std::string pbmFileName;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--frames") && (i + 1 < argc))
+            numFrames = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (!strcmp(argv[i], "--checksums"))
+            printChecksums = true;
+        else if (!strcmp(argv[i], "--pbm") && (i + 1 < argc))
+            pbmFileName = argv[++i];
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--frames N] [--checksums] [--pbm file]" << std::endl;
+            return 1;
+        }
+    }
+
+    Game game(graphics.GetColumnBuffer(), graphics.ScreenWidth, graphics.ScreenHeight, OnColRendered);
+
+    // the scripted "input" - turn slowly all the way around, while walking back and forth
+    constexpr uint32_t FramesPerTurn {360};
+    constexpr uint32_t FramesPerWalk {20};
+    const double rotSpeed {2.0f * M_PI / FramesPerTurn};
+    const double moveSpeed {0.5f};
+
+    std::chrono::steady_clock::time_point start {std::chrono::steady_clock::now()};
+
+    for (uint32_t frame = 0; frame < numFrames; frame++)
+    {
+        game.ProcessFrame();
+
+        if (printChecksums)
+            std::cout << "frame " << frame << ": " << std::hex << graphics.GetScreenChecksum() << std::dec << std::endl;
+
+        game.RotateCamera(rotSpeed);
+        game.MoveCamera(((frame / FramesPerWalk) % 2 == 0) ? moveSpeed : -moveSpeed);
+    }
+
+    std::chrono::duration<double> elapsed {std::chrono::steady_clock::now() - start};
+
+    std::cout << "frames: " << numFrames << std::endl;
+    std::cout << "columns: " << graphics.GetColumnsRendered() << std::endl;
+    std::cout << "total time: " << elapsed.count() * 1000.0f << " ms" << std::endl;
+    if (numFrames > 0)
+    {
+        std::cout << "frame time: " << elapsed.count() * 1000000.0f / numFrames << " us/frame" << std::endl;
+        std::cout << "FPS: " << numFrames / elapsed.count() << " frames/s" << std::endl;
+    }
+    std::cout << "last frame checksum: " << std::hex << graphics.GetScreenChecksum() << std::dec << std::endl;
+
+    if (!pbmFileName.empty() && !graphics.WritePbm(pbmFileName))
+    {
+        std::cerr << "could not write " << pbmFileName << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void OnColRendered()
+{
+    graphics.EndColumn();
+}
@@ -12,49 +12,52 @@
 #include "Vec2.hpp"
 #include "Serializer.hpp"
 
-class Line
+template<typename T>
+class _Line
 {
 public:
-    constexpr Line():
+    constexpr _Line():
         p1{0.0f, 0.0f},
         p2{0.0f, 0.0f}
     {
     }
-    constexpr Line(const Vec2& p1, const Vec2& p2):
+    constexpr _Line(const _Vec2<T>& p1, const _Vec2<T>& p2):
         p1{p1},
         p2{p2}
     {
     }
-    Line(const uint8_t* bytes, size_t& offset):
-        p1{Serializer::DeSerDouble(bytes, offset), Serializer::DeSerDouble(bytes, offset)},
-        p2{Serializer::DeSerDouble(bytes, offset), Serializer::DeSerDouble(bytes, offset)}
+    _Line(const uint8_t* bytes, size_t& offset):
+        p1{static_cast<T>(Serializer::DeSerFixed(bytes, offset)), static_cast<T>(Serializer::DeSerFixed(bytes, offset))},
+        p2{static_cast<T>(Serializer::DeSerFixed(bytes, offset)), static_cast<T>(Serializer::DeSerFixed(bytes, offset))}
     {
     }
-    Line operator+(const Vec2& rhs) const
+    _Line operator+(const _Vec2<T>& rhs) const
     {
         return {p1 + rhs, p2 + rhs};
     }
-    Line& operator+=(const Vec2& rhs)
+    _Line& operator+=(const _Vec2<T>& rhs)
     {
         *this = *this + rhs;
         return *this;
     }
-    Line operator-(const Vec2& rhs) const
+    _Line operator-(const _Vec2<T>& rhs) const
     {
         return {p1 - rhs, p2 - rhs};
     }
-    Line& operator-=(const Vec2& rhs)
+    _Line& operator-=(const _Vec2<T>& rhs)
     {
         *this = *this - rhs;
         return *this;
     }
-    double Mag() const
+    T Mag() const
     {
         return ((p2 - p1).Mag());
     }
     
-    Vec2 p1;
-    Vec2 p2;
+    _Vec2<T> p1;
+    _Vec2<T> p2;
 };
 
+typedef _Line<Scalar> Line;
+
 #endif /* Line_hpp */
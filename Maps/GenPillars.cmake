@@ -0,0 +1,29 @@
+# writes a map like pillars.txt, but with any number of pillars - for benchmarks that need maps
+# too big to keep in the repository (e.g. for load times)
+#
+# usage: cmake -DCOUNT=N -DOUT=file -P GenPillars.cmake
+#   (a COUNT x COUNT grid of square pillars in a square room, so 4 * COUNT * COUNT + 4 walls)
+
+if(NOT COUNT OR NOT OUT)
+    message(FATAL_ERROR "usage: cmake -DCOUNT=N -DOUT=file -P GenPillars.cmake")
+endif()
+
+# (the same spacing and sizes as pillars.txt, which is the COUNT=16 map)
+math(EXPR ROOM_SIZE "${COUNT} * 24 + 16")
+math(EXPR NUM_WALLS "4 * ${COUNT} * ${COUNT} + 4")
+set(TEXT "# x1 y1 x2 y2 (the front of each wall is to the right, looking from p1 to p2)\n")
+string(APPEND TEXT "# a ${COUNT} x ${COUNT} grid of square pillars in a square room - ${NUM_WALLS} walls (see GenPillars.cmake)\n")
+string(APPEND TEXT "0 0 ${ROOM_SIZE} 0\n${ROOM_SIZE} 0 ${ROOM_SIZE} ${ROOM_SIZE}\n${ROOM_SIZE} ${ROOM_SIZE} 0 ${ROOM_SIZE}\n0 ${ROOM_SIZE} 0 0\n")
+
+math(EXPR LAST "${COUNT} - 1")
+foreach(COL RANGE ${LAST})
+    math(EXPR X1 "${COL} * 24 + 14")
+    math(EXPR X2 "${X1} + 8")
+    foreach(ROW RANGE ${LAST})
+        math(EXPR Y1 "${ROW} * 24 + 14")
+        math(EXPR Y2 "${Y1} + 8")
+        string(APPEND TEXT "${X1} ${Y1} ${X1} ${Y2}\n${X1} ${Y2} ${X2} ${Y2}\n${X2} ${Y2} ${X2} ${Y1}\n${X2} ${Y1} ${X1} ${Y1}\n")
+    endforeach()
+endforeach()
+
+file(WRITE ${OUT} "${TEXT}")
@@ -10,21 +10,26 @@
 #define Mat2_hpp
 
 #include <stdio.h>
+#include <math.h>
+#include "Vec2.hpp"
+#include "Trig.hpp"
 
 template<typename T>
 class _Mat2
 {
 public:
     _Mat2() = default;
-    _Mat2<T> operator+(const _Mat2<T>& rhs)
+    _Mat2<T> operator+(const _Mat2<T>& rhs) const
     {
+        _Mat2<T> ret;
         for (size_t i {0}; i < 2; i++)
         {
             for (size_t j {0}; j < 2; j++)
             {
-                data[i][j] += rhs[i][j];
+                ret.data[i][j] = data[i][j] + rhs.data[i][j];
             }
         }
+        return ret;
     }
     _Mat2<T>& operator+=(const _Vec2<T>& rhs)
     {
@@ -57,10 +62,10 @@ public:
             z, o
         };
     }
-    static _Mat2<T> Rot(T angle)
+    static _Mat2<T> Rot(Trig::Angle angle)
     {
-        T s {static_cast<T>(sin(angle))};
-        T c {static_cast<T>(cos(angle))};
+        T s {static_cast<T>(Trig::Sin(angle))};
+        T c {static_cast<T>(Trig::Cos(angle))};
         return
         {
              c, s,
@@ -77,6 +82,11 @@ public:
     T data[2][2];
 };
 
+template<typename T>
+constexpr T _Mat2<T>::z;
+template<typename T>
+constexpr T _Mat2<T>::o;
+
 template<typename T>
 _Vec2<T> operator*(const _Vec2<T>& lhs, const _Mat2<T>& rhs)
 {
@@ -93,6 +103,6 @@ _Vec2<T>& operator*=(_Vec2<T>& lhs, const _Mat2<T>& rhs)
     return lhs;
 }
 
-typedef _Mat2<double> Mat2;
+typedef _Mat2<Scalar> Mat2;
 
 #endif /* Mat2_hpp */
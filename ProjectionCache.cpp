@@ -0,0 +1,97 @@
+//
+//  ProjectionCache.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <string.h>
+#include "ProjectionCache.hpp"
+
+constexpr Scalar ProjectionCache::nearPlaneDist;
+
+ProjectionCache::ProjectionCache(const Camera& camera, uint8_t screenWidth):
+    camera{camera},
+    screenWidth{screenWidth},
+    screenXScale{camera.viewPlaneDist / (camera.viewPlaneWidth / 2.0f) * static_cast<Scalar>(screenWidth / 2)},
+    pProjections{nullptr},
+    pValidBits{nullptr},
+    pOnScreenBits{nullptr},
+    numVertices{0},
+    cameraGeneration{camera.GetGeneration()}
+#ifdef SDLSim
+    , numHits{0},
+    numMisses{0}
+#endif
+{
+}
+
+ProjectionCache::~ProjectionCache()
+{
+    delete[] pProjections;
+    delete[] pValidBits;
+    delete[] pOnScreenBits;
+}
+
+void ProjectionCache::SetNumVertices(size_t newNumVertices)
+{
+    delete[] pProjections;
+    delete[] pValidBits;
+    delete[] pOnScreenBits;
+    numVertices = newNumVertices;
+    pProjections = new Projection[numVertices];
+    pValidBits = new uint8_t[(numVertices + 7) / 8];
+    pOnScreenBits = new uint8_t[(numVertices + 7) / 8];
+    memset(pValidBits, 0, (numVertices + 7) / 8);
+}
+
+void ProjectionCache::BeginFrame()
+{
+    if (camera.GetGeneration() != cameraGeneration)
+    {
+        memset(pValidBits, 0, (numVertices + 7) / 8);
+        cameraGeneration = camera.GetGeneration();
+    }
+
+#ifdef SDLSim
+    numHits = 0;
+    numMisses = 0;
+#endif
+}
+
+Wide<Scalar>::Type ProjectionCache::GetDistInsideFovEdge(bool leftEdge, const Vec2& viewP) const
+{
+    // the edges go through the camera and the ends of the view plane, i.e. the points
+    // (-viewPlaneWidth/2, viewPlaneDist) and (viewPlaneWidth/2, viewPlaneDist)
+    Wide<Scalar>::Type x {Wide<Scalar>::Mul(viewP.x, camera.viewPlaneDist)};
+    Wide<Scalar>::Type y {Wide<Scalar>::Mul(viewP.y, camera.viewPlaneWidth / 2.0f)};
+    return (leftEdge ? (y + x) : (y - x));
+}
+
+uint8_t ProjectionCache::GetScreenX(const Vec2& viewP) const
+{
+    // (the point must be in the field of view, so its y is positive and the result is in range)
+    int16_t screenX {static_cast<int16_t>(Wide<Scalar>::Mul(viewP.x, screenXScale) / static_cast<Wide<Scalar>::Type>(viewP.y))};
+    screenX += screenWidth / 2;
+
+    // (a point exactly on the right edge of the field of view would be one column past the screen)
+    if (screenX < 0) screenX = 0;
+    if (screenX > screenWidth - 1) screenX = screenWidth - 1;
+    return static_cast<uint8_t>(screenX);
+}
+
+bool ProjectionCache::Project(const Vec2& p, Projection& projection) const
+{
+    // all of the projection is done in the camera's space, where a point's y is its perpendicular
+    // distance from the camera, and the ratio of its x to its y gives its screen x - this needs no
+    // trig functions or square roots, and only one division per point
+    const Vec2 viewP {camera.ToViewSpace(p)};
+    if ((viewP.y < nearPlaneDist) ||
+        (GetDistInsideFovEdge(true, viewP) < 0) ||
+        (GetDistInsideFovEdge(false, viewP) < 0))
+        return false;
+
+    projection.depth = viewP.y;
+    projection.screenX = GetScreenX(viewP);
+    return true;
+}
@@ -0,0 +1,104 @@
+//
+//  ProjectionCache.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef ProjectionCache_hpp
+#define ProjectionCache_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include "BspTree.hpp"
+#include "Camera.hpp"
+#include "Fixed.hpp"
+
+// remembers where each of a map's vertices ends up on the screen, so that a vertex shared by
+// several walls (e.g. every corner of a closed room) is only projected once
+//
+// entries stay valid for as long as the camera doesn't move - the camera bumps its generation
+// counter whenever it moves or turns, and BeginFrame() throws everything away if that has
+// changed since the last frame (so a still camera reuses the last frame's projections, too)
+class ProjectionCache
+{
+public:
+    // (only for a vertex that is on screen - the rest aren't worth the RAM, since a wall that
+    // needs clipping needs its end points in view space anyway, see Camera::ToViewSpace())
+    class Projection
+    {
+    public:
+        Scalar depth;    // the vertex's perpendicular distance from the camera (its y in view space)
+        uint8_t screenX;
+    };
+
+    ProjectionCache(const Camera& camera, uint8_t screenWidth);
+    ~ProjectionCache();
+
+    // (this empties the cache)
+    void SetNumVertices(size_t numVertices);
+
+    void BeginFrame();
+
+    // returns null if the vertex isn't in the field of view, or is too close to the camera
+    // (the vertex is only read from the tree if it isn't already in the cache, which saves
+    // decoding it for a tree that is used in place - see BspTree::MapBin())
+    const Projection* Get(BspTree::VertexIdx vertexIdx, const BspTree& bspTree)
+    {
+        const size_t byteIdx {static_cast<size_t>(vertexIdx >> 3)};
+        const uint8_t bit {static_cast<uint8_t>(1 << (vertexIdx & 0x07))};
+        const bool isValid {(pValidBits[byteIdx] & bit) != 0};
+#ifdef SDLSim
+        (isValid ? numHits : numMisses)++;
+#endif
+        if (!isValid)
+        {
+            if (Project(bspTree.GetVertex(vertexIdx), pProjections[vertexIdx]))
+                pOnScreenBits[byteIdx] |= bit;
+            else
+                pOnScreenBits[byteIdx] &= static_cast<uint8_t>(~bit);
+            pValidBits[byteIdx] |= bit;
+        }
+        return (((pOnScreenBits[byteIdx] & bit) != 0) ? &pProjections[vertexIdx] : nullptr);
+    }
+
+    // a (scaled) distance of a view space point from the left or right edge of the field of view -
+    // positive on the inside of the edge, and negative on the outside
+    Wide<Scalar>::Type GetDistInsideFovEdge(bool leftEdge, const Vec2& viewP) const;
+    // (the point must be in the field of view)
+    uint8_t GetScreenX(const Vec2& viewP) const;
+
+#ifdef SDLSim
+    // since the last BeginFrame()
+    uint32_t GetNumHits() const { return numHits; }
+    uint32_t GetNumMisses() const { return numMisses; }
+#endif
+
+    // points closer than this to the camera are not projected (they would blow up the
+    // projection), and walls must be clipped to this distance in front of the camera
+    static constexpr Scalar nearPlaneDist {0.05f};
+
+private:
+    // (returns whether the vertex is on screen - the projection is left alone if it isn't)
+    bool Project(const Vec2& p, Projection& projection) const;
+
+    const Camera& camera;
+    const uint8_t screenWidth;
+
+    // multiplying the ratio of a point's x and y in view space (i.e. the tangent of its angle
+    // from the view direction) by this gives its screen x relative to the middle of the screen
+    const Scalar screenXScale;
+
+    Projection* pProjections;
+    uint8_t* pValidBits;    // one bit per vertex
+    uint8_t* pOnScreenBits; // (likewise - only meaningful for valid vertices)
+    size_t numVertices;
+    uint16_t cameraGeneration; // of the projections in the cache
+
+#ifdef SDLSim
+    uint32_t numHits;
+    uint32_t numMisses;
+#endif
+};
+
+#endif /* ProjectionCache_hpp */
@@ -9,7 +9,7 @@
 #include "Raycaster.hpp"
 #include "GeomUtils.hpp"
 
-constexpr double Raycaster::infinity;
+constexpr Scalar Raycaster::infinity;
 
 Raycaster::Raycaster(uint8_t* pPixelBuf,
                      uint8_t screenWidth,
@@ -17,10 +17,34 @@ Raycaster::Raycaster(uint8_t* pPixelBuf,
                      ColRenderedCbType colRenderedCb,
                      const Camera& camera,
                      const Wall walls[],
-                     size_t numWalls):
+                     size_t numWalls,
+                     Search search):
     Renderer(pPixelBuf, screenWidth, screenHeight, colRenderedCb, camera),
     walls{walls},
-    numWalls{numWalls}
+    numWalls{numWalls},
+    pBspTree{nullptr},
+    search{search}
+{
+    if (search == Search::Grid)
+        grid.Build(walls, numWalls);
+    else if (search == Search::Bvh)
+        bvh.Build(walls, numWalls);
+#ifdef SimdWallKernels
+    soa.Build(walls, numWalls);
+#endif
+}
+
+Raycaster::Raycaster(uint8_t* pPixelBuf,
+                     uint8_t screenWidth,
+                     uint8_t screenHeight,
+                     ColRenderedCbType colRenderedCb,
+                     const Camera& camera,
+                     const BspTree& bspTree):
+    Renderer(pPixelBuf, screenWidth, screenHeight, colRenderedCb, camera),
+    walls{nullptr},
+    numWalls{0},
+    pBspTree{&bspTree},
+    search{Search::BspTree}
 {
 }
 
@@ -28,75 +52,165 @@ void Raycaster::RenderScene()
 {
     BeginRender();
     
-    // -1 to 1 as we draw across the screen
-    double percentWidth {-1.0f};
-    const double percentWidthIncrement {2.0f / screenWidth};
-    
+    // each column's ray goes from the camera through a point on the view plane, evenly spaced
+    // from the view plane's left edge to its right edge
+    // (the point's offset from the middle of the view plane is stepped along from column to
+    // column, rather than multiplied out - it is kept with twice the precision of a Scalar, so that
+    // the steps are exact in fixed point, and rounding doesn't add up across the screen)
+    const Scalar percentWidthIncrement {2.0f / screenWidth};
+    Wide<Scalar>::Type offsetX {-Wide<Scalar>::Mul(camera.halfViewPlane.x, 1.0f)};
+    Wide<Scalar>::Type offsetY {-Wide<Scalar>::Mul(camera.halfViewPlane.y, 1.0f)};
+    const Wide<Scalar>::Type stepX {Wide<Scalar>::Mul(camera.halfViewPlane.x, percentWidthIncrement)};
+    const Wide<Scalar>::Type stepY {Wide<Scalar>::Mul(camera.halfViewPlane.y, percentWidthIncrement)};
+
+    // every ray's length along the view direction - nominally the view plane's distance, but the
+    // direction is built from table trig, so it is measured rather than assumed
+    const Scalar rayDepth {camera.dir.Mag()};
+
     // loop through columns on the screen
     for (uint8_t column {0}; column < screenWidth; column++)
     {
-        // for this current column, figure out the corresponding point
-        // on the view plane
-        // TODO: optimize performance - don't have to do multiplication here every pass through loop
-        Vec2 vectorToRayPoint {camera.halfViewPlane * percentWidth};
-        Vec2 viewPlanePoint {camera.viewPlaneMiddle + vectorToRayPoint};
-
-        Line ray {camera.location, viewPlanePoint};
+        const Line ray {camera.location, camera.viewPlaneMiddle + Vec2(Wide<Scalar>::Narrow(offsetX), Wide<Scalar>::Narrow(offsetY))};
         
-        // find intersections with all walls, and find the closest wall
-        const Wall* closestWallPtr {nullptr};
-        double closestWallDistance {infinity};
-        Vec2 closestWallIntersection;
-
-        for (size_t i {0}; i < numWalls; i++)
+        // find intersections with the walls, and find the closest wall
+        Hit closest {false, infinity};
+        if (search == Search::Grid)
         {
-            const Wall& wall = walls[i];
-            
-            Vec2 intersection;
-            double u;
-            if (GeomUtils::FindRayLineSegIntersection(ray, wall.seg, intersection, u))
+            // the grid's cells are walked nearest first, so once a wall is hit within the current
+            // cell, nothing in the cells beyond it can be closer
+            grid.WalkRay(ray, [this, &ray, &closest](const WallGrid::WallIdx* wallIdxs, uint16_t numCellWalls, Scalar exitT)
+            {
+                TestWalls(ray, wallIdxs, numCellWalls, closest);
+                return (!closest.isHit || (exitT < closest.t));
+            });
+        }
+        else if (search == Search::Bvh)
+        {
+            // the boxes past the closest wall hit so far are skipped
+            bvh.WalkRay(ray, infinity, [this, &ray, &closest](const WallBvh::WallIdx* wallIdxs, uint16_t numLeafWalls)
+            {
+                TestWalls(ray, wallIdxs, numLeafWalls, closest);
+                return closest.t;
+            });
+        }
+        else if (search == Search::BspTree)
+        {
+            // (as for the BVH - the walls near the camera come first, so most of the tree is
+            // skipped once one of them is hit)
+            pBspTree->TraverseRay(ray, infinity, [this, &ray, &closest](BspTree::VertexIdx p1Idx, BspTree::VertexIdx p2Idx)
             {
-                double distanceToIntersection {GetPerpendicularDistanceFromCamera(intersection, percentWidth)};
-                
-                // draw this wall intersection only if it is closer than any other
-                // wall intersections drawn so far
-                // (prevent overdrawing)
-                // (this method works because all walls are the same height, and
-                // closer walls will always obscure farther walls entirely)
-                if (distanceToIntersection < closestWallDistance)
-                {
-                    // save off information for this particular (closest) wall intersection
-                    closestWallDistance = distanceToIntersection;
-                    closestWallPtr = &wall;
-                    closestWallIntersection = intersection;
-                }
-            }
+                TestWall(ray, {pBspTree->GetVertex(p1Idx), pBspTree->GetVertex(p2Idx)}, closest);
+                return closest.t;
+            });
+#ifdef SDLSim
+            stats.nodesVisited += pBspTree->GetNumNodesVisited();
+#endif
         }
+        else
+            TestWalls(ray, nullptr, numWalls, closest);
 
-        // draw the closest wall
-        if (closestWallPtr)
+        // draw the closest wall - its distance from the camera, perpendicular to the view plane
+        // (rather than the real distance, which would give a fisheye effect), is just how far
+        // along the ray it is, times the ray's length along the view direction
+        if (closest.isHit)
+        {
             RenderColumn(column,
-                         GetClippedHeight(GetColumnHeightByDistance(closestWallDistance)));
+                         GetClippedHeight(GetColumnHeightByDistance(closest.t * rayDepth)));
+#ifdef SDLSim
+            stats.columnsFilled++;
+#endif
+        }
         // (this allows us to not have to spend time clearing the screen on every frame,
         // and have dithering be consistent from frame to frame)
         else
             RenderColumn(column, 0);
         
-        percentWidth += percentWidthIncrement;
+        offsetX = offsetX + stepX;
+        offsetY = offsetY + stepY;
     }
     
     EndRender();
 }
 
-double Raycaster::GetPerpendicularDistanceFromCamera(const Vec2& point, double percentWidth)
+void Raycaster::LoadBvhBin(const uint8_t* bytes)
 {
-    // see my notebook notes for the math here
-    // this "perpendicular distance" equation prevents the fisheye effect that
-    // would be seen with the Euclidean (real) distance
-    
-    Vec2 cameraToIntersection {point - camera.location};
-    double opp {percentWidth * camera.viewPlaneWidth / 2.0f};
-    double adj {camera.viewPlaneDist};
-    double ratio {opp / adj};
-    return sqrt((cameraToIntersection.x * cameraToIntersection.x + cameraToIntersection.y * cameraToIntersection.y) / (1 + ratio * ratio));
+    bvh.LoadBin(bytes, numWalls);
+}
+
+bool Raycaster::IsPathClear(const Vec2& from, const Vec2& to) const
+{
+    const Line path {from, to};
+    if (search == Search::Bvh)
+        return !bvh.HasAnyHit(walls, path);
+    if (search == Search::BspTree)
+    {
+        bool isHit {false};
+        pBspTree->TraverseRay(path, 1.0f, [this, &path, &isHit](BspTree::VertexIdx p1Idx, BspTree::VertexIdx p2Idx)
+        {
+            Vec2 intersection;
+            Scalar t, u;
+            isHit = (GeomUtils::FindRayLineSegIntersection(path, {pBspTree->GetVertex(p1Idx), pBspTree->GetVertex(p2Idx)}, intersection, t, u) &&
+                     (t <= 1.0f));
+            return (isHit ? -1.0f : 1.0f);
+        });
+        return !isHit;
+    }
+
+    bool isHit {false};
+    auto testWalls = [this, &path, &isHit](const uint16_t* wallIdxs, size_t numTestWalls)
+    {
+        for (size_t i {0}; (i < numTestWalls) && !isHit; i++)
+        {
+            Vec2 intersection;
+            Scalar t, u;
+            isHit = (GeomUtils::FindRayLineSegIntersection(path, walls[wallIdxs ? wallIdxs[i] : i].seg, intersection, t, u) &&
+                     (t <= 1.0f));
+        }
+    };
+    if (search == Search::Grid)
+    {
+        // (the walk stops at the end of the path, or at the first cell with a wall across it)
+        grid.WalkRay(path, [&testWalls, &isHit](const WallGrid::WallIdx* wallIdxs, uint16_t numCellWalls, Scalar exitT)
+        {
+            testWalls(wallIdxs, numCellWalls);
+            return (!isHit && (exitT < 1.0f));
+        });
+    }
+    else
+        testWalls(nullptr, numWalls);
+    return !isHit;
+}
+
+void Raycaster::TestWall(const Line& ray, const Line& wall, Hit& closest)
+{
+#ifdef SDLSim
+    stats.wallsVisited++;
+#endif
+
+    Vec2 intersection;
+    Scalar t, u;
+    // (this method works because all walls are the same height, and
+    // closer walls will always obscure farther walls entirely)
+    if (GeomUtils::FindRayLineSegIntersection(ray, wall, intersection, t, u) && (t < closest.t))
+        closest = {true, t};
+}
+
+void Raycaster::TestWalls(const Line& ray, const uint16_t* wallIdxs, size_t count, Hit& closest)
+{
+#ifdef SimdWallKernels
+    // (the store is empty if the map has too many walls for it, and then the walls are tested one
+    // at a time, as without SIMD)
+    if (soa.GetNumWalls() > 0)
+    {
+#ifdef SDLSim
+        stats.wallsVisited += count;
+#endif
+        WallSoa::WallIdx wallIdx;
+        if (soa.FindClosestHit(ray, wallIdxs, count, closest.t, wallIdx))
+            closest.isHit = true;
+        return;
+    }
+#endif
+    for (size_t i {0}; i < count; i++)
+        TestWall(ray, walls[wallIdxs ? wallIdxs[i] : i].seg, closest);
 }
@@ -10,28 +10,77 @@
 #define Raycaster_hpp
 
 #include "Renderer.hpp"
+#include "BspTree.hpp"
+#include "WallBvh.hpp"
+#include "WallGrid.hpp"
+#include "WallSoa.hpp"
 
 class Raycaster : public Renderer
 {
 public:
+    // how each ray finds the walls it might hit
+    enum class Search : uint8_t
+    {
+        AllWalls, // every ray is tested against every wall
+        Grid,     // only the walls in the grid cells along the ray (see WallGrid)
+        Bvh,      // only the walls in the boxes that the ray passes through (see WallBvh)
+        BspTree   // the walls of a BSP tree, nearest first (see BspTree::TraverseRay())
+    };
+
+    // (the grid or BVH is built here, once, and the walls must stay as they are for as long as
+    // the raycaster is used)
     Raycaster(uint8_t* pPixelBuf,
               uint8_t screenWidth,
               uint8_t screenHeight,
               ColRenderedCbType colRenderedCb,
               const Camera& camera,
               const Wall walls[],
-              size_t numWalls);
+              size_t numWalls,
+              Search search = Search::Grid);
+    // renders the walls of a BSP tree (Search::BspTree), e.g. the one that a BspRenderer has
+    // loaded, so that both renderers can share one map - the tree must stay loaded for as long
+    // as the raycaster is used
+    Raycaster(uint8_t* pPixelBuf,
+              uint8_t screenWidth,
+              uint8_t screenHeight,
+              ColRenderedCbType colRenderedCb,
+              const Camera& camera,
+              const BspTree& bspTree);
     ~Raycaster() = default;
 
     void RenderScene() override;
 
+    // replaces the BVH built for Search::Bvh with one that was built offline (see WallBvh::LoadBin())
+    void LoadBvhBin(const uint8_t* bytes);
+
+    // whether there is no wall between two points (e.g. for line of sight, or collision with
+    // the walls when moving from one to the other)
+    bool IsPathClear(const Vec2& from, const Vec2& to) const;
+
 private:
-    double GetPerpendicularDistanceFromCamera(const Vec2& point, double percentWidth);
+    class Hit
+    {
+    public:
+        bool isHit;
+        Scalar t; // (how far along the ray, as for GeomUtils::FindRayLineSegIntersection())
+    };
+
+    void TestWall(const Line& ray, const Line& wall, Hit& closest);
+    // (wallIdxs[0] up to wallIdxs[count], or the first count walls if wallIdxs is null)
+    void TestWalls(const Line& ray, const uint16_t* wallIdxs, size_t count, Hit& closest);
     
     const Wall* walls;
     size_t numWalls;
+    const BspTree* pBspTree;
+    const Search search;
+    WallGrid grid;
+    WallBvh bvh;
+#ifdef SimdWallKernels
+    // (a copy of the walls that TestWalls() can test a few at a time)
+    WallSoa soa;
+#endif
     
-    static constexpr double infinity {99999999999.9f};
+    static constexpr Scalar infinity {ScalarMax};
 };
 
 #endif /* Raycaster_hpp */
@@ -8,6 +8,7 @@
 
 #include <string.h>
 #include "Renderer.hpp"
+#include "ColumnRasterizer.hpp"
 #include "GeomUtils.hpp"
 #include "Utils.hpp"
 
@@ -24,34 +25,36 @@ Renderer::Renderer(uint8_t* pPixelBuf,
     colRenderedCb{colRenderedCb},
     camera{camera}
 {
+#ifdef SDLSim
+    for (uint16_t screenX = 0; screenX < sizeof(columnHeights); screenX++)
+        columnHeights[screenX] = 0;
+#endif
 }
 
 void Renderer::BeginRender()
 {
+#ifdef SDLSim
+    stats = {};
+#endif
 }
 
 void Renderer::EndRender()
 {
 }
 
-double Renderer::GetColumnHeightByDistance(double dist)
+Scalar Renderer::GetColumnHeightByDistance(Scalar dist)
 {
-    return (30.0f / dist * static_cast<double>(screenHeight));
+    // (a single division, so that fixed point can't overflow on an intermediate result)
+    return (static_cast<Scalar>(30 * screenHeight) / dist);
 }
 
 void Renderer::RenderColumn(uint32_t screenX, uint8_t height)
 {
-    double y1Float {static_cast<double>(screenHeight / 2) - (height / 2)};
+    Scalar y1Float {static_cast<Scalar>(screenHeight / 2) - (height / 2)};
     
     uint8_t y1 {static_cast<uint8_t>(Rast(y1Float))};
     uint8_t y2 {static_cast<uint8_t>(Rast(y1Float + height))};
     
-    // figure out where in the pixel buffer to start, and only do
-    // additions from there (avoid multiplication in the drawing loop)
-    size_t pixelBufferOffset = 0;
-    
-    // draw a vertical line all the way through the column
-    
     uint8_t ditherPatternIndex = (8 * height / screenHeight);
     if (ditherPatternIndex > 7) ditherPatternIndex = 7;
     static uint8_t ditherPatternOffset = 0;
@@ -60,43 +63,25 @@ void Renderer::RenderColumn(uint32_t screenX, uint8_t height)
     uint8_t ditherPatternFinal = ditherPattern16 >> (ditherPatternOffset % 8);
     ditherPatternOffset += 5; // a weird odd/prime number here that doesn't easily match up with 8 makes for less pattern-y artifacts
     
-    uint8_t pixel;
-    uint8_t y = 0;
-    uint8_t screenHeightPages = screenHeight / 8;
-    for (uint8_t pageNum = 0; pageNum < screenHeightPages; pageNum++)
-    {
-        uint8_t pageData = 0;
-        for (uint8_t i = 0; i < 8; i++)
-        {
-            if (y >= y1 && y < y2)
-                pixel = 1;
-            else
-                pixel = 0;
-            
-            pageData |= (pixel << i);
-            
-            y++;
-        }
-        
-        pageData &= ditherPatternFinal;
-        pPixelBuf[pixelBufferOffset] = pageData;
-        
-        pixelBufferOffset++;
-    }
+    // draw a vertical line all the way through the column
+    ColumnRasterizer::Rasterize(pPixelBuf, screenHeight / 8, y1, y2, ditherPatternFinal);
+#ifdef SDLSim
+    columnHeights[static_cast<uint8_t>(screenX)] = height;
+#endif
     
     colRenderedCb();
 }
 
 // maps a range of [0.0, 1.0] to [0, rangeHigh]
 // clamps at rangeHigh to account for floating point error
-uint32_t Renderer::MapPercentageToRange(double percentage, uint32_t rangeHigh)
+uint32_t Renderer::MapPercentageToRange(Scalar percentage, uint32_t rangeHigh)
 {
-    uint32_t retVal {static_cast<uint32_t>(percentage * static_cast<double>(rangeHigh + 1))};
+    uint32_t retVal {static_cast<uint32_t>(percentage * static_cast<Scalar>(rangeHigh + 1))};
     if (retVal > rangeHigh) retVal = rangeHigh;
     return retVal;
 }
 
-uint8_t Renderer::GetClippedHeight(double height)
+uint8_t Renderer::GetClippedHeight(Scalar height)
 {
     return static_cast<uint8_t>(Rast(height < screenHeight ? height : screenHeight));
 }
@@ -30,17 +30,36 @@ public:
     
     virtual void RenderScene() = 0;
 
+#ifdef SDLSim
+    // counters describing the work done for the last frame, for profiling
+    // (PC builds only - there is no RAM to spare for this on the embedded hardware)
+    class Stats
+    {
+    public:
+        uint32_t nodesVisited;  // BSP tree nodes visited (including ones whose subtrees were culled)
+        uint32_t wallsVisited;  // walls considered for rendering (or tested against rays)
+        uint32_t columnsFilled; // columns in which a wall was found
+        uint32_t projectionsCached;   // wall end points found in the projection cache
+        uint32_t projectionsComputed; // ... and those that weren't (see ProjectionCache)
+    };
+    const Stats& GetStats() const { return stats; }
+
+    // the height of the wall drawn in each column in the last frame (0 for none), for comparing
+    // renderers more finely than by the pixels that they draw
+    uint8_t GetColumnHeight(uint8_t screenX) const { return columnHeights[screenX]; }
+#endif
+
 protected:
     void BeginRender();
     void EndRender();
-    double GetColumnHeightByDistance(double dist);
+    Scalar GetColumnHeightByDistance(Scalar dist);
     void RenderColumn(uint32_t screenX, uint8_t height);
-    uint32_t MapPercentageToRange(double percentage, uint32_t rangeHigh);
+    uint32_t MapPercentageToRange(Scalar percentage, uint32_t rangeHigh);
     // this follows triangle rasterization rules described at
     // https://docs.microsoft.com/en-us/windows/win32/direct3d11/d3d10-graphics-programming-guide-rasterizer-stage-rules
-    //inline static int32_t Rast(double n) { return static_cast<int32_t>(ceil(n - 0.5f)); };
-    inline static uint8_t Rast(double n) { return static_cast<uint8_t>(n); };
-    uint8_t GetClippedHeight(double height);
+    //inline static int32_t Rast(Scalar n) { return static_cast<int32_t>(ceil(n - 0.5f)); };
+    inline static uint8_t Rast(Scalar n) { return static_cast<uint8_t>(n); };
+    uint8_t GetClippedHeight(Scalar height);
     
     uint8_t* pPixelBuf;
     const Camera& camera;
@@ -49,6 +68,11 @@ protected:
     const uint8_t screenHeight;
 
     ColRenderedCbType colRenderedCb;
+
+#ifdef SDLSim
+    Stats stats;
+    uint8_t columnHeights[256]; // (for any 8-bit screen width)
+#endif
     
     // dither pattern - see spreadsheet
     static constexpr uint8_t ditherPattern8bit[] = { /*0x00,*/ 0x80, 0x88, 0x92, 0xAA, 0xD5, 0xDB, 0xFB, 0xFF };
@@ -0,0 +1,28 @@
+//
+//  Scalar.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef Scalar_hpp
+#define Scalar_hpp
+
+#include "Fixed.hpp"
+
+// the number type used for all geometry and rendering math
+//
+// uncomment this (or define it as a compiler flag) to do all of that math in 16.16 fixed point
+// rather than floating point - the embedded hardware has no floating point unit, so this is
+// much faster there (on a PC, it is useful for comparing against the floating-point results)
+//#define FixedPointMath
+
+#ifdef FixedPointMath
+typedef Fixed Scalar;
+constexpr Scalar ScalarMax {Fixed::Max()};
+#else
+typedef double Scalar;
+constexpr Scalar ScalarMax {99999999999.9f};
+#endif
+
+#endif /* Scalar_hpp */
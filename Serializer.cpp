@@ -6,31 +6,22 @@
 //  Copyright © 2020 Brian Dolan. All rights reserved.
 //
 
+#include <string.h>
 #ifndef SDLSim // should be set as a compiler flag on simulation builds
 #include <avr/pgmspace.h>
 #endif
 #include "Serializer.hpp"
 
-Serializer::Fixed::Fixed(double number):
-    // TODO: round() would be better than truncation
-    // TODO: assert n is not out of bounds
-    encoding{static_cast<int32_t>(number * res)}
-{
-}
-
-Serializer::Fixed::Fixed(int32_t encoding):
-    encoding{encoding}
-{
-}
+constexpr bool Serializer::IsHostLittleEndian;
 
-double Serializer::Fixed::Unfixed() const
+Fixed Serializer::DeSerFixed(const uint8_t* bytes, size_t& offset)
 {
-    return Unfixed(encoding);
+    return Fixed::FromEncoding(DeSerInt(bytes, offset));
 }
 
 double Serializer::DeSerDouble(const uint8_t* bytes, size_t& offset)
 {
-    return Fixed(DeSerInt(bytes, offset)).Unfixed();
+    return DeSerFixed(bytes, offset).Unfixed();
 }
 
 int32_t Serializer::DeSerInt(const uint8_t* bytes, size_t& offset)
@@ -45,11 +36,177 @@ uint32_t Serializer::DeSerUint(const uint8_t* bytes, size_t& offset)
     return ret;
 }
 
+uint16_t Serializer::DeSerUint16(const uint8_t* bytes, size_t& offset)
+{
+#ifdef SDLSim
+    const uint8_t* ramBytes = bytes + offset;
+#else
+    uint8_t ramBytes[2];
+    for (uint32_t i = 0; i < 2; i++)
+        ramBytes[i] = pgm_read_byte_near(bytes + offset + i);
+#endif
+    offset += 2;
+
+    return
+        (static_cast<uint16_t>(ramBytes[1]) << 0) |
+        (static_cast<uint16_t>(ramBytes[0]) << 8);
+}
+
 int32_t Serializer::PeekInt(const uint8_t* bytes, size_t offset)
 {
     return FromBytes(bytes + offset);
 }
 
+Fixed Serializer::DeSerFixedLE(const uint8_t* bytes, size_t& offset)
+{
+    int32_t encoding;
+    DeSerIntsLE(bytes, offset, 1, &encoding);
+    offset += 4;
+    return Fixed::FromEncoding(encoding);
+}
+
+uint16_t Serializer::DeSerUint16LE(const uint8_t* bytes, size_t& offset)
+{
+    uint16_t value;
+    DeSerUint16sLE(bytes, offset, 1, &value);
+    offset += 2;
+    return value;
+}
+
+void Serializer::DeSerIntsLE(const uint8_t* bytes, size_t offset, size_t count, int32_t* values)
+{
+    CopyBytes(reinterpret_cast<uint8_t*>(values), bytes, offset, count * 4);
+    if (!IsHostLittleEndian)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint32_t value {static_cast<uint32_t>(values[i])};
+            values[i] = static_cast<int32_t>((value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24));
+        }
+    }
+}
+
+void Serializer::DeSerUint16sLE(const uint8_t* bytes, size_t offset, size_t count, uint16_t* values)
+{
+    CopyBytes(reinterpret_cast<uint8_t*>(values), bytes, offset, count * 2);
+    if (!IsHostLittleEndian)
+    {
+        for (size_t i = 0; i < count; i++)
+            values[i] = static_cast<uint16_t>((values[i] >> 8) | (values[i] << 8));
+    }
+}
+
+#ifdef SDLSim
+namespace
+{
+    constexpr uint32_t Crc32Polynomial {0xEDB88320};
+
+    // for doing 8 bytes at a time ("slicing by 8"): table 0 is the CRC of each byte value, and
+    // table n is the same, as if it were followed by n zero bytes (filled in on first use)
+    typedef uint32_t Crc32Tables[8][256];
+
+    const Crc32Tables& GetCrc32Tables()
+    {
+        static Crc32Tables tables;
+        static bool isFilled {false};
+        if (!isFilled)
+        {
+            for (uint32_t byte = 0; byte < 256; byte++)
+            {
+                uint32_t crc {byte};
+                for (uint8_t bit = 0; bit < 8; bit++)
+                    crc = (crc >> 1) ^ ((crc & 1) ? Crc32Polynomial : 0);
+                tables[0][byte] = crc;
+            }
+            for (uint32_t byte = 0; byte < 256; byte++)
+                for (size_t table = 1; table < 8; table++)
+                    tables[table][byte] = (tables[table - 1][byte] >> 8) ^ tables[0][tables[table - 1][byte] & 0xFF];
+            isFilled = true;
+        }
+        return tables;
+    }
+
+    uint32_t GetUint32LE(const uint8_t* bytes)
+    {
+        return (static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+                (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24));
+    }
+}
+#endif
+
+// (on the embedded hardware this is done a bit at a time, as tables would take up flash, and
+// this is only done when loading - a PC uses tables, as it loads much bigger trees)
+uint32_t Serializer::Crc32(const uint8_t* bytes, size_t offset, size_t count, uint32_t crc)
+{
+    crc = ~crc;
+#ifdef SDLSim
+    const Crc32Tables& tables {GetCrc32Tables()};
+    const uint8_t* p {bytes + offset};
+    for (; count >= 8; p += 8, count -= 8)
+    {
+        const uint32_t low {crc ^ GetUint32LE(p)};
+        const uint32_t high {GetUint32LE(p + 4)};
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+              tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+    }
+    for (; count > 0; p++, count--)
+        crc = (crc >> 8) ^ tables[0][(crc ^ *p) & 0xFF];
+#else
+    for (size_t i = offset; i < offset + count; i++)
+    {
+        crc ^= pgm_read_byte_near(bytes + i);
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+    }
+#endif
+    return ~crc;
+}
+
+bool Serializer::VarintStream::Read(uint32_t& value)
+{
+    uint32_t result {0};
+    for (uint8_t shift = 0; (shift < 32) && (offset < end); shift += 7)
+    {
+        const uint8_t byte {GetByte(bytes, offset++)};
+        // (the fifth byte only has room for the top 4 bits)
+        if ((shift == 28) && (byte > 0x0F))
+            return false;
+        result |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Serializer::VarintStream::ReadSigned(int32_t& value)
+{
+    uint32_t zigzag;
+    if (!Read(zigzag))
+        return false;
+    value = static_cast<int32_t>(zigzag >> 1) ^ -static_cast<int32_t>(zigzag & 1);
+    return true;
+}
+
+bool Serializer::VarintStream::ReadByte(uint8_t& value)
+{
+    if (offset >= end)
+        return false;
+    value = GetByte(bytes, offset++);
+    return true;
+}
+
+uint8_t Serializer::GetByte(const uint8_t* bytes, size_t offset)
+{
+#ifdef SDLSim
+    return bytes[offset];
+#else
+    return pgm_read_byte_near(bytes + offset);
+#endif
+}
+
 uint32_t Serializer::FromBytes(const uint8_t* bytes)
 {
 #ifdef SDLSim
@@ -66,3 +223,12 @@ uint32_t Serializer::FromBytes(const uint8_t* bytes)
         (static_cast<uint32_t>(ramBytes[1]) << 16) |
         (static_cast<uint32_t>(ramBytes[0]) << 24);
 }
+
+void Serializer::CopyBytes(uint8_t* dest, const uint8_t* bytes, size_t offset, size_t count)
+{
+#ifdef SDLSim
+    memcpy(dest, bytes + offset, count);
+#else
+    memcpy_P(dest, bytes + offset, count);
+#endif
+}
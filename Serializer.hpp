@@ -11,6 +11,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include "Fixed.hpp"
 
 // this class is particular to the nature of values in this program - mainly, for
 // floating point numbers, we expect to not have to worry about NaN or +/- infinity, and
@@ -22,41 +23,70 @@
 class Serializer
 {
 public:
-    // a 16.16 fixed-point representation of a floating point-number
-    // this could moved out to a more fully-functional class at some point if useful
-    class Fixed
-    {
-    public:
-        Fixed(double number);
-        Fixed(int32_t encoding);
-        ~Fixed() = default;
-        double Unfixed() const;
-        int32_t GetEncoding() const { return encoding; }
-        
-        // a (public) constexpr version of this function is useful for static_asserts
-        static constexpr double Unfixed(int32_t encoding)
-        {
-            return (static_cast<double>(encoding) / res);
-        }
-        
-    private:
-        int32_t encoding;
-        
-        // resolution of a fixed-point number (the amount that the LSB in the fractional part represents)
-        static constexpr double res { static_cast<double>(static_cast<int32_t>(1) << 16) };
-    };
-    
     Serializer() = delete;
     ~Serializer() = delete;
     
+    // (numbers are always serialized in 16.16 fixed point - see Fixed.hpp)
+    static Fixed DeSerFixed(const uint8_t* bytes, size_t& offset);
     static double DeSerDouble(const uint8_t* bytes, size_t& offset);
     static int32_t DeSerInt(const uint8_t* bytes, size_t& offset);
     static uint32_t DeSerUint(const uint8_t* bytes, size_t& offset);
+    static uint16_t DeSerUint16(const uint8_t* bytes, size_t& offset);
     
     static int32_t PeekInt(const uint8_t* bytes, size_t offset);
+
+    // little-endian versions, for data that is laid out for the machine rather than the network
+    static Fixed DeSerFixedLE(const uint8_t* bytes, size_t& offset);
+    static uint16_t DeSerUint16LE(const uint8_t* bytes, size_t& offset);
+    // these read whole arrays at once (into RAM), which is much quicker than a value at a time -
+    // the bytes are just copied if this machine is little-endian too
+    static void DeSerIntsLE(const uint8_t* bytes, size_t offset, size_t count, int32_t* values);
+    static void DeSerUint16sLE(const uint8_t* bytes, size_t offset, size_t count, uint16_t* values);
+    // (assumed for compilers that don't say, e.g. MSVC, which only targets little-endian machines)
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    static constexpr bool IsHostLittleEndian {false};
+#else
+    static constexpr bool IsHostLittleEndian {true};
+#endif
+
+    // the standard (zlib/PNG) CRC-32 of count bytes - a CRC of data in several pieces is found by
+    // passing each piece the CRC of the pieces before it
+    static uint32_t Crc32(const uint8_t* bytes, size_t offset, size_t count, uint32_t crc = 0);
+
+    // reads variable-length numbers one after another from a block of bytes (e.g. in PROGMEM),
+    // for compact data that can't be read at fixed offsets - all it keeps is where it is, and
+    // where the block ends
+    // each number is 7 bits per byte, lowest first, with the top bit set on every byte but the
+    // last (as in LEB128), and signed numbers are "zigzag" encoded first (0, -1, 1, -2, ... as
+    // 0, 1, 2, 3, ...), so that small numbers of either sign take one byte
+    class VarintStream
+    {
+    public:
+        VarintStream(const uint8_t* bytes, size_t offset, size_t end):
+            bytes{bytes},
+            offset{offset},
+            end{end}
+        {}
+
+        // these return false (and leave value alone) if the number runs past the end of the
+        // block, or doesn't fit in 32 bits
+        bool Read(uint32_t& value);
+        bool ReadSigned(int32_t& value);
+        // (a single byte, as is)
+        bool ReadByte(uint8_t& value);
+
+        bool IsAtEnd() const { return (offset == end); }
+
+    private:
+        const uint8_t* bytes;
+        size_t offset;
+        size_t end;
+    };
     
 private:
+    static uint8_t GetByte(const uint8_t* bytes, size_t offset);
     static uint32_t FromBytes(const uint8_t* bytes);
+    static void CopyBytes(uint8_t* dest, const uint8_t* bytes, size_t offset, size_t count);
 };
 
 #endif /* Serializer_hpp */
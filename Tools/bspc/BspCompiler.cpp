@@ -0,0 +1,1039 @@
+//
+//  BspCompiler.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include "BspCompiler.hpp"
+#include "BspTree.hpp"
+#include "Fixed.hpp"
+#include "Serializer.hpp"
+
+namespace
+{
+    typedef _Vec2<double> Point;
+
+    // how close (in map units) a point must be to a line to count as being on it - this is
+    // well under the resolution of the 16.16 fixed point that the tree is stored in
+    constexpr double OnLineDist {0.0001f};
+
+    // how a wall lies relative to the line through a splitting wall
+    enum class Side
+    {
+        Front,
+        Back,
+        Spanning,
+        Colinear
+    };
+
+    // the signed distance of p from the line through the wall, negative in front
+    // (see GeomUtils::IsPointInFrontOfLine())
+    double GetSignedDist(const WallSeg& splitter, const Point& p)
+    {
+        Point dir {splitter.p2 - splitter.p1};
+        return ((p - splitter.p1).cross(dir) / dir.Mag());
+    }
+
+    Side Classify(const WallSeg& splitter, const WallSeg& wall, double& dist1, double& dist2)
+    {
+        dist1 = GetSignedDist(splitter, wall.p1);
+        dist2 = GetSignedDist(splitter, wall.p2);
+        const bool p1On {fabs(dist1) <= OnLineDist};
+        const bool p2On {fabs(dist2) <= OnLineDist};
+
+        if (p1On && p2On)
+            return Side::Colinear;
+        if ((dist1 <= OnLineDist) && (dist2 <= OnLineDist))
+            return Side::Front;
+        if ((dist1 >= -OnLineDist) && (dist2 >= -OnLineDist))
+            return Side::Back;
+        return Side::Spanning;
+    }
+
+    // the walls that go on each side of a splitter (with spanning walls split into two)
+    class Partition
+    {
+    public:
+        std::vector<WallSeg> front;
+        std::vector<WallSeg> back;
+    };
+
+    void PartitionWalls(const std::vector<WallSeg>& walls, size_t splitterIdx, Partition& partition)
+    {
+        const WallSeg& splitter {walls[splitterIdx]};
+        for (size_t i = 0; i < walls.size(); i++)
+        {
+            if (i == splitterIdx)
+                continue;
+
+            const WallSeg& wall {walls[i]};
+            double dist1, dist2;
+            switch (Classify(splitter, wall, dist1, dist2))
+            {
+            case Side::Front:
+                partition.front.push_back(wall);
+                break;
+            case Side::Back:
+                partition.back.push_back(wall);
+                break;
+            case Side::Colinear:
+                // (walls in the same line can't hide each other, so either side would do - this
+                // keeps the ones facing the same way as the splitter in front of it)
+                if ((wall.p2 - wall.p1) * (splitter.p2 - splitter.p1) > 0)
+                    partition.front.push_back(wall);
+                else
+                    partition.back.push_back(wall);
+                break;
+            case Side::Spanning:
+            {
+                Point splitPoint {wall.p1 + (wall.p2 - wall.p1) * (dist1 / (dist1 - dist2))};
+                WallSeg part1 {wall.p1, splitPoint};
+                WallSeg part2 {splitPoint, wall.p2};
+                (dist1 < 0 ? partition.front : partition.back).push_back(part1);
+                (dist2 < 0 ? partition.front : partition.back).push_back(part2);
+                break;
+            }
+            }
+        }
+    }
+
+    // lower is better - walls that would be split cost the most, as each one adds a node
+    size_t ScoreSplitter(const std::vector<WallSeg>& walls, size_t splitterIdx)
+    {
+        size_t numFront {0}, numBack {0}, numSplits {0};
+        for (size_t i = 0; i < walls.size(); i++)
+        {
+            if (i == splitterIdx)
+                continue;
+
+            double dist1, dist2;
+            switch (Classify(walls[splitterIdx], walls[i], dist1, dist2))
+            {
+            case Side::Front:
+            case Side::Colinear:
+                numFront++;
+                break;
+            case Side::Back:
+                numBack++;
+                break;
+            case Side::Spanning:
+                numFront++;
+                numBack++;
+                numSplits++;
+                break;
+            }
+        }
+        return (numSplits * 8 + (numFront > numBack ? numFront - numBack : numBack - numFront));
+    }
+
+    class Builder
+    {
+    public:
+        Builder(const BspCompiler::Options& options, bool greedy, uint32_t seed):
+            options{options},
+            greedy{greedy},
+            rng{seed}
+        {}
+
+        std::unique_ptr<BspCompiler::Node> Build(const std::vector<WallSeg>& walls)
+        {
+            if (walls.empty())
+                return nullptr;
+
+            size_t splitterIdx {ChooseSplitter(walls)};
+            Partition partition;
+            PartitionWalls(walls, splitterIdx, partition);
+
+            std::unique_ptr<BspCompiler::Node> node {new BspCompiler::Node()};
+            node->wall = walls[splitterIdx];
+            node->back = Build(partition.back);
+            node->front = Build(partition.front);
+            return node;
+        }
+
+    private:
+        size_t ChooseSplitter(const std::vector<WallSeg>& walls)
+        {
+            // (for big maps, only a sample of the walls is scored at each node)
+            std::vector<size_t> candidates;
+            if (walls.size() <= options.maxCandidates)
+            {
+                for (size_t i = 0; i < walls.size(); i++)
+                    candidates.push_back(i);
+            }
+            else
+            {
+                for (size_t i = 0; i < options.maxCandidates; i++)
+                    candidates.push_back(greedy ? (i * walls.size() / options.maxCandidates) :
+                                                  std::uniform_int_distribution<size_t>(0, walls.size() - 1)(rng));
+            }
+
+            std::vector<std::pair<size_t, size_t>> scored;
+            for (size_t idx : candidates)
+                scored.push_back({ScoreSplitter(walls, idx), idx});
+            std::stable_sort(scored.begin(), scored.end(),
+                             [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) { return a.first < b.first; });
+
+            if (greedy)
+                return scored.front().second;
+
+            // pick among the few best
+            const size_t numBest {std::min<size_t>(scored.size(), 3)};
+            return scored[std::uniform_int_distribution<size_t>(0, numBest - 1)(rng)].second;
+        }
+
+        const BspCompiler::Options& options;
+        const bool greedy;
+        std::mt19937 rng;
+    };
+
+    // whether tree a is better than tree b
+    bool IsBetter(const BspCompiler::Options& options, const BspCompiler::Stats& a, const BspCompiler::Stats& b)
+    {
+        if (options.strategy == BspCompiler::Strategy::Cost)
+            return (a.cost < b.cost);
+
+        // a tree that is too deep can't be used at all
+        const bool aFits {a.depth <= options.maxDepth};
+        const bool bFits {b.depth <= options.maxDepth};
+        if (aFits != bFits)
+            return aFits;
+        if (a.numNodes != b.numNodes)
+            return (a.numNodes < b.numNodes);
+        return (a.depth < b.depth);
+    }
+
+    size_t GetDepth(const BspCompiler::Node* node)
+    {
+        return (node ? 1 + std::max(GetDepth(node->back.get()), GetDepth(node->front.get())) : 0);
+    }
+
+    void AppendInt(std::vector<uint8_t>& bytes, int32_t n)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+            bytes.push_back(static_cast<uint8_t>(static_cast<uint32_t>(n) >> shift));
+    }
+
+    // (see BspTree.hpp)
+    constexpr size_t NodeSize {BspTree::SerNodeSize};
+    constexpr size_t VertexSize {BspTree::SerVertexSize};
+    constexpr size_t CrcOffset {12};
+    constexpr size_t CountsOffset {16};
+    constexpr size_t BoundsOffset {24};
+
+    // the format from before the container - a 10 byte header of magic, number of vertices,
+    // number of nodes and depth, then the vertices and nodes as they are now
+    constexpr uint32_t BoxedMagic {0x42535042}; // "BSPB"
+    constexpr size_t BoxedHeaderSize {10};
+    // the format from before nodes had bounding boxes - the same, but with only the first 8 bytes
+    // of each node
+    constexpr uint32_t UnboxedMagic {0x42535049}; // "BSPI"
+    constexpr size_t UnboxedNodeSize {8};
+
+    void AppendUint16(std::vector<uint8_t>& bytes, uint16_t n)
+    {
+        bytes.push_back(static_cast<uint8_t>(n >> 8));
+        bytes.push_back(static_cast<uint8_t>(n));
+    }
+
+    uint16_t PeekUint16(const std::vector<uint8_t>& bytes, size_t offset)
+    {
+        return static_cast<uint16_t>((bytes[offset] << 8) | bytes[offset + 1]);
+    }
+
+    uint32_t PeekUint(const std::vector<uint8_t>& bytes, size_t offset)
+    {
+        return static_cast<uint32_t>(Serializer::PeekInt(bytes.data(), offset));
+    }
+
+    void SetUint(std::vector<uint8_t>& bytes, size_t offset, uint32_t n)
+    {
+        for (size_t i = 0; i < 4; i++)
+            bytes[offset + i] = static_cast<uint8_t>(n >> (24 - 8 * i));
+    }
+
+    // the offset and size of a section of a well-formed container (e.g. one that
+    // BspTree::CheckBin() has accepted)
+    // (false if there isn't one with this tag)
+    bool FindSection(const std::vector<uint8_t>& bytes, uint32_t tag, size_t& offset, size_t& size)
+    {
+        const uint16_t numSections {PeekUint16(bytes, CountsOffset + 6)};
+        for (size_t entry = BspTree::SerHeaderSize; entry < BspTree::SerHeaderSize + numSections * BspTree::SerSectionSize;
+             entry += BspTree::SerSectionSize)
+        {
+            if (PeekUint(bytes, entry) == tag)
+            {
+                offset = PeekUint(bytes, entry + 4);
+                size = PeekUint(bytes, entry + 8);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // reverses the bytes of each width-byte number in a section, between the portable (big-endian)
+    // and native (little-endian) layouts
+    void SwapSectionBytes(std::vector<uint8_t>& bytes, uint32_t tag, size_t width)
+    {
+        size_t offset, size;
+        if (!FindSection(bytes, tag, offset, size))
+            return;
+        for (size_t number = offset; number + width <= offset + size; number += width)
+            std::reverse(bytes.begin() + number, bytes.begin() + number + width);
+    }
+
+    void SetCrc(std::vector<uint8_t>& bytes)
+    {
+        const uint32_t headCrc {Serializer::Crc32(bytes.data(), 0, CrcOffset)};
+        SetUint(bytes, CrcOffset, Serializer::Crc32(bytes.data(), CrcOffset + 4, bytes.size() - (CrcOffset + 4), headCrc));
+    }
+
+    std::string GetTagText(uint32_t tag)
+    {
+        std::string text;
+        for (int shift = 24; shift >= 0; shift -= 8)
+            text += static_cast<char>(tag >> shift);
+        return text;
+    }
+
+    // vertices are shared by walls if they are exactly the same once converted to fixed point
+    // (as they would be stored)
+    typedef std::pair<int32_t, int32_t> VertexKey;
+
+    VertexKey GetVertexKey(const Point& p)
+    {
+        return {Fixed(p.x).GetEncoding(), Fixed(p.y).GetEncoding()};
+    }
+
+    // the tree's vertices in the order that they are first used (in node order), and the
+    // index of each one
+    class VertexTable
+    {
+    public:
+        uint16_t Add(const Point& p)
+        {
+            auto found = indices.insert({GetVertexKey(p), static_cast<uint16_t>(keys.size())});
+            if (found.second)
+                keys.push_back(found.first->first);
+            return found.first->second;
+        }
+
+        std::vector<VertexKey> keys;
+        std::map<VertexKey, uint16_t> indices;
+    };
+
+    void AddVertices(const BspCompiler::Node* node, VertexTable& vertices)
+    {
+        if (!node)
+            return;
+        vertices.Add(node->wall.p1);
+        vertices.Add(node->wall.p2);
+        AddVertices(node->back.get(), vertices);
+        AddVertices(node->front.get(), vertices);
+    }
+
+    // a bounding box, as the indices of the vertices with the lowest x, lowest y, highest x and
+    // highest y (comparing them as they are stored, in fixed point)
+    class VertexBox
+    {
+    public:
+        void Add(const VertexTable& vertices, uint16_t vertexIdx)
+        {
+            const VertexKey& key {vertices.keys[vertexIdx]};
+            if (key.first < vertices.keys[minXIdx].first)
+                minXIdx = vertexIdx;
+            if (key.second < vertices.keys[minYIdx].second)
+                minYIdx = vertexIdx;
+            if (key.first > vertices.keys[maxXIdx].first)
+                maxXIdx = vertexIdx;
+            if (key.second > vertices.keys[maxYIdx].second)
+                maxYIdx = vertexIdx;
+        }
+        void Add(const VertexTable& vertices, const VertexBox& box)
+        {
+            for (uint16_t vertexIdx : {box.minXIdx, box.minYIdx, box.maxXIdx, box.maxYIdx})
+                Add(vertices, vertexIdx);
+        }
+
+        uint16_t minXIdx;
+        uint16_t minYIdx;
+        uint16_t maxXIdx;
+        uint16_t maxYIdx;
+    };
+
+    void SetUint16(std::vector<uint8_t>& bytes, size_t offset, uint16_t n)
+    {
+        bytes[offset] = static_cast<uint8_t>(n >> 8);
+        bytes[offset + 1] = static_cast<uint8_t>(n);
+    }
+
+    // nodes are stored in preorder (each node, then its back subtree, then its front subtree),
+    // so that a node's back child, if it has one, is always the next node
+    // (returns the node's subtree's bounding box)
+    VertexBox AppendNodes(const BspCompiler::Node* node, VertexTable& vertices, std::vector<uint8_t>& bytes)
+    {
+        const size_t nodeOffset {bytes.size()};
+        const uint16_t nodeNum {static_cast<uint16_t>(nodeOffset / NodeSize)};
+        const uint16_t p1Idx {vertices.Add(node->wall.p1)};
+        const uint16_t p2Idx {vertices.Add(node->wall.p2)};
+        bytes.resize(nodeOffset + NodeSize);
+        SetUint16(bytes, nodeOffset, p1Idx);
+        SetUint16(bytes, nodeOffset + 2, p2Idx);
+        SetUint16(bytes, nodeOffset + 4, BspTree::SerNullIdx);
+        SetUint16(bytes, nodeOffset + 6, BspTree::SerNullIdx);
+
+        VertexBox box {p1Idx, p1Idx, p1Idx, p1Idx};
+        box.Add(vertices, p2Idx);
+        if (node->back)
+        {
+            SetUint16(bytes, nodeOffset + 4, nodeNum + 1);
+            box.Add(vertices, AppendNodes(node->back.get(), vertices, bytes));
+        }
+        if (node->front)
+        {
+            SetUint16(bytes, nodeOffset + 6, static_cast<uint16_t>(bytes.size() / NodeSize));
+            box.Add(vertices, AppendNodes(node->front.get(), vertices, bytes));
+        }
+
+        SetUint16(bytes, nodeOffset + 8, box.minXIdx);
+        SetUint16(bytes, nodeOffset + 10, box.minYIdx);
+        SetUint16(bytes, nodeOffset + 12, box.maxXIdx);
+        SetUint16(bytes, nodeOffset + 14, box.maxYIdx);
+        return box;
+    }
+
+    void AppendBytes(std::string& text, const std::vector<uint8_t>& bytes, size_t offset, size_t count)
+    {
+        char byteText[8];
+        for (size_t i = offset; i < offset + count; i++)
+        {
+            snprintf(byteText, sizeof(byteText), "0x%02x, ", bytes[i]);
+            text += byteText;
+        }
+    }
+
+    std::string GetIdxText(uint16_t idx)
+    {
+        return ((idx == BspTree::SerNullIdx) ? "--" : std::to_string(idx));
+    }
+
+    // (see BspTree::SerFlagCompact and Serializer::VarintStream)
+    constexpr uint8_t CompactMaxFracBits {16};
+    constexpr int32_t CompactMin {-32768};
+    constexpr int32_t CompactMax {32767};
+
+    void AppendVarint(std::vector<uint8_t>& bytes, uint32_t n)
+    {
+        while (n >= 0x80)
+        {
+            bytes.push_back(static_cast<uint8_t>(n | 0x80));
+            n >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(n));
+    }
+
+    void AppendSignedVarint(std::vector<uint8_t>& bytes, int32_t n)
+    {
+        AppendVarint(bytes, (static_cast<uint32_t>(n) << 1) ^ static_cast<uint32_t>(-static_cast<int32_t>(n < 0)));
+    }
+
+    // the number of bytes in count varints
+    size_t GetVarintsSize(const std::vector<uint8_t>& bytes, size_t offset, size_t count)
+    {
+        size_t size {0};
+        for (; count > 0; count--)
+            while ((bytes[offset + size++] & 0x80) != 0) {}
+        return size;
+    }
+
+    // a fixed point coordinate as a whole number of units of fracBits fractional bits (rounded to
+    // the nearest unit)
+    int64_t GetCompactCoord(int32_t encoding, uint8_t fracBits)
+    {
+        return static_cast<int64_t>(std::floor(encoding / static_cast<double>(1 << (CompactMaxFracBits - fracBits)) + 0.5));
+    }
+
+    // the vertex and node sections of a compact tree, from those of a portable one
+    void AppendCompactSections(const std::vector<VertexKey>& vertexKeys, const std::vector<uint8_t>& nodeBytes, uint8_t fracBits,
+                               std::vector<uint8_t>& verticesBytes, std::vector<uint8_t>& nodesBytes)
+    {
+        verticesBytes.push_back(fracBits);
+        int32_t lastX {0}, lastY {0};
+        for (const VertexKey& key : vertexKeys)
+        {
+            const int32_t x {static_cast<int32_t>(GetCompactCoord(key.first, fracBits))};
+            const int32_t y {static_cast<int32_t>(GetCompactCoord(key.second, fracBits))};
+            AppendSignedVarint(verticesBytes, x - lastX);
+            AppendSignedVarint(verticesBytes, y - lastY);
+            lastX = x;
+            lastY = y;
+        }
+
+        // (a back child is always the next node, so it only takes a bit)
+        for (size_t offset = 0; offset < nodeBytes.size(); offset += NodeSize)
+        {
+            const uint16_t nodeIdx {static_cast<uint16_t>(offset / NodeSize)};
+            const uint16_t backIdx {PeekUint16(nodeBytes, offset + 4)};
+            const uint16_t frontIdx {PeekUint16(nodeBytes, offset + 6)};
+            const uint32_t frontOffset {(frontIdx == BspTree::SerNullIdx) ? 0u : static_cast<uint32_t>(frontIdx - nodeIdx)};
+            AppendVarint(nodesBytes, PeekUint16(nodeBytes, offset));
+            AppendVarint(nodesBytes, PeekUint16(nodeBytes, offset + 2));
+            AppendVarint(nodesBytes, (frontOffset << 1) | ((backIdx == BspTree::SerNullIdx) ? 0u : 1u));
+            for (size_t field = 8; field < NodeSize; field += 2)
+                AppendVarint(nodesBytes, PeekUint16(nodeBytes, offset + field));
+        }
+    }
+
+    // the vertex and node sections of a portable tree, from those of a compact one that
+    // BspTree::CheckBin() has accepted
+    void AppendPortableSections(const std::vector<uint8_t>& bytes, size_t verticesOffset, size_t verticesSize, uint16_t numVertices,
+                                size_t nodesOffset, size_t nodesSize, uint16_t numNodes, std::vector<uint8_t>& portableBytes)
+    {
+        Serializer::VarintStream vertexStream {bytes.data(), verticesOffset, verticesOffset + verticesSize};
+        uint8_t fracBits {0};
+        vertexStream.ReadByte(fracBits);
+        int32_t x {0}, y {0};
+        for (uint16_t vertex = 0; vertex < numVertices; vertex++)
+        {
+            int32_t dx {0}, dy {0};
+            vertexStream.ReadSigned(dx);
+            vertexStream.ReadSigned(dy);
+            x += dx;
+            y += dy;
+            AppendInt(portableBytes, x * (1 << (CompactMaxFracBits - fracBits)));
+            AppendInt(portableBytes, y * (1 << (CompactMaxFracBits - fracBits)));
+        }
+
+        Serializer::VarintStream nodeStream {bytes.data(), nodesOffset, nodesOffset + nodesSize};
+        for (uint16_t node = 0; node < numNodes; node++)
+        {
+            uint32_t values[7] {};
+            for (uint32_t& value : values)
+                nodeStream.Read(value);
+            const uint32_t frontOffset {values[2] >> 1};
+            AppendUint16(portableBytes, static_cast<uint16_t>(values[0]));
+            AppendUint16(portableBytes, static_cast<uint16_t>(values[1]));
+            AppendUint16(portableBytes, ((values[2] & 1) != 0) ? static_cast<uint16_t>(node + 1) : BspTree::SerNullIdx);
+            AppendUint16(portableBytes, (frontOffset != 0) ? static_cast<uint16_t>(node + frontOffset) : BspTree::SerNullIdx);
+            for (size_t field = 3; field < 7; field++)
+                AppendUint16(portableBytes, static_cast<uint16_t>(values[field]));
+        }
+    }
+
+    // the format from before the vertex table, where each node had its own copy of its wall's
+    // end points: nodes are in preorder (as above), with 4 numbers per node (16.16 fixed point:
+    // p1.x, p1.y, p2.x, p2.y), and a null child is stored as LegacyNullNode in place of a node
+    constexpr int32_t LegacyNullNode {static_cast<int32_t>(0x7FFFFFFF)};
+
+    // (there's no limit on depth in the formats themselves, but a corrupt file could otherwise
+    // recurse forever)
+    constexpr size_t MaxLoadDepth {10000};
+
+    bool LoadLegacyNode(const std::vector<uint8_t>& bytes, size_t& offset, size_t depth,
+                        std::unique_ptr<BspCompiler::Node>& node, std::string& error)
+    {
+        if (offset + 4 > bytes.size())
+        {
+            error = "unexpected end of data";
+            return false;
+        }
+        if (depth > MaxLoadDepth)
+        {
+            error = "tree is too deep";
+            return false;
+        }
+
+        if (Serializer::PeekInt(bytes.data(), offset) == LegacyNullNode)
+        {
+            offset += 4;
+            return true;
+        }
+
+        if (offset + 16 > bytes.size())
+        {
+            error = "unexpected end of data";
+            return false;
+        }
+
+        node.reset(new BspCompiler::Node());
+        node->wall = WallSeg(bytes.data(), offset);
+        return (LoadLegacyNode(bytes, offset, depth + 1, node->back, error) &&
+                LoadLegacyNode(bytes, offset, depth + 1, node->front, error));
+    }
+
+    // (each node can only be used once, so "used" also catches cycles)
+    // (bounding boxes are not read, as they are recomputed when the tree is written)
+    bool LoadIndexedNode(const std::vector<uint8_t>& bytes, const std::vector<Point>& vertices, size_t nodesOffset,
+                         size_t nodeSize, uint16_t nodeIdx, std::vector<bool>& used, std::unique_ptr<BspCompiler::Node>& node,
+                         std::string& error)
+    {
+        if (nodeIdx == BspTree::SerNullIdx)
+            return true;
+        if ((nodeIdx >= used.size()) || used[nodeIdx])
+        {
+            error = "bad node index " + std::to_string(nodeIdx);
+            return false;
+        }
+        used[nodeIdx] = true;
+
+        const size_t offset {nodesOffset + nodeIdx * nodeSize};
+        const uint16_t p1Idx {PeekUint16(bytes, offset)};
+        const uint16_t p2Idx {PeekUint16(bytes, offset + 2)};
+        if ((p1Idx >= vertices.size()) || (p2Idx >= vertices.size()))
+        {
+            error = "bad vertex index in node " + std::to_string(nodeIdx);
+            return false;
+        }
+
+        node.reset(new BspCompiler::Node());
+        node->wall = {vertices[p1Idx], vertices[p2Idx]};
+        return (LoadIndexedNode(bytes, vertices, nodesOffset, nodeSize, PeekUint16(bytes, offset + 4), used, node->back, error) &&
+                LoadIndexedNode(bytes, vertices, nodesOffset, nodeSize, PeekUint16(bytes, offset + 6), used, node->front, error));
+    }
+
+    // (the vertices and nodes must be within the bytes)
+    bool LoadIndexed(const std::vector<uint8_t>& bytes, size_t verticesOffset, uint16_t numVertices, size_t nodesOffset,
+                     uint16_t numNodes, size_t nodeSize, uint16_t depth, std::unique_ptr<BspCompiler::Node>& root,
+                     std::string& error)
+    {
+        std::vector<Point> vertices;
+        for (size_t offset = verticesOffset; offset < verticesOffset + numVertices * VertexSize; )
+        {
+            double x {Serializer::DeSerDouble(bytes.data(), offset)};
+            double y {Serializer::DeSerDouble(bytes.data(), offset)};
+            vertices.push_back({x, y});
+        }
+
+        std::vector<bool> used(numNodes);
+        if ((numNodes > 0) && !LoadIndexedNode(bytes, vertices, nodesOffset, nodeSize, 0, used, root, error))
+            return false;
+        if (GetDepth(root.get()) != depth)
+        {
+            error = "depth in the header doesn't match the tree";
+            return false;
+        }
+        return true;
+    }
+
+    // the older formats, with a 10 byte header and no container
+    bool LoadUncontained(const std::vector<uint8_t>& bytes, size_t nodeSize, std::unique_ptr<BspCompiler::Node>& root,
+                         std::string& error)
+    {
+        if (bytes.size() < BoxedHeaderSize)
+        {
+            error = "unexpected end of data";
+            return false;
+        }
+
+        const uint16_t numVertices {PeekUint16(bytes, 4)};
+        const uint16_t numNodes {PeekUint16(bytes, 6)};
+        const size_t nodesOffset {BoxedHeaderSize + numVertices * VertexSize};
+        if (bytes.size() != nodesOffset + numNodes * nodeSize)
+        {
+            error = "data size doesn't match the numbers of vertices and nodes";
+            return false;
+        }
+        return LoadIndexed(bytes, BoxedHeaderSize, numVertices, nodesOffset, numNodes, nodeSize, PeekUint16(bytes, 8), root, error);
+    }
+
+    std::string GetBinStatusText(BspTree::BinStatus status)
+    {
+        switch (status)
+        {
+            case BspTree::BinStatus::Ok: return "ok";
+            case BspTree::BinStatus::BadMagic: return "not a serialized tree";
+            case BspTree::BinStatus::BadVersion: return "unsupported format version";
+            case BspTree::BinStatus::BadFlags: return "unsupported format flags";
+            case BspTree::BinStatus::BadSize: return "size in the header doesn't match the data";
+            case BspTree::BinStatus::BadChecksum: return "checksum doesn't match (the data is corrupt)";
+            case BspTree::BinStatus::TooBig: return "too many nodes or vertices, or too deep";
+            case BspTree::BinStatus::BadSections: return "vertex or node section is missing or bad";
+            case BspTree::BinStatus::BadNode: return "a node has a bad vertex or node index, is out of order, or is deeper than the header says";
+            case BspTree::BinStatus::BadVertex: return "a compact vertex is out of range";
+        }
+        return "unknown error";
+    }
+
+    bool LoadContainer(const std::vector<uint8_t>& bytes, std::unique_ptr<BspCompiler::Node>& root, std::string& error)
+    {
+        // (this is the same check that the game makes, so anything read here can be loaded there -
+        // bspc is built with the largest limits, though)
+        const BspTree::BinStatus status {BspTree::CheckBin(bytes.data(), bytes.size())};
+        if (status != BspTree::BinStatus::Ok)
+        {
+            error = GetBinStatusText(status);
+            return false;
+        }
+
+        const uint16_t numVertices {PeekUint16(bytes, CountsOffset)};
+        const uint16_t numNodes {PeekUint16(bytes, CountsOffset + 2)};
+        const uint16_t depth {PeekUint16(bytes, CountsOffset + 4)};
+        // (CheckBin() has made sure that both sections are there)
+        size_t verticesOffset {0}, verticesSize {0}, nodesOffset {0}, nodesSize {0};
+        FindSection(bytes, BspTree::SerVerticesTag, verticesOffset, verticesSize);
+        FindSection(bytes, BspTree::SerNodesTag, nodesOffset, nodesSize);
+
+        // (native and compact trees are read by turning them back into the portable layout)
+        if ((PeekUint16(bytes, 6) & BspTree::SerFlagCompact) != 0)
+        {
+            std::vector<uint8_t> portableBytes;
+            AppendPortableSections(bytes, verticesOffset, verticesSize, numVertices, nodesOffset, nodesSize, numNodes, portableBytes);
+            return LoadIndexed(portableBytes, 0, numVertices, numVertices * VertexSize, numNodes, NodeSize, depth, root, error);
+        }
+        std::vector<uint8_t> portableBytes {bytes};
+        if ((PeekUint16(bytes, 6) & BspTree::SerFlagNative) != 0)
+        {
+            SwapSectionBytes(portableBytes, BspTree::SerVerticesTag, 4);
+            SwapSectionBytes(portableBytes, BspTree::SerNodesTag, 2);
+        }
+        return LoadIndexed(portableBytes, verticesOffset, numVertices, nodesOffset, numNodes, NodeSize, depth, root, error);
+    }
+
+    // the bounding box of each node's subtree (as stored in the serialized tree)
+    class Box
+    {
+    public:
+        Point min;
+        Point max;
+    };
+    typedef std::map<const BspCompiler::Node*, Box> BoxMap;
+
+    Box AddBoxes(const BspCompiler::Node* node, BoxMap& boxes)
+    {
+        Box box {{std::min(node->wall.p1.x, node->wall.p2.x), std::min(node->wall.p1.y, node->wall.p2.y)},
+                 {std::max(node->wall.p1.x, node->wall.p2.x), std::max(node->wall.p1.y, node->wall.p2.y)}};
+        for (const BspCompiler::Node* child : {node->back.get(), node->front.get()})
+        {
+            if (!child)
+                continue;
+            Box childBox {AddBoxes(child, boxes)};
+            box.min = {std::min(box.min.x, childBox.min.x), std::min(box.min.y, childBox.min.y)};
+            box.max = {std::max(box.max.x, childBox.max.x), std::max(box.max.y, childBox.max.y)};
+        }
+        boxes[node] = box;
+        return box;
+    }
+
+    // returns false once the screen is full (see BspTree::TraverseRender())
+    bool TraverseCost(const BspCompiler::Node* node, const BoxMap& boxes, CostModel& costModel, size_t& numNodesVisited)
+    {
+        if (!node)
+            return true;
+
+        numNodesVisited++;
+        const Box& box {boxes.at(node)};
+        if (costModel.IsBoxOutsideView(box.min, box.max) ||
+            ((node->back || node->front) && costModel.IsBoxHidden(box.min, box.max)))
+            return true;
+
+        const BspCompiler::Node* first {node->back.get()};
+        const BspCompiler::Node* second {node->front.get()};
+        const bool inFront {GetSignedDist(node->wall, costModel.GetCameraLoc()) < 0};
+        if (inFront)
+            std::swap(first, second);
+
+        return (TraverseCost(first, boxes, costModel, numNodesVisited) &&
+                (!inFront || costModel.DrawWall(node->wall)) &&
+                TraverseCost(second, boxes, costModel, numNodesVisited));
+    }
+
+    void AddCost(const BspCompiler::Node* root, const BspCompiler::Options& options, CostModel& costModel,
+                 BspCompiler::Stats& stats)
+    {
+        stats.avgNodesVisited = BspCompiler::GetAvgNodesVisited(root, costModel);
+        stats.cost = stats.avgNodesVisited + options.splitCost * stats.numSplits +
+                     options.depthCost * (stats.depth > options.maxDepth ? stats.depth - options.maxDepth : 0);
+    }
+}
+
+std::unique_ptr<BspCompiler::Node> BspCompiler::Build(const std::vector<WallSeg>& walls, const Options& options, Stats& stats)
+{
+    // (zero-length walls have no direction, so can't be used as splitters - they couldn't be
+    // seen anyway)
+    std::vector<WallSeg> validWalls;
+    for (const WallSeg& wall : walls)
+        if ((wall.p2 - wall.p1).Mag() > OnLineDist)
+            validWalls.push_back(wall);
+
+    CostModel costModel {validWalls, options.costOptions};
+
+    std::unique_ptr<Node> best {Builder(options, true, options.seed).Build(validWalls)};
+    GetStats(best.get(), walls.size(), stats);
+    AddCost(best.get(), options, costModel, stats);
+
+    if (options.strategy != Strategy::Greedy)
+    {
+        std::mt19937 seeds {options.seed};
+        for (size_t trial = 1; trial < options.numTrials; trial++)
+        {
+            std::unique_ptr<Node> tree {Builder(options, false, seeds()).Build(validWalls)};
+            Stats treeStats;
+            GetStats(tree.get(), walls.size(), treeStats);
+            AddCost(tree.get(), options, costModel, treeStats);
+            if (IsBetter(options, treeStats, stats))
+            {
+                best = std::move(tree);
+                stats = treeStats;
+            }
+        }
+    }
+
+    return best;
+}
+
+void BspCompiler::GetStats(const Node* root, size_t numWalls, Stats& stats)
+{
+    std::vector<WallSeg> treeWalls;
+    GetWalls(root, treeWalls);
+    stats.numWalls = numWalls;
+    stats.numNodes = treeWalls.size();
+    stats.numSplits = (treeWalls.size() > numWalls ? treeWalls.size() - numWalls : 0);
+    stats.depth = GetDepth(root);
+
+    VertexTable vertices;
+    AddVertices(root, vertices);
+    stats.numVertices = vertices.keys.size();
+}
+
+double BspCompiler::GetAvgNodesVisited(const Node* root, CostModel& costModel)
+{
+    if (costModel.GetNumPoses() == 0)
+        return 0.0f;
+
+    BoxMap boxes;
+    if (root)
+        AddBoxes(root, boxes);
+
+    size_t numNodesVisited {0};
+    for (size_t pose = 0; pose < costModel.GetNumPoses(); pose++)
+    {
+        costModel.BeginFrame(pose);
+        TraverseCost(root, boxes, costModel, numNodesVisited);
+    }
+    return (static_cast<double>(numNodesVisited) / costModel.GetNumPoses());
+}
+
+void BspCompiler::GetWalls(const Node* root, std::vector<WallSeg>& walls)
+{
+    if (!root)
+        return;
+    walls.push_back(root->wall);
+    GetWalls(root->back.get(), walls);
+    GetWalls(root->front.get(), walls);
+}
+
+bool BspCompiler::GetCompactScale(const Node* root, uint8_t& fracBits, bool& isExact)
+{
+    VertexTable vertices;
+    AddVertices(root, vertices);
+
+    // (fewer bits give smaller numbers, and so smaller varints)
+    bool fits {false};
+    for (uint8_t bits = 0; bits <= CompactMaxFracBits; bits++)
+    {
+        bool bitsFit {true}, bitsExact {true};
+        for (const VertexKey& key : vertices.keys)
+        {
+            for (int32_t encoding : {key.first, key.second})
+            {
+                const int64_t coord {GetCompactCoord(encoding, bits)};
+                bitsFit = bitsFit && (coord >= CompactMin) && (coord <= CompactMax);
+                bitsExact = bitsExact && (coord * (1 << (CompactMaxFracBits - bits)) == encoding);
+            }
+        }
+        if (!bitsFit)
+            break;
+        fits = true;
+        fracBits = bits;
+        isExact = bitsExact;
+        if (bitsExact)
+            break;
+    }
+    return fits;
+}
+
+std::vector<uint8_t> BspCompiler::Serialize(const Node* root, Layout layout)
+{
+    std::vector<uint8_t> nodeBytes;
+    VertexTable vertices;
+    if (root)
+        AppendNodes(root, vertices, nodeBytes);
+
+    VertexKey boundsMin {0, 0}, boundsMax {0, 0};
+    if (!vertices.keys.empty())
+        boundsMin = boundsMax = vertices.keys[0];
+    for (const VertexKey& key : vertices.keys)
+    {
+        boundsMin = {std::min(boundsMin.first, key.first), std::min(boundsMin.second, key.second)};
+        boundsMax = {std::max(boundsMax.first, key.first), std::max(boundsMax.second, key.second)};
+    }
+
+    // (the size and checksum are filled in at the end)
+    std::vector<uint8_t> bytes;
+    AppendInt(bytes, static_cast<int32_t>(BspTree::SerMagic));
+    AppendUint16(bytes, BspTree::SerVersion);
+    AppendUint16(bytes, (layout == Layout::Native) ? BspTree::SerFlagNative :
+                        (layout == Layout::Compact) ? BspTree::SerFlagCompact : 0);
+    AppendInt(bytes, 0);
+    AppendInt(bytes, 0);
+    AppendUint16(bytes, static_cast<uint16_t>(vertices.keys.size()));
+    AppendUint16(bytes, static_cast<uint16_t>(nodeBytes.size() / NodeSize));
+    AppendUint16(bytes, static_cast<uint16_t>(GetDepth(root)));
+    AppendUint16(bytes, 2);
+    AppendInt(bytes, boundsMin.first);
+    AppendInt(bytes, boundsMin.second);
+    AppendInt(bytes, boundsMax.first);
+    AppendInt(bytes, boundsMax.second);
+
+    std::vector<uint8_t> verticesBytes;
+    if (layout == Layout::Compact)
+    {
+        uint8_t fracBits;
+        bool isExact;
+        if (!GetCompactScale(root, fracBits, isExact))
+            return {};
+        std::vector<uint8_t> compactNodeBytes;
+        AppendCompactSections(vertices.keys, nodeBytes, fracBits, verticesBytes, compactNodeBytes);
+        nodeBytes.swap(compactNodeBytes);
+    }
+    else
+    {
+        for (const VertexKey& key : vertices.keys)
+        {
+            AppendInt(verticesBytes, key.first);
+            AppendInt(verticesBytes, key.second);
+        }
+    }
+
+    // (both sections start at multiples of 8 bytes, as SerFlagNative needs, since the header,
+    // the section table and each vertex are all multiples of 8 bytes - compact sections don't
+    // need to be aligned)
+    const size_t verticesOffset {BspTree::SerHeaderSize + 2 * BspTree::SerSectionSize};
+    AppendInt(bytes, static_cast<int32_t>(BspTree::SerVerticesTag));
+    AppendInt(bytes, static_cast<int32_t>(verticesOffset));
+    AppendInt(bytes, static_cast<int32_t>(verticesBytes.size()));
+    AppendInt(bytes, static_cast<int32_t>(BspTree::SerNodesTag));
+    AppendInt(bytes, static_cast<int32_t>(verticesOffset + verticesBytes.size()));
+    AppendInt(bytes, static_cast<int32_t>(nodeBytes.size()));
+    bytes.insert(bytes.end(), verticesBytes.begin(), verticesBytes.end());
+    bytes.insert(bytes.end(), nodeBytes.begin(), nodeBytes.end());
+
+    if (layout == Layout::Native)
+    {
+        SwapSectionBytes(bytes, BspTree::SerVerticesTag, 4);
+        SwapSectionBytes(bytes, BspTree::SerNodesTag, 2);
+    }
+
+    SetUint(bytes, 8, static_cast<uint32_t>(bytes.size()));
+    SetCrc(bytes);
+    return bytes;
+}
+
+bool BspCompiler::Deserialize(const std::vector<uint8_t>& bytes, std::unique_ptr<Node>& root, std::string& error)
+{
+    root.reset();
+    const uint32_t magic {(bytes.size() >= 4) ? PeekUint(bytes, 0) : 0};
+    if (magic == BspTree::SerMagic)
+        return LoadContainer(bytes, root, error);
+    if (magic == BoxedMagic)
+        return LoadUncontained(bytes, NodeSize, root, error);
+    if (magic == UnboxedMagic)
+        return LoadUncontained(bytes, UnboxedNodeSize, root, error);
+
+    size_t offset {0};
+    if (!LoadLegacyNode(bytes, offset, 0, root, error))
+        return false;
+    if (offset != bytes.size())
+    {
+        error = "unexpected data after the end of the tree";
+        return false;
+    }
+    return true;
+}
+
+std::string BspCompiler::ToCArray(const Node* root, const std::string& name, Layout layout)
+{
+    // (this is laid out from the serialized data itself, so it can't disagree with Serialize() -
+    // the comments are always from the portable layout, which has the same vertices and nodes)
+    const std::vector<uint8_t> bytes {Serialize(root, layout)};
+    const std::vector<uint8_t> portableBytes {(layout == Layout::Portable) ? bytes : Serialize(root)};
+    const uint16_t numVertices {PeekUint16(bytes, CountsOffset)};
+    const uint16_t numNodes {PeekUint16(bytes, CountsOffset + 2)};
+    const uint16_t numSections {PeekUint16(bytes, CountsOffset + 6)};
+    char text128[128];
+
+    std::string text {"const unsigned char " + name + "[] PROGMEM =\n{\n"};
+    text += "    /* Header */ ";
+    AppendBytes(text, bytes, 0, CountsOffset);
+    snprintf(text128, sizeof(text128), "Version: %u, Size: %u, CRC: 0x%08x", PeekUint16(bytes, 4), PeekUint(bytes, 8),
+             PeekUint(bytes, CrcOffset));
+    text += " /* " + std::string(text128) + " */\n";
+    text += "    /* Counts */ ";
+    AppendBytes(text, bytes, CountsOffset, BoundsOffset - CountsOffset);
+    text += " /* Vertices: " + std::to_string(numVertices) + ", Nodes: " + std::to_string(numNodes) +
+            ", Depth: " + std::to_string(PeekUint16(bytes, CountsOffset + 4)) + ", Sections: " + std::to_string(numSections) + " */\n";
+    text += "    /* Bounds */ ";
+    AppendBytes(text, bytes, BoundsOffset, BspTree::SerHeaderSize - BoundsOffset);
+    size_t numberOffset {BoundsOffset};
+    const double minX {Serializer::DeSerDouble(bytes.data(), numberOffset)};
+    const double minY {Serializer::DeSerDouble(bytes.data(), numberOffset)};
+    const double maxX {Serializer::DeSerDouble(bytes.data(), numberOffset)};
+    const double maxY {Serializer::DeSerDouble(bytes.data(), numberOffset)};
+    snprintf(text128, sizeof(text128), "(%.9g, %.9g) - (%.9g, %.9g)", minX, minY, maxX, maxY);
+    text += " /* " + std::string(text128) + " */\n";
+
+    for (uint16_t section = 0; section < numSections; section++)
+    {
+        const size_t entry {BspTree::SerHeaderSize + section * BspTree::SerSectionSize};
+        text += "    /* Section: " + GetTagText(PeekUint(bytes, entry)) + " */ ";
+        AppendBytes(text, bytes, entry, BspTree::SerSectionSize);
+        text += " /* Offset: " + std::to_string(PeekUint(bytes, entry + 4)) + ", Size: " + std::to_string(PeekUint(bytes, entry + 8)) + " */\n";
+    }
+
+    // (compact vertices and nodes are each a number of varints, rather than a fixed size)
+    const bool isCompact {layout == Layout::Compact};
+    size_t offset, size, portableOffset, portableSize;
+    FindSection(bytes, BspTree::SerVerticesTag, offset, size);
+    FindSection(portableBytes, BspTree::SerVerticesTag, portableOffset, portableSize);
+    if (isCompact)
+    {
+        text += "    /* Scale */ ";
+        AppendBytes(text, bytes, offset, 1);
+        text += " /* Fractional bits: " + std::to_string(bytes[offset]) + " */\n";
+        offset++;
+    }
+    for (uint16_t vertex = 0; vertex < numVertices; vertex++, portableOffset += VertexSize)
+    {
+        numberOffset = portableOffset;
+        double x {Serializer::DeSerDouble(portableBytes.data(), numberOffset)};
+        double y {Serializer::DeSerDouble(portableBytes.data(), numberOffset)};
+        snprintf(text128, sizeof(text128), "(%.9g, %.9g)", x, y);
+
+        const size_t vertexSize {isCompact ? GetVarintsSize(bytes, offset, 2) : VertexSize};
+        text += "    /* Vertex: " + std::to_string(vertex) + " */ ";
+        AppendBytes(text, bytes, offset, vertexSize);
+        text += " /* " + std::string(text128) + " */\n";
+        offset += vertexSize;
+    }
+
+    FindSection(bytes, BspTree::SerNodesTag, offset, size);
+    FindSection(portableBytes, BspTree::SerNodesTag, portableOffset, portableSize);
+    for (uint16_t node = 0; node < numNodes; node++, portableOffset += NodeSize)
+    {
+        const size_t nodeSize {isCompact ? GetVarintsSize(bytes, offset, 7) : NodeSize};
+        text += "    /* Node: " + std::to_string(node) + " */ ";
+        AppendBytes(text, bytes, offset, nodeSize);
+        text += " /* Back: " + GetIdxText(PeekUint16(portableBytes, portableOffset + 4)) +
+                ", Front: " + GetIdxText(PeekUint16(portableBytes, portableOffset + 6)) + " */\n";
+        offset += nodeSize;
+    }
+
+    text += "};\n";
+    return text;
+}
@@ -0,0 +1,119 @@
+//
+//  BspCompiler.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef BspCompiler_hpp
+#define BspCompiler_hpp
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BspTree.hpp"
+#include "CostModel.hpp"
+#include "MapFile.hpp"
+
+// builds BSP trees from lists of walls, and serializes them in the format read by
+// BspTree::LoadBin()
+//
+// this runs offline, so it can afford to try many different trees and keep the best one - the
+// game can only hold a small number of nodes in RAM, and every level of depth costs stack on the
+// embedded hardware, so trees with fewer nodes (i.e. fewer walls split into pieces) and less
+// depth are better, but what matters most for the frame rate is how many nodes have to be
+// visited before the screen is full (see CostModel)
+class BspCompiler
+{
+public:
+    BspCompiler() = delete;
+    ~BspCompiler() = delete;
+
+    class Node
+    {
+    public:
+        WallSeg wall;
+        std::unique_ptr<Node> back;
+        std::unique_ptr<Node> front;
+    };
+
+    enum class Strategy
+    {
+        // at every node, split with the wall that splits the fewest others, and best balances
+        // the walls in front of and behind it
+        Greedy,
+        // builds the greedy tree, and then many more trees, each picking at random among the few
+        // best-scoring walls at every node - keeps the one with the fewest nodes, and then the
+        // least depth
+        Random,
+        // builds the same trees as Random, but keeps the one with the lowest cost: the average
+        // number of nodes visited per frame (see CostModel), plus penalties for split walls and
+        // for depth beyond what the device can load
+        Cost
+    };
+
+    class Options
+    {
+    public:
+        Strategy strategy {Strategy::Cost};
+        size_t numTrials {200};   // trees to build for Strategy::Random and Strategy::Cost
+        uint32_t seed {1};        // (the same seed always gives the same tree)
+        size_t maxCandidates {64}; // walls scored as splitters at each node (all of them if there are fewer)
+
+        CostModel::Options costOptions;
+        double splitCost {0.5f};  // added to the cost for each wall that is split
+        double depthCost {100.0f}; // added to the cost for each level of depth too many for the device
+
+        // the limits of the BspTree builds that the tree is for (the device's, by default)
+        size_t maxNodes {SmallBspTreeLimits::MaxNodes};
+        size_t maxVertices {SmallBspTreeLimits::MaxVertices};
+        size_t maxDepth {SmallBspTreeLimits::MaxDepth};
+    };
+
+    class Stats
+    {
+    public:
+        size_t numWalls;  // walls in the input
+        size_t numNodes;  // walls in the tree (including pieces of split walls)
+        size_t numSplits; // walls that were split
+        size_t numVertices; // distinct wall end points
+        size_t depth;     // walls on the longest path from the root
+        double avgNodesVisited; // per frame, over the cost model's camera poses
+        double cost;      // as for Strategy::Cost
+    };
+
+    static std::unique_ptr<Node> Build(const std::vector<WallSeg>& walls, const Options& options, Stats& stats);
+    static void GetStats(const Node* root, size_t numWalls, Stats& stats);
+    // walks the tree from each of the cost model's poses, as BspTree::TraverseRender() does
+    static double GetAvgNodesVisited(const Node* root, CostModel& costModel);
+
+    // the tree's walls in the order they are serialized
+    static void GetWalls(const Node* root, std::vector<WallSeg>& walls);
+
+    // the layouts of the serialized tree's sections (see BspTree.hpp)
+    enum class Layout
+    {
+        Portable,
+        Native, // little-endian, which loads faster (BspTree::SerFlagNative)
+        Compact // varints and 16 bit coordinates, which take much less flash (BspTree::SerFlagCompact)
+    };
+
+    // the number of fractional bits that a compact tree's coordinates have - the fewest that give
+    // every vertex exactly, or if no number of bits does that (within 16 bits), the most that fit,
+    // with isExact false
+    // (false if the coordinates don't fit in 16 bits even as whole numbers)
+    static bool GetCompactScale(const Node* root, uint8_t& fracBits, bool& isExact);
+
+    // in the format read by BspTree::LoadBin() (empty for Layout::Compact if GetCompactScale()
+    // fails)
+    static std::vector<uint8_t> Serialize(const Node* root, Layout layout = Layout::Portable);
+    // reads either the format written by Serialize() (checked as BspTree::CheckBin() does), or
+    // the older formats from before the container, before nodes had bounding boxes, or before
+    // the tree had a vertex table (so that old maps can still be read)
+    static bool Deserialize(const std::vector<uint8_t>& bytes, std::unique_ptr<Node>& root, std::string& error);
+    // as a C array for PROGMEM, formatted as in BspTreeBin.cpp
+    static std::string ToCArray(const Node* root, const std::string& name, Layout layout = Layout::Portable);
+};
+
+#endif /* BspCompiler_hpp */
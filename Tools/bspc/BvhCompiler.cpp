@@ -0,0 +1,161 @@
+//
+//  BvhCompiler.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include "BvhCompiler.hpp"
+#include "Fixed.hpp"
+#include "Serializer.hpp"
+
+namespace
+{
+    // (see WallBvh.hpp)
+    constexpr size_t CrcOffset {12};
+    constexpr size_t CountsOffset {16};
+
+    void AppendInt(std::vector<uint8_t>& bytes, int32_t n)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+            bytes.push_back(static_cast<uint8_t>(static_cast<uint32_t>(n) >> shift));
+    }
+
+    void AppendUint16(std::vector<uint8_t>& bytes, uint16_t n)
+    {
+        bytes.push_back(static_cast<uint8_t>(n >> 8));
+        bytes.push_back(static_cast<uint8_t>(n));
+    }
+
+    uint16_t PeekUint16(const std::vector<uint8_t>& bytes, size_t offset)
+    {
+        return static_cast<uint16_t>((bytes[offset] << 8) | bytes[offset + 1]);
+    }
+
+    void SetUint(std::vector<uint8_t>& bytes, size_t offset, uint32_t n)
+    {
+        for (size_t i = 0; i < 4; i++)
+            bytes[offset + i] = static_cast<uint8_t>(n >> (24 - 8 * i));
+    }
+
+    void AppendBytes(std::string& text, const std::vector<uint8_t>& bytes, size_t offset, size_t count)
+    {
+        char byteText[8];
+        for (size_t i = offset; i < offset + count; i++)
+        {
+            snprintf(byteText, sizeof(byteText), "0x%02x, ", bytes[i]);
+            text += byteText;
+        }
+    }
+
+    // (as the depth of the deepest leaf below the node, relative to the node)
+    size_t GetDepth(const WallBvh::Node* nodes, uint16_t nodeIdx)
+    {
+        const WallBvh::Node& node {nodes[nodeIdx]};
+        if (node.numWalls > 0)
+            return 0;
+        return 1 + std::max(GetDepth(nodes, static_cast<uint16_t>(nodeIdx + 1)), GetDepth(nodes, node.first));
+    }
+}
+
+std::vector<uint8_t> BvhCompiler::Serialize(const std::vector<WallSeg>& walls, Stats& stats)
+{
+    stats = {};
+    if (walls.empty() || (walls.size() > WallBvh::MaxWalls))
+        return {};
+
+    std::vector<Wall> gameWalls;
+    for (const WallSeg& wall : walls)
+        gameWalls.push_back({{{static_cast<Scalar>(wall.p1.x), static_cast<Scalar>(wall.p1.y)},
+                              {static_cast<Scalar>(wall.p2.x), static_cast<Scalar>(wall.p2.y)}}});
+    WallBvh bvh;
+    bvh.Build(gameWalls.data(), gameWalls.size());
+    const WallBvh::Node* nodes {bvh.GetNodes()};
+
+    std::vector<uint8_t> bytes;
+    AppendInt(bytes, static_cast<int32_t>(WallBvh::SerMagic));
+    AppendUint16(bytes, WallBvh::SerVersion);
+    AppendUint16(bytes, 0);
+    AppendInt(bytes, 0); // (size and CRC, which are filled in at the end)
+    AppendInt(bytes, 0);
+    AppendUint16(bytes, bvh.GetNumWalls());
+    AppendUint16(bytes, bvh.GetNumNodes());
+
+    // (the boxes are rounded outwards, so that they still hold their walls in fixed point)
+    for (uint16_t nodeIdx = 0; nodeIdx < bvh.GetNumNodes(); nodeIdx++)
+    {
+        const WallBvh::Node& node {nodes[nodeIdx]};
+        const double coords[] {node.boxMin.x, node.boxMin.y, node.boxMax.x, node.boxMax.y};
+        for (size_t i = 0; i < 4; i++)
+        {
+            int32_t encoding {Fixed(coords[i]).GetEncoding()};
+            if ((i < 2) && (Fixed::Unfixed(encoding) > coords[i]))
+                encoding--;
+            else if ((i >= 2) && (Fixed::Unfixed(encoding) < coords[i]))
+                encoding++;
+            AppendInt(bytes, encoding);
+        }
+        AppendUint16(bytes, node.first);
+        AppendUint16(bytes, node.numWalls);
+
+        stats.numNodes++;
+        if (node.numWalls > 0)
+        {
+            stats.numLeaves++;
+            stats.maxLeafWalls = std::max(stats.maxLeafWalls, static_cast<size_t>(node.numWalls));
+        }
+    }
+    for (uint16_t i = 0; i < bvh.GetNumWalls(); i++)
+        AppendUint16(bytes, bvh.GetWallIdxs()[i]);
+    stats.depth = GetDepth(nodes, 0);
+
+    SetUint(bytes, 8, static_cast<uint32_t>(bytes.size()));
+    const uint32_t headCrc {Serializer::Crc32(bytes.data(), 0, CrcOffset)};
+    SetUint(bytes, CrcOffset, Serializer::Crc32(bytes.data(), CrcOffset + 4, bytes.size() - (CrcOffset + 4), headCrc));
+    return bytes;
+}
+
+std::string BvhCompiler::ToCArray(const std::vector<WallSeg>& walls, const std::string& name)
+{
+    // (as for BspCompiler::ToCArray(), this is laid out from the serialized data itself)
+    Stats stats;
+    const std::vector<uint8_t> bytes {Serialize(walls, stats)};
+    if (bytes.empty())
+        return {};
+    const uint16_t numWalls {PeekUint16(bytes, CountsOffset)};
+    const uint16_t numNodes {PeekUint16(bytes, CountsOffset + 2)};
+    char text64[64];
+
+    std::string text {"const unsigned char " + name + "[] PROGMEM =\n{\n"};
+    text += "    /* Header */ ";
+    AppendBytes(text, bytes, 0, CountsOffset);
+    snprintf(text64, sizeof(text64), "Version: %u, Size: %u, CRC: 0x%08x", PeekUint16(bytes, 4),
+             static_cast<uint32_t>(Serializer::PeekInt(bytes.data(), 8)), static_cast<uint32_t>(Serializer::PeekInt(bytes.data(), CrcOffset)));
+    text += " /* " + std::string(text64) + " */\n";
+    text += "    /* Counts */ ";
+    AppendBytes(text, bytes, CountsOffset, 4);
+    text += " /* Walls: " + std::to_string(numWalls) + ", Nodes: " + std::to_string(numNodes) + " */\n";
+
+    size_t offset {WallBvh::SerHeaderSize};
+    for (uint16_t nodeIdx = 0; nodeIdx < numNodes; nodeIdx++, offset += WallBvh::SerNodeSize)
+    {
+        size_t numberOffset {offset};
+        const double minX {Serializer::DeSerDouble(bytes.data(), numberOffset)};
+        const double minY {Serializer::DeSerDouble(bytes.data(), numberOffset)};
+        const double maxX {Serializer::DeSerDouble(bytes.data(), numberOffset)};
+        const double maxY {Serializer::DeSerDouble(bytes.data(), numberOffset)};
+        const uint16_t first {PeekUint16(bytes, numberOffset)};
+        const uint16_t count {PeekUint16(bytes, numberOffset + 2)};
+        text += "    /* Node: " + std::to_string(nodeIdx) + " */ ";
+        AppendBytes(text, bytes, offset, WallBvh::SerNodeSize);
+        snprintf(text64, sizeof(text64), "(%.6g, %.6g) - (%.6g, %.6g)", minX, minY, maxX, maxY);
+        text += " /* " + std::string(text64) + ((count > 0) ? ", Walls: " + std::to_string(first) + " + " + std::to_string(count) :
+                                                              ", Children: " + std::to_string(nodeIdx + 1) + ", " + std::to_string(first)) + " */\n";
+    }
+    text += "    /* Walls */ ";
+    AppendBytes(text, bytes, offset, bytes.size() - offset);
+    text += "\n};\n";
+    return text;
+}
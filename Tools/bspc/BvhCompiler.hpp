@@ -0,0 +1,42 @@
+//
+//  BvhCompiler.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef BvhCompiler_hpp
+#define BvhCompiler_hpp
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MapFile.hpp"
+#include "WallBvh.hpp"
+
+// builds bounding volume hierarchies over lists of walls (with WallBvh::Build(), as the game
+// would at startup, but in double precision), and serializes them in the format read by
+// WallBvh::LoadBin() - the walls are referred to by their index in the list, so the game's
+// array of walls must be in the same order
+class BvhCompiler
+{
+public:
+    BvhCompiler() = delete;
+    ~BvhCompiler() = delete;
+
+    class Stats
+    {
+    public:
+        size_t numNodes {0};
+        size_t numLeaves {0};
+        size_t maxLeafWalls {0}; // the most walls in any leaf
+        size_t depth {0};        // the most levels below the root
+    };
+
+    // (empty if there are no walls, or too many - see WallBvh::MaxWalls)
+    static std::vector<uint8_t> Serialize(const std::vector<WallSeg>& walls, Stats& stats);
+    // the serialized tree as a C array for PROGMEM, with comments
+    static std::string ToCArray(const std::vector<WallSeg>& walls, const std::string& name);
+};
+
+#endif /* BvhCompiler_hpp */
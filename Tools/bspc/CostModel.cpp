@@ -0,0 +1,156 @@
+//
+//  CostModel.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "CostModel.hpp"
+
+namespace
+{
+    typedef _Vec2<double> Point;
+
+    // as in BspRenderer
+    constexpr double NearPlaneDist {0.05f};
+}
+
+CostModel::CostModel(const std::vector<WallSeg>& walls, const Options& options):
+    camera{{0.0f, 0.0f}},
+    covered(options.screenWidth),
+    numOpen{0},
+    screenWidth{options.screenWidth},
+    screenXScale{camera.viewPlaneDist / (camera.viewPlaneWidth / 2.0f) * static_cast<double>(options.screenWidth / 2)}
+{
+    if (walls.empty() || (options.gridSize == 0))
+        return;
+
+    Point min {walls[0].p1}, max {walls[0].p1};
+    for (const WallSeg& wall : walls)
+    {
+        for (const Point& p : {wall.p1, wall.p2})
+        {
+            min = {std::min(min.x, p.x), std::min(min.y, p.y)};
+            max = {std::max(max.x, p.x), std::max(max.y, p.y)};
+        }
+    }
+
+    // (the grid points are at the middles of the grid's cells, so none are right on the
+    // outermost walls)
+    for (size_t row = 0; row < options.gridSize; row++)
+    {
+        for (size_t col = 0; col < options.gridSize; col++)
+        {
+            Point location {min.x + (max.x - min.x) * (col + 0.5f) / options.gridSize,
+                            min.y + (max.y - min.y) * (row + 0.5f) / options.gridSize};
+            if (!IsInOpenSpace(walls, location))
+                continue;
+
+            for (size_t heading = 0; heading < options.numHeadings; heading++)
+                poses.push_back({location, 2.0f * M_PI * heading / options.numHeadings});
+        }
+    }
+}
+
+void CostModel::BeginFrame(size_t poseIdx)
+{
+    camera.SetPose(poses[poseIdx].location, poses[poseIdx].headingRad);
+    std::fill(covered.begin(), covered.end(), false);
+    numOpen = screenWidth;
+}
+
+bool CostModel::DrawWall(const WallSeg& wall)
+{
+    // this follows BspRenderer::RenderWall(), but only as far as finding which columns the
+    // wall covers
+    Point viewP1 {camera.ToViewSpace(wall.p1)};
+    Point viewP2 {camera.ToViewSpace(wall.p2)};
+
+    if ((viewP1.y >= NearPlaneDist) || (viewP2.y >= NearPlaneDist))
+    {
+        if (viewP1.y < NearPlaneDist)
+            viewP1 = viewP1 + (viewP2 - viewP1) * ((NearPlaneDist - viewP1.y) / (viewP2.y - viewP1.y));
+        else if (viewP2.y < NearPlaneDist)
+            viewP2 = viewP2 + (viewP1 - viewP2) * ((NearPlaneDist - viewP2.y) / (viewP1.y - viewP2.y));
+
+        // (a front-facing wall's p1 is to the left of its p2 on the screen)
+        const double halfWidth {static_cast<double>(screenWidth / 2)};
+        // (clamped, so that walls off the edges of the screen give empty ranges)
+        const double maxX {static_cast<double>(screenWidth)};
+        const double screenX1 {std::min(std::max(viewP1.x / viewP1.y * screenXScale + halfWidth, 0.0), maxX)};
+        const double screenX2 {std::min(std::max(viewP2.x / viewP2.y * screenXScale + halfWidth, -1.0), maxX - 1.0)};
+        for (int x = static_cast<int>(screenX1); x <= static_cast<int>(screenX2); x++)
+        {
+            if (!covered[x])
+            {
+                covered[x] = true;
+                numOpen--;
+            }
+        }
+    }
+
+    return (numOpen > 0);
+}
+
+bool CostModel::IsBoxHidden(const Point& boxMin, const Point& boxMax) const
+{
+    if (numOpen == screenWidth)
+        return false;
+
+    const Point corners[] {boxMin, {boxMax.x, boxMin.y}, boxMax, {boxMin.x, boxMax.y}};
+    const double halfWidth {static_cast<double>(screenWidth / 2)};
+    double fromX {static_cast<double>(screenWidth - 1)};
+    double toX {0.0f};
+    for (const Point& corner : corners)
+    {
+        Point viewP {camera.ToViewSpace(corner)};
+        if (viewP.y < NearPlaneDist)
+            return false;
+
+        double screenX {viewP.x / viewP.y * screenXScale + halfWidth};
+        fromX = std::min(fromX, screenX);
+        toX = std::max(toX, screenX);
+    }
+
+    // (one more column on each side, as in BspRenderer)
+    const int lastX {screenWidth - 1};
+    const int from {std::min(std::max(static_cast<int>(fromX) - 1, 0), lastX)};
+    const int to {std::min(std::max(static_cast<int>(toX) + 1, 0), lastX)};
+    for (int x = from; x <= to; x++)
+        if (!covered[x])
+            return false;
+    return true;
+}
+
+bool CostModel::IsInOpenSpace(const std::vector<WallSeg>& walls, const Point& p)
+{
+    const Point dirs[] {{1.0f, 0.0f}, {0.0f, 1.0f}, {-1.0f, 0.0f}, {0.0f, -1.0f}};
+    for (const Point& dir : dirs)
+    {
+        // the closest wall in this direction
+        const WallSeg* closest {nullptr};
+        double closestT {std::numeric_limits<double>::max()};
+        for (const WallSeg& wall : walls)
+        {
+            Point wallDir {wall.p2 - wall.p1};
+            double denom {dir.cross(wallDir)};
+            if (fabs(denom) < 1e-12)
+                continue;
+            double t {(wall.p1 - p).cross(wallDir) / denom};
+            double u {(wall.p1 - p).cross(dir) / denom};
+            if ((t > 0.0f) && (u >= 0.0f) && (u <= 1.0f) && (t < closestT))
+            {
+                closest = &wall;
+                closestT = t;
+            }
+        }
+
+        // (see GeomUtils::IsPointInFrontOfLine())
+        if (!closest || ((p - closest->p1).cross(closest->p2 - closest->p1) >= 0))
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+//
+//  CostModel.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef CostModel_hpp
+#define CostModel_hpp
+
+#include <cstdint>
+#include <vector>
+#include "Camera.hpp"
+#include "MapFile.hpp"
+
+// for estimating how expensive a BSP tree is to render: a set of camera poses spread over a map,
+// and a stand-in for BspRenderer that only keeps track of which screen columns have been drawn
+//
+// a tree is walked from each pose the same way that BspTree::TraverseRender() does (front to
+// back, skipping subtrees outside the field of view or hidden by what's already drawn), passing its walls to DrawWall() until
+// the screen is full - different trees for the same walls can differ a lot in how many nodes
+// that takes, depending on how soon the walls closest to the camera are reached (wall heights,
+// lighting, etc. don't affect which nodes are visited, so they aren't modeled)
+class CostModel
+{
+public:
+    class Options
+    {
+    public:
+        size_t gridSize {12};   // camera locations are sampled on a gridSize x gridSize grid over the map
+        size_t numHeadings {8}; // headings per location
+        uint8_t screenWidth {128};
+    };
+
+    // only locations in open space (i.e. where the walls closest in each direction face the
+    // camera) are used, so that walls that can't be seen from inside the map don't count
+    CostModel(const std::vector<WallSeg>& walls, const Options& options);
+    ~CostModel() = default;
+
+    size_t GetNumPoses() const { return poses.size(); }
+    void BeginFrame(size_t poseIdx);
+    const _Vec2<double>& GetCameraLoc() const { return camera.location; }
+
+    // (see Camera::IsBoxOutsideView())
+    bool IsBoxOutsideView(const _Vec2<double>& boxMin, const _Vec2<double>& boxMax) const { return camera.IsBoxOutsideView(boxMin, boxMax); }
+    // as BspRenderer::IsBoxHidden()
+    bool IsBoxHidden(const _Vec2<double>& boxMin, const _Vec2<double>& boxMax) const;
+    // returns false once every column has been drawn (as BspRenderer::RenderWall() does)
+    bool DrawWall(const WallSeg& wall);
+
+private:
+    class Pose
+    {
+    public:
+        _Vec2<double> location;
+        double headingRad;
+    };
+
+    static bool IsInOpenSpace(const std::vector<WallSeg>& walls, const _Vec2<double>& p);
+
+    std::vector<Pose> poses;
+    Camera camera;
+    std::vector<bool> covered;
+    size_t numOpen;
+    const uint8_t screenWidth;
+    const double screenXScale; // as in BspRenderer
+};
+
+#endif /* CostModel_hpp */
@@ -0,0 +1,197 @@
+//
+//  MapFile.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "MapFile.hpp"
+#include "BspCompiler.hpp"
+
+namespace
+{
+    bool EndsWith(const std::string& s, const std::string& suffix)
+    {
+        return ((s.size() >= suffix.size()) && (s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0));
+    }
+}
+
+bool MapFile::GetFormat(const std::string& fileName, Format& format)
+{
+    if (EndsWith(fileName, ".txt"))
+        format = Format::Text;
+    else if (EndsWith(fileName, ".dxf") || EndsWith(fileName, ".DXF"))
+        format = Format::Dxf;
+    else if (EndsWith(fileName, ".bin"))
+        format = Format::Bin;
+    else
+        return false;
+    return true;
+}
+
+bool MapFile::Load(const std::string& fileName, Format format, std::vector<WallSeg>& walls, std::string& error)
+{
+    std::vector<uint8_t> bytes;
+    if (!ReadFile(fileName, bytes, error))
+        return false;
+
+    switch (format)
+    {
+    case Format::Text:
+        return LoadText(std::string(bytes.begin(), bytes.end()), walls, error);
+    case Format::Dxf:
+        return LoadDxf(std::string(bytes.begin(), bytes.end()), walls, error);
+    case Format::Bin:
+        return LoadBin(bytes, walls, error);
+    }
+    return false;
+}
+
+bool MapFile::LoadText(const std::string& text, std::vector<WallSeg>& walls, std::string& error)
+{
+    std::istringstream lines {text};
+    std::string line;
+    size_t lineNum {0};
+    while (std::getline(lines, line))
+    {
+        lineNum++;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields {line};
+        double x1, y1, x2, y2;
+        if (!(fields >> x1))
+        {
+            // (blank, or only a comment)
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+        }
+        else if ((fields >> y1 >> x2 >> y2) && !(fields >> std::ws).good())
+        {
+            walls.push_back({{x1, y1}, {x2, y2}});
+            continue;
+        }
+
+        error = "line " + std::to_string(lineNum) + ": expected \"x1 y1 x2 y2\"";
+        return false;
+    }
+    return true;
+}
+
+bool MapFile::LoadDxf(const std::string& text, std::vector<WallSeg>& walls, std::string& error)
+{
+    // a DXF file is a list of (group code, value) pairs, one per line - entities start with
+    // group code 0, and coordinates are group codes 10/20 (first point) and 11/21 (second point)
+    std::istringstream lines {text};
+    std::vector<std::pair<int, std::string>> pairs;
+    std::string codeLine, valueLine;
+    while (std::getline(lines, codeLine) && std::getline(lines, valueLine))
+    {
+        std::istringstream code {codeLine};
+        int groupCode;
+        if (!(code >> groupCode))
+        {
+            error = "malformed group code \"" + codeLine + "\"";
+            return false;
+        }
+        size_t end {valueLine.find_last_not_of(" \t\r")};
+        size_t start {valueLine.find_first_not_of(" \t\r")};
+        pairs.push_back({groupCode, (end == std::string::npos) ? "" : valueLine.substr(start, end - start + 1)});
+    }
+
+    size_t numEntities {0};
+    for (size_t i = 0; i < pairs.size(); i++)
+    {
+        if ((pairs[i].first != 0) || ((pairs[i].second != "LINE") && (pairs[i].second != "LWPOLYLINE")))
+            continue;
+
+        const bool isPolyline {pairs[i].second == "LWPOLYLINE"};
+        std::vector<_Vec2<double>> points;
+        double x {0.0f};
+        bool closed {false};
+        for (i++; (i < pairs.size()) && (pairs[i].first != 0); i++)
+        {
+            const int groupCode {pairs[i].first};
+            const double value {atof(pairs[i].second.c_str())};
+            if ((groupCode == 10) || (groupCode == 11))
+                x = value;
+            else if ((groupCode == 20) || (groupCode == 21))
+                points.push_back({x, value});
+            else if (isPolyline && (groupCode == 70))
+                closed = ((atoi(pairs[i].second.c_str()) & 1) != 0);
+        }
+        i--;
+
+        if (points.size() < 2)
+        {
+            error = "entity " + std::to_string(numEntities) + " has fewer than 2 points";
+            return false;
+        }
+        for (size_t p = 0; p + 1 < points.size(); p++)
+            walls.push_back({points[p], points[p + 1]});
+        if (closed && (points.size() > 2))
+            walls.push_back({points.back(), points.front()});
+        numEntities++;
+    }
+
+    if (numEntities == 0)
+    {
+        error = "no LINE or LWPOLYLINE entities found";
+        return false;
+    }
+    return true;
+}
+
+bool MapFile::LoadBin(const std::vector<uint8_t>& bytes, std::vector<WallSeg>& walls, std::string& error)
+{
+    std::unique_ptr<BspCompiler::Node> root;
+    if (!BspCompiler::Deserialize(bytes, root, error))
+        return false;
+    BspCompiler::GetWalls(root.get(), walls);
+    return true;
+}
+
+std::string MapFile::ToText(const std::vector<WallSeg>& walls)
+{
+    std::string text {"# x1 y1 x2 y2 (the front of each wall is to the right, looking from p1 to p2)\n"};
+    char line[128];
+    for (const WallSeg& wall : walls)
+    {
+        snprintf(line, sizeof(line), "%.9g %.9g %.9g %.9g\n", wall.p1.x, wall.p1.y, wall.p2.x, wall.p2.y);
+        text += line;
+    }
+    return text;
+}
+
+bool MapFile::ReadFile(const std::string& fileName, std::vector<uint8_t>& bytes, std::string& error)
+{
+    std::ifstream file {fileName, std::ios::binary};
+    if (!file)
+    {
+        error = "can't open " + fileName;
+        return false;
+    }
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool MapFile::WriteFile(const std::string& fileName, const std::vector<uint8_t>& bytes, std::string& error)
+{
+    std::ofstream file {fileName, std::ios::binary};
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file)
+    {
+        error = "can't write " + fileName;
+        return false;
+    }
+    return true;
+}
+
+bool MapFile::WriteFile(const std::string& fileName, const std::string& text, std::string& error)
+{
+    return WriteFile(fileName, std::vector<uint8_t>(text.begin(), text.end()), error);
+}
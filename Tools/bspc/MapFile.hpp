@@ -0,0 +1,58 @@
+//
+//  MapFile.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef MapFile_hpp
+#define MapFile_hpp
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Line.hpp"
+
+// walls are always handled in double precision by the tools, whatever the game uses
+typedef _Line<double> WallSeg;
+
+// reading and writing lists of walls in the formats that bspc understands:
+//
+// * text: one wall per line, as "x1 y1 x2 y2" - blank lines and anything after a '#' are
+//   ignored - the front of a wall is to the right when looking from p1 to p2 (see
+//   GeomUtils::IsPointInFrontOfLine())
+// * DXF: the LINE and LWPOLYLINE entities of a (minimal, ASCII) DXF file, as exported by most
+//   CAD and vector drawing programs - everything else in the file is ignored
+// * bin: a tree that has already been serialized for BspTree::LoadBin() (such as the arrays in
+//   BspTreeBin.cpp), or in one of the older formats (see
+//   BspCompiler::Deserialize()), so that existing maps can be recompiled
+class MapFile
+{
+public:
+    MapFile() = delete;
+    ~MapFile() = delete;
+
+    enum class Format
+    {
+        Text,
+        Dxf,
+        Bin
+    };
+
+    // from the file name's extension (.txt, .dxf or .bin)
+    static bool GetFormat(const std::string& fileName, Format& format);
+
+    // these return false (with a message in "error") if the file can't be read or parsed
+    static bool Load(const std::string& fileName, Format format, std::vector<WallSeg>& walls, std::string& error);
+    static bool LoadText(const std::string& text, std::vector<WallSeg>& walls, std::string& error);
+    static bool LoadDxf(const std::string& text, std::vector<WallSeg>& walls, std::string& error);
+    static bool LoadBin(const std::vector<uint8_t>& bytes, std::vector<WallSeg>& walls, std::string& error);
+
+    static std::string ToText(const std::vector<WallSeg>& walls);
+
+    static bool ReadFile(const std::string& fileName, std::vector<uint8_t>& bytes, std::string& error);
+    static bool WriteFile(const std::string& fileName, const std::vector<uint8_t>& bytes, std::string& error);
+    static bool WriteFile(const std::string& fileName, const std::string& text, std::string& error);
+};
+
+#endif /* MapFile_hpp */
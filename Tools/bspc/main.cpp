@@ -0,0 +1,252 @@
+//
+//  main.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+// bspc - compiles a map (a list of walls) into a BSP tree for the game
+//
+// usage: bspc [options] input
+//   --format F      the input's format: text, dxf or bin (default: from the file extension)
+//   -o file         write the serialized tree, as read by BspTree::LoadBin()
+//   --c-array file  write the serialized tree as a C array, for BspTreeBin.cpp
+//   --name name     the C array's name (default: the input's base name + "BspTree")
+//   --walls file    write the tree's walls (including split pieces) in the text format
+//   --strategy S    greedy, random or cost (default: cost) - see BspCompiler::Strategy
+//   --trials N      trees to build with the random and cost strategies (default 200)
+//   --seed N        seed for the random and cost strategies (default 1)
+//   --keep-tree     for a bin input, keep its tree as it is rather than building a new one (e.g.
+//                   to convert a tree from the old format)
+//   --large         the tree is for builds with LargeBspTrees defined (e.g. the PC build), rather
+//                   than for the device - see BspTree.hpp
+//   --native        write the tree with little-endian sections (BspTree::SerFlagNative), which
+//                   load faster
+//   --compact       write the tree with varints and 16 bit coordinates (BspTree::SerFlagCompact),
+//                   which take much less flash, but can't be used in place - coordinates are
+//                   rounded if they need more precision than 16 bits allow (with a warning)
+//   --bvh file      also write a bounding volume hierarchy over the input's walls, as read by
+//                   WallBvh::LoadBin() (for Raycaster::Search::Bvh) - it refers to the walls by
+//                   their order in the input
+//   --bvh-c-array file
+//                   the same, as a C array (named after the input's base name + "Bvh")
+//
+// the tree's statistics are always printed (including the average number of nodes visited per
+// frame, as estimated by CostModel), with a warning if it is too big for the device (or for
+// LargeBspTrees builds)
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BspCompiler.hpp"
+#include "BspTree.hpp"
+#include "BvhCompiler.hpp"
+#include "MapFile.hpp"
+
+namespace
+{
+    void PrintUsage(const char* programName)
+    {
+        std::cerr << "usage: " << programName << " [--format text|dxf|bin] [-o file] [--c-array file] [--name name]" << std::endl;
+        std::cerr << "       [--walls file] [--strategy greedy|random|cost] [--trials N] [--seed N] [--keep-tree] [--large] [--native|--compact]" << std::endl;
+        std::cerr << "       [--bvh file] [--bvh-c-array file] input" << std::endl;
+    }
+
+    std::string GetBaseName(const std::string& fileName)
+    {
+        size_t start {fileName.find_last_of("/\\")};
+        start = (start == std::string::npos) ? 0 : start + 1;
+        size_t end {fileName.find_last_of('.')};
+        if ((end == std::string::npos) || (end < start))
+            end = fileName.size();
+        return fileName.substr(start, end - start);
+    }
+}
+
+int main(int argc, const char * argv[])
+{
+    BspCompiler::Options options;
+    std::string inFileName, formatName, binFileName, cArrayFileName, arrayName, wallsFileName;
+    std::string bvhFileName, bvhCArrayFileName;
+    std::string strategyName {"cost"};
+    bool keepTree {false};
+    BspCompiler::Layout layout {BspCompiler::Layout::Portable};
+    std::string targetName {"the device"};
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue {i + 1 < argc};
+        if (!strcmp(argv[i], "--format") && hasValue)
+            formatName = argv[++i];
+        else if (!strcmp(argv[i], "-o") && hasValue)
+            binFileName = argv[++i];
+        else if (!strcmp(argv[i], "--c-array") && hasValue)
+            cArrayFileName = argv[++i];
+        else if (!strcmp(argv[i], "--name") && hasValue)
+            arrayName = argv[++i];
+        else if (!strcmp(argv[i], "--walls") && hasValue)
+            wallsFileName = argv[++i];
+        else if (!strcmp(argv[i], "--bvh") && hasValue)
+            bvhFileName = argv[++i];
+        else if (!strcmp(argv[i], "--bvh-c-array") && hasValue)
+            bvhCArrayFileName = argv[++i];
+        else if (!strcmp(argv[i], "--strategy") && hasValue)
+            strategyName = argv[++i];
+        else if (!strcmp(argv[i], "--trials") && hasValue)
+            options.numTrials = static_cast<size_t>(strtoul(argv[++i], nullptr, 10));
+        else if (!strcmp(argv[i], "--seed") && hasValue)
+            options.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (!strcmp(argv[i], "--keep-tree"))
+            keepTree = true;
+        else if (!strcmp(argv[i], "--large"))
+        {
+            options.maxNodes = LargeBspTreeLimits::MaxNodes;
+            options.maxVertices = LargeBspTreeLimits::MaxVertices;
+            options.maxDepth = LargeBspTreeLimits::MaxDepth;
+            targetName = "LargeBspTrees builds";
+        }
+        else if (!strcmp(argv[i], "--native") && (layout == BspCompiler::Layout::Portable))
+            layout = BspCompiler::Layout::Native;
+        else if (!strcmp(argv[i], "--compact") && (layout == BspCompiler::Layout::Portable))
+            layout = BspCompiler::Layout::Compact;
+        else if ((argv[i][0] != '-') && inFileName.empty())
+            inFileName = argv[i];
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (strategyName == "greedy")
+        options.strategy = BspCompiler::Strategy::Greedy;
+    else if (strategyName == "random")
+        options.strategy = BspCompiler::Strategy::Random;
+    else if (strategyName == "cost")
+        options.strategy = BspCompiler::Strategy::Cost;
+    else
+        inFileName.clear();
+
+    if (inFileName.empty())
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    MapFile::Format format;
+    if (formatName == "text")
+        format = MapFile::Format::Text;
+    else if (formatName == "dxf")
+        format = MapFile::Format::Dxf;
+    else if (formatName == "bin")
+        format = MapFile::Format::Bin;
+    else if (!formatName.empty() || !MapFile::GetFormat(inFileName, format))
+    {
+        std::cerr << "unknown format for " << inFileName << " (use --format)" << std::endl;
+        return 1;
+    }
+
+    std::string error;
+    std::vector<WallSeg> walls;
+    if (!MapFile::Load(inFileName, format, walls, error))
+    {
+        std::cerr << inFileName << ": " << error << std::endl;
+        return 1;
+    }
+
+    BspCompiler::Stats stats;
+    std::unique_ptr<BspCompiler::Node> root;
+    if (keepTree)
+    {
+        std::vector<uint8_t> bytes;
+        if ((format != MapFile::Format::Bin) || !MapFile::ReadFile(inFileName, bytes, error) ||
+            !BspCompiler::Deserialize(bytes, root, error))
+        {
+            std::cerr << inFileName << ": " << (error.empty() ? "--keep-tree needs a bin input" : error) << std::endl;
+            return 1;
+        }
+        CostModel costModel {walls, options.costOptions};
+        BspCompiler::GetStats(root.get(), walls.size(), stats);
+        stats.avgNodesVisited = BspCompiler::GetAvgNodesVisited(root.get(), costModel);
+    }
+    else
+    {
+        root = BspCompiler::Build(walls, options, stats);
+    }
+
+    std::cout << "walls: " << stats.numWalls << std::endl;
+    std::cout << "nodes: " << stats.numNodes << " (" << stats.numSplits << " from splits)" << std::endl;
+    std::cout << "vertices: " << stats.numVertices << std::endl;
+    std::cout << "depth: " << stats.depth << std::endl;
+    std::cout << "avg. nodes visited: " << stats.avgNodesVisited << " per frame" << std::endl;
+
+    // (these are only the limits of the format as loaded - a tree that is within them may still
+    // not fit in the device's RAM along with everything else)
+    if (stats.numNodes > options.maxNodes)
+        std::cerr << "warning: more than " << options.maxNodes << " nodes - too many for " << targetName << std::endl;
+    if (stats.numVertices > options.maxVertices)
+        std::cerr << "warning: more than " << options.maxVertices << " vertices - too many for " << targetName << std::endl;
+    if (stats.depth > options.maxDepth)
+        std::cerr << "warning: deeper than " << options.maxDepth << " - too deep for " << targetName << std::endl;
+
+    if (layout == BspCompiler::Layout::Compact)
+    {
+        uint8_t fracBits;
+        bool isExact;
+        if (!BspCompiler::GetCompactScale(root.get(), fracBits, isExact))
+        {
+            std::cerr << "the map is too big for --compact (coordinates must fit in 16 bits)" << std::endl;
+            return 1;
+        }
+        std::cout << "compact coordinates: " << static_cast<int>(fracBits) << " fractional bits" << std::endl;
+        if (!isExact)
+            std::cerr << "warning: some coordinates are rounded to fit in 16 bits" << std::endl;
+    }
+
+    if (arrayName.empty())
+        arrayName = GetBaseName(inFileName) + "BspTree";
+
+    if ((!binFileName.empty() && !MapFile::WriteFile(binFileName, BspCompiler::Serialize(root.get(), layout), error)) ||
+        (!cArrayFileName.empty() && !MapFile::WriteFile(cArrayFileName, BspCompiler::ToCArray(root.get(), arrayName, layout), error)))
+    {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    if (!bvhFileName.empty() || !bvhCArrayFileName.empty())
+    {
+        BvhCompiler::Stats bvhStats;
+        const std::vector<uint8_t> bvhBytes {BvhCompiler::Serialize(walls, bvhStats)};
+        if (bvhBytes.empty())
+        {
+            std::cerr << "the map has too many walls for --bvh (at most " << WallBvh::MaxWalls << ")" << std::endl;
+            return 1;
+        }
+        std::cout << "bvh nodes: " << bvhStats.numNodes << " (" << bvhStats.numLeaves << " leaves, at most "
+                  << bvhStats.maxLeafWalls << " walls each)" << std::endl;
+        std::cout << "bvh depth: " << bvhStats.depth << std::endl;
+
+        if ((!bvhFileName.empty() && !MapFile::WriteFile(bvhFileName, bvhBytes, error)) ||
+            (!bvhCArrayFileName.empty() &&
+             !MapFile::WriteFile(bvhCArrayFileName, BvhCompiler::ToCArray(walls, GetBaseName(inFileName) + "Bvh"), error)))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    if (!wallsFileName.empty())
+    {
+        std::vector<WallSeg> treeWalls;
+        BspCompiler::GetWalls(root.get(), treeWalls);
+        if (!MapFile::WriteFile(wallsFileName, MapFile::ToText(treeWalls), error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
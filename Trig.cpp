@@ -0,0 +1,311 @@
+//
+//  Trig.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifdef SDLSim // should be set as a compiler flag on simulation builds
+#define PROGMEM
+#else
+#include <avr/pgmspace.h>
+#endif
+#include <math.h>
+#include "Trig.hpp"
+
+constexpr Trig::Angle Trig::EighthTurn;
+constexpr Trig::Angle Trig::QuarterTurn;
+constexpr Trig::Angle Trig::HalfTurn;
+constexpr double Trig::AnglesPerRad;
+
+namespace
+{
+    static_assert((TrigTableBits >= 2) && (TrigTableBits <= 12), "TrigTableBits must be between 2 and 12");
+
+    // each table covers its range in (1 << TrigTableBits) steps - the entry for the end of the
+    // range isn't stored, as it is always a round number (1.0, or an eighth of a turn)
+    constexpr uint16_t TableSize {1 << TrigTableBits};
+    constexpr double Pi {3.14159265358979323846};
+
+    // sine/tangent table entries are the fractional part of a 16.16 fixed-point number
+    // (they are all less than 1.0), and arctangent entries are binary angles
+    constexpr double EntryOne {65536.0f};
+    constexpr uint32_t EndOfRangeOne {0x10000};
+    constexpr uint32_t EndOfRangeEighthTurn {0x2000};
+    // (arcsine entries have one more bit of fraction than a binary angle, and their range ends at
+    // a twelfth of a turn, which isn't round in either, so it is rounded)
+    constexpr uint32_t EndOfRangeTwelfthTurn {0x2AAB};
+
+    // the functions used to generate the tables - these only have to work over the range
+    // covered by the tables, and are only ever evaluated by the compiler
+    // (C++11 constexpr functions can only be a single return statement, hence the recursion)
+
+    // sin(x) by its Taylor series, which converges quickly for 0 <= x <= pi/2
+    constexpr double SinTerms(double x, double term, int n)
+    {
+        return ((n > 10) ? 0.0f : (term + SinTerms(x, -term * x * x / ((2 * n + 2) * (2 * n + 3)), n + 1)));
+    }
+    constexpr double ConstSin(double x)
+    {
+        return SinTerms(x, x, 0);
+    }
+    constexpr double ConstTan(double x)
+    {
+        return (ConstSin(x) / ConstSin(Pi / 2.0f - x));
+    }
+
+    // atan(x) by Euler's series, which converges quickly for 0 <= x <= 1:
+    // atan(x) = sum over n of (2^2n * (n!)^2 / (2n + 1)!) * x^(2n + 1) / (1 + x^2)^(n + 1)
+    constexpr double AtanTerms(double xSqRatio, double term, int n)
+    {
+        return ((n > 40) ? 0.0f : (term + AtanTerms(xSqRatio, term * (2 * n + 2) / (2 * n + 3) * xSqRatio, n + 1)));
+    }
+    constexpr double ConstAtan(double x)
+    {
+        return AtanTerms(x * x / (1.0f + x * x), x / (1.0f + x * x), 0);
+    }
+
+    // asin(x) by its Taylor series, which converges quickly for 0 <= x <= 1/2:
+    // asin(x) = sum over n of ((2n)! / (2^2n * (n!)^2 * (2n + 1))) * x^(2n + 1)
+    constexpr double AsinTerms(double xSq, double power, double coeff, int n)
+    {
+        return ((n > 30) ? 0.0f : (coeff * power / (2 * n + 1) + AsinTerms(xSq, power * xSq, coeff * (2 * n + 1) / (2 * n + 2), n + 1)));
+    }
+    constexpr double ConstAsin(double x)
+    {
+        return AsinTerms(x * x, x, 1.0f, 0);
+    }
+
+    // (entries just short of 1.0 can round up to it with the larger table sizes, so those are
+    // kept just short of it instead)
+    constexpr uint16_t Round(double n)
+    {
+        return ((n + 0.5f >= 65535.0f) ? 0xFFFF : static_cast<uint16_t>(n + 0.5f));
+    }
+
+    // entry i of each table
+    // sine: angles from 0 to a quarter turn
+    constexpr uint16_t SinEntry(uint16_t i)
+    {
+        return Round(ConstSin(Pi / 2.0f * i / TableSize) * EntryOne);
+    }
+    // tangent: angles from 0 to an eighth of a turn
+    constexpr uint16_t TanEntry(uint16_t i)
+    {
+        return Round(ConstTan(Pi / 4.0f * i / TableSize) * EntryOne);
+    }
+    // arctangent: ratios from 0 to 1, giving binary angles from 0 to an eighth of a turn
+    constexpr uint16_t AtanEntry(uint16_t i)
+    {
+        return Round(ConstAtan(static_cast<double>(i) / TableSize) * (32768.0f / Pi));
+    }
+    // arcsine: values from 0 to 1/2, giving angles from 0 to a twelfth of a turn, in halves of a
+    // binary angle (so that doubling one doesn't double its rounding error)
+    constexpr uint16_t AsinEntry(uint16_t i)
+    {
+        return Round(ConstAsin(0.5f * i / TableSize) * (65536.0f / Pi));
+    }
+
+    // a list of indices 0..N-1 as a parameter pack, to expand into the table initializers
+    // (std::make_index_sequence isn't available in C++11, or without the standard library - this
+    // is built by halves, so the template nesting depth is only log2(N))
+    template<uint16_t... Is>
+    class IndexList
+    {
+    };
+
+    template<typename L1, typename L2>
+    class ConcatIndexLists;
+
+    template<uint16_t... I1s, uint16_t... I2s>
+    class ConcatIndexLists<IndexList<I1s...>, IndexList<I2s...>>
+    {
+    public:
+        typedef IndexList<I1s..., static_cast<uint16_t>(sizeof...(I1s) + I2s)...> Type;
+    };
+
+    template<uint16_t N>
+    class MakeIndexList
+    {
+    public:
+        typedef typename ConcatIndexLists<typename MakeIndexList<N / 2>::Type,
+                                          typename MakeIndexList<N - N / 2>::Type>::Type Type;
+    };
+
+    template<>
+    class MakeIndexList<0>
+    {
+    public:
+        typedef IndexList<> Type;
+    };
+
+    template<>
+    class MakeIndexList<1>
+    {
+    public:
+        typedef IndexList<0> Type;
+    };
+
+    class Table
+    {
+    public:
+        uint16_t entries[TableSize];
+    };
+
+    template<uint16_t (*Entry)(uint16_t), uint16_t... Is>
+    constexpr Table MakeTable(IndexList<Is...>)
+    {
+        return {{ Entry(Is)... }};
+    }
+
+    const Table sinTable PROGMEM = MakeTable<SinEntry>(MakeIndexList<TableSize>::Type());
+    const Table tanTable PROGMEM = MakeTable<TanEntry>(MakeIndexList<TableSize>::Type());
+    const Table atanTable PROGMEM = MakeTable<AtanEntry>(MakeIndexList<TableSize>::Type());
+    const Table asinTable PROGMEM = MakeTable<AsinEntry>(MakeIndexList<TableSize>::Type());
+
+    uint16_t ReadEntry(const Table& table, uint16_t idx)
+    {
+#ifdef SDLSim
+        return table.entries[idx];
+#else
+        return pgm_read_word(&table.entries[idx]);
+#endif
+    }
+
+    uint32_t GetEntry(const Table& table, uint16_t idx, uint32_t endOfRange)
+    {
+        return ((idx < TableSize) ? ReadEntry(table, idx) : endOfRange);
+    }
+
+    // looks up a table position given with "fracBits" bits of fraction past the table index,
+    // interpolating linearly (and rounding) between entries
+    uint32_t Lookup(const Table& table, uint32_t pos, uint8_t fracBits, uint32_t endOfRange)
+    {
+        uint16_t idx {static_cast<uint16_t>(pos >> fracBits)};
+        uint32_t frac {pos & ((static_cast<uint32_t>(1) << fracBits) - 1)};
+        uint32_t entry {GetEntry(table, idx, endOfRange)};
+        if (frac == 0)
+            return entry;
+
+        // (entries only ever increase)
+        uint32_t diff {GetEntry(table, idx + 1, endOfRange) - entry};
+        return (entry + ((diff * frac + (static_cast<uint32_t>(1) << (fracBits - 1))) >> fracBits));
+    }
+
+    Scalar FromEntry(uint32_t entry, bool negative)
+    {
+        Fixed f {Fixed::FromEncoding(static_cast<int32_t>(entry))};
+        return static_cast<Scalar>(negative ? -f : f);
+    }
+
+    // the bits of fraction past the table index for a binary angle within a quarter turn
+    // (14 bits), or within an eighth of a turn (13 bits)
+    constexpr uint8_t QuarterFracBits {14 - TrigTableBits};
+    constexpr uint8_t EighthFracBits {13 - TrigTableBits};
+
+    // 2 * asin() of a value from 0 to 1/2 as a binary angle, looked up straight from its 16 bits of
+    // fraction (15 of which cover the table's range)
+    uint32_t TwiceAsinUpToHalf(Scalar n)
+    {
+        return Lookup(asinTable, static_cast<uint32_t>(Fixed(n).GetEncoding()), 15 - TrigTableBits, EndOfRangeTwelfthTurn);
+    }
+}
+
+Trig::Angle Trig::FromRadians(Fixed angleRad)
+{
+    // 2^32 / (2 * pi), i.e. the number of binary angles per radian, with 16 more bits of fraction
+    // than a Fixed encoding has (so the angle ends up in the upper 32 bits of the product)
+    constexpr int64_t anglesPerRad {683565276};
+    int64_t angle {(static_cast<int64_t>(angleRad.GetEncoding()) * anglesPerRad + (static_cast<int64_t>(1) << 31)) >> 32};
+    return static_cast<Angle>(angle);
+}
+
+Fixed Trig::ToFixedRadians(Angle angle)
+{
+    // 2 * pi in 16.16 fixed point, i.e. the number of radians per binary angle, with 16 more bits
+    // of fraction than a Fixed encoding has
+    constexpr int64_t radsPerAngle {411775};
+    return Fixed::FromEncoding(static_cast<int32_t>((static_cast<int64_t>(angle) * radsPerAngle + (1 << 15)) >> 16));
+}
+
+Scalar Trig::Sin(Angle angle)
+{
+    // (the table is only a quarter of a wave, so use symmetry for the rest)
+    bool negative {(angle & HalfTurn) != 0};
+    uint16_t withinQuarter {static_cast<uint16_t>(angle & (QuarterTurn - 1))};
+    if (angle & QuarterTurn)
+        withinQuarter = QuarterTurn - withinQuarter;
+
+    return FromEntry(Lookup(sinTable, withinQuarter, QuarterFracBits, EndOfRangeOne), negative);
+}
+
+Scalar Trig::Tan(Angle angle)
+{
+    // tan() repeats every half turn, and tan(-a) = -tan(a)
+    uint16_t withinHalf {static_cast<uint16_t>(angle & (HalfTurn - 1))};
+    bool negative {withinHalf > QuarterTurn};
+    if (negative)
+        withinHalf = HalfTurn - withinHalf;
+
+    // (the table only goes up to an eighth of a turn - past that, tan(a) = 1 / tan(quarter turn - a))
+    if (withinHalf <= EighthTurn)
+        return FromEntry(Lookup(tanTable, withinHalf, EighthFracBits, EndOfRangeOne), negative);
+
+    uint32_t cotEntry {Lookup(tanTable, QuarterTurn - withinHalf, EighthFracBits, EndOfRangeOne)};
+    if (cotEntry == 0)
+        return (negative ? -ScalarMax : ScalarMax);
+    Scalar cot {FromEntry(cotEntry, false)};
+    return (negative ? (-1 / cot) : (1 / cot));
+}
+
+Trig::Angle Trig::Atan2(Scalar y, Scalar x)
+{
+    Scalar absX {x < 0 ? -x : x};
+    Scalar absY {y < 0 ? -y : y};
+    if ((absX == 0) && (absY == 0))
+        return 0;
+
+    // find the angle within the first octant (where the ratio is between 0 and 1), then use
+    // symmetry to get to the right one
+    // (the ratio is converted to 16 bits of fraction to use as a table position)
+    Angle angle;
+    if (absY <= absX)
+    {
+        uint32_t ratio {static_cast<uint32_t>(Fixed(absY / absX).GetEncoding())};
+        angle = static_cast<Angle>(Lookup(atanTable, ratio, 16 - TrigTableBits, EndOfRangeEighthTurn));
+    }
+    else
+    {
+        uint32_t ratio {static_cast<uint32_t>(Fixed(absX / absY).GetEncoding())};
+        angle = static_cast<Angle>(QuarterTurn - Lookup(atanTable, ratio, 16 - TrigTableBits, EndOfRangeEighthTurn));
+    }
+
+    if (x < 0)
+        angle = static_cast<Angle>(HalfTurn - angle);
+    if (y < 0)
+        angle = static_cast<Angle>(-angle);
+    return angle;
+}
+
+Trig::Angle Trig::Acos(Scalar n)
+{
+    if (n >= 1)
+        return 0;
+    if (n <= -1)
+        return HalfTurn;
+
+    // acos(-n) = half turn - acos(n)
+    bool negative {n < 0};
+    Scalar absN {negative ? -n : n};
+
+    // up to 1/2, acos(n) = quarter turn - asin(n) - past that, asin() gets too steep to interpolate
+    // (it has an infinite slope at 1), so use acos(n) = 2 * asin(sqrt((1 - n) / 2)) instead, where
+    // the square root is at most 1/2 (this is the only path that needs a square root)
+    Angle angle;
+    if (absN <= 0.5f)
+        angle = static_cast<Angle>(QuarterTurn - ((TwiceAsinUpToHalf(absN) + 1) >> 1));
+    else
+        angle = static_cast<Angle>(TwiceAsinUpToHalf(sqrt((1 - absN) / 2)));
+
+    return (negative ? static_cast<Angle>(HalfTurn - angle) : angle);
+}
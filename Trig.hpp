@@ -0,0 +1,77 @@
+//
+//  Trig.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef Trig_hpp
+#define Trig_hpp
+
+#include <stdint.h>
+#include "Scalar.hpp"
+
+// the number of entries per table is (1 << TrigTableBits) - more bits means more accuracy, but
+// each table takes (2 << TrigTableBits) bytes of flash (there are four tables)
+// with the default of 8 and linear interpolation between entries, sines and cosines are accurate
+// to within about one unit in the last place of a 16.16 fixed-point number, which is plenty for
+// this program
+#ifndef TrigTableBits
+#define TrigTableBits 8
+#endif
+
+// trig. functions by table lookup (the tables are generated at compile time, and are kept in
+// flash on the embedded hardware) - these avoid the floating point math library, which is very
+// slow on the embedded hardware, and work directly with fixed-point numbers
+//
+// angles are "binary angles": a full turn is 0x10000, so they wrap around by themselves with
+// ordinary unsigned integer arithmetic, and finding the quadrant of an angle is a bit test
+class Trig
+{
+public:
+    Trig() = delete;
+    ~Trig() = delete;
+
+    typedef uint16_t Angle;
+
+    static constexpr Angle EighthTurn {0x2000};
+    static constexpr Angle QuarterTurn {0x4000};
+    static constexpr Angle HalfTurn {0x8000};
+
+    // (conversions round to the nearest angle, and any number of turns is fine)
+    static constexpr Angle FromRadians(double angleRad)
+    {
+        return static_cast<Angle>(static_cast<int32_t>(angleRad * AnglesPerRad + (angleRad < 0.0f ? -0.5f : 0.5f)));
+    }
+    static Angle FromRadians(Fixed angleRad);
+    static constexpr double ToRadians(Angle angle)
+    {
+        return (static_cast<double>(angle) / AnglesPerRad);
+    }
+    // (as above, but by an integer multiply and shift, with no floating point)
+    static Fixed ToFixedRadians(Angle angle);
+    // (whichever of the two Scalar is)
+    static Scalar ToScalarRadians(Angle angle)
+    {
+#ifdef FixedPointMath
+        return ToFixedRadians(angle);
+#else
+        return ToRadians(angle);
+#endif
+    }
+
+    static Scalar Sin(Angle angle);
+    static Scalar Cos(Angle angle) { return Sin(static_cast<Angle>(angle + QuarterTurn)); }
+    // (returns ScalarMax/-ScalarMax at a quarter turn either way)
+    static Scalar Tan(Angle angle);
+
+    // the angle of the vector (x, y) from the +x axis, counterclockwise (as for atan2())
+    static Angle Atan2(Scalar y, Scalar x);
+    // (the result is between 0 and a half turn)
+    static Angle Acos(Scalar n);
+
+private:
+    static constexpr double AnglesPerRad {32768.0f / 3.14159265358979323846};
+};
+
+#endif /* Trig_hpp */
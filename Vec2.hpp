@@ -10,6 +10,7 @@
 #define Vec2_hpp
 
 #include <math.h>
+#include "Scalar.hpp"
 
 template<typename T>
 class _Vec2
@@ -38,15 +39,15 @@ public:
         *this = *this - rhs;
         return *this;
     }
-    _Vec2& operator-() const
+    _Vec2 operator-() const
     {
-        return (*this * static_cast<T>(-1));
+        return _Vec2(-x, -y);
     }
     _Vec2 operator*(const T& rhs) const
     {
         return _Vec2(x * rhs, y * rhs);
     }
-    _Vec2& operator*=(const _Vec2& rhs)
+    _Vec2& operator*=(const T& rhs)
     {
         *this = *this * rhs;
         return *this;
@@ -55,7 +56,7 @@ public:
     {
         return _Vec2(x / rhs, y / rhs);
     }
-    _Vec2& operator/=(const _Vec2& rhs)
+    _Vec2& operator/=(const T& rhs)
     {
         *this = *this / rhs;
         return *this;
@@ -66,7 +67,8 @@ public:
     }
     T Mag() const
     {
-        return sqrt(MagSq());
+        // (the squared magnitude easily overflows for fixed point, so take the root of the wide version)
+        return sqrt(MagSqWide());
     }
     _Vec2 Norm() const
     {
@@ -81,12 +83,26 @@ public:
     {
         return (x * rhs.y - y * rhs.x);
     }
+    
+    // versions of the above which can't overflow (see Wide in Fixed.hpp)
+    typename Wide<T>::Type MagSqWide() const
+    {
+        return (Wide<T>::Mul(x, x) + Wide<T>::Mul(y, y));
+    }
+    typename Wide<T>::Type DotWide(const _Vec2& rhs) const
+    {
+        return (Wide<T>::Mul(x, rhs.x) + Wide<T>::Mul(y, rhs.y));
+    }
+    typename Wide<T>::Type CrossWide(const _Vec2& rhs) const
+    {
+        return (Wide<T>::Mul(x, rhs.y) - Wide<T>::Mul(y, rhs.x));
+    }
     ~_Vec2() = default;
 
 public:
     T x, y;
 };
 
-typedef _Vec2<double> Vec2;
+typedef _Vec2<Scalar> Vec2;
 
 #endif /* Vec2_hpp */
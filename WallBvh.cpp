@@ -0,0 +1,423 @@
+//
+//  WallBvh.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <stdlib.h>
+#include "Serializer.hpp"
+#include "WallBvh.hpp"
+
+constexpr size_t WallBvh::MaxWalls;
+constexpr uint8_t WallBvh::MaxDepth;
+constexpr uint32_t WallBvh::SerMagic;
+constexpr uint16_t WallBvh::SerVersion;
+constexpr size_t WallBvh::SerHeaderSize;
+constexpr size_t WallBvh::SerNodeSize;
+constexpr size_t WallBvh::UnknownBinSize;
+
+namespace
+{
+    constexpr size_t SerCrcOffset {12};
+    constexpr size_t SerCrcSize {4};
+
+    // walls are put in boxes over the centers of this many equal slices of the widest side of
+    // the box of the walls' centers, and the best split is only looked for between slices (which
+    // is nearly as good as trying every split, and much quicker)
+    constexpr uint8_t NumBins {8};
+    // the cost of visiting a node, relative to testing a wall
+    constexpr float TraversalCost {1.0f};
+
+    // every box is a little bigger than its walls, so that a ray that hits a wall right on the
+    // edge of its box (e.g. a wall along an axis, whose box has no width) never misses the box
+    // because of rounding
+    constexpr Scalar BoxMargin {1.0f / 256.0f};
+
+    float GetHalfPerimeter(const Vec2& boxMin, const Vec2& boxMax)
+    {
+        return static_cast<float>(boxMax.x - boxMin.x) + static_cast<float>(boxMax.y - boxMin.y);
+    }
+
+    void AddToBox(const Vec2& p, Vec2& boxMin, Vec2& boxMax)
+    {
+        boxMin = {(p.x < boxMin.x) ? p.x : boxMin.x, (p.y < boxMin.y) ? p.y : boxMin.y};
+        boxMax = {(p.x > boxMax.x) ? p.x : boxMax.x, (p.y > boxMax.y) ? p.y : boxMax.y};
+    }
+
+    // (halved first, so that it can't overflow)
+    Vec2 GetCenter(const Wall& wall)
+    {
+        return wall.seg.p1 * 0.5f + wall.seg.p2 * 0.5f;
+    }
+}
+
+// (as in BspTree)
+[[noreturn]] void WallBvh::Error()
+{
+    while (1) {}
+}
+
+WallBvh::WallBvh():
+    nodes{nullptr},
+    numNodes{0},
+    wallIdxs{nullptr},
+    numWalls{0}
+{
+}
+
+WallBvh::~WallBvh()
+{
+    Free();
+}
+
+void WallBvh::Build(const Wall walls[], size_t numWalls)
+{
+    Free();
+    if ((numWalls == 0) || (numWalls > MaxWalls))
+        return;
+
+    // (a tree with a wall in each leaf has 2n - 1 nodes, and the leaves usually have a few, so
+    // the nodes are shrunk to fit afterwards)
+    wallIdxs = static_cast<WallIdx*>(malloc(sizeof(WallIdx) * numWalls));
+    nodes = static_cast<Node*>(malloc(sizeof(Node) * (numWalls * 2 - 1)));
+    if (!wallIdxs || !nodes)
+        WallBvh::Error();
+    for (size_t wallIdx = 0; wallIdx < numWalls; wallIdx++)
+        wallIdxs[wallIdx] = static_cast<WallIdx>(wallIdx);
+    this->numWalls = static_cast<uint16_t>(numWalls);
+
+    // the nodes are built in preorder without recursion - each task is a range of walls still to
+    // be made into a subtree, and the node whose second child it is (whose index isn't known
+    // until its first child's subtree is done)
+    // (there is at most one task waiting for each level, plus the current node's two children)
+    constexpr uint16_t NoParent {0xFFFF};
+    struct
+    {
+        uint16_t first;
+        uint16_t count;
+        uint16_t parentIdx;
+        uint8_t depth;
+    } tasks[MaxDepth + 2];
+    uint8_t numTasks {0};
+    tasks[numTasks++] = {0, static_cast<uint16_t>(numWalls), NoParent, 0};
+    while (numTasks > 0)
+    {
+        numTasks--;
+        const uint16_t first {tasks[numTasks].first};
+        const uint16_t count {tasks[numTasks].count};
+        const uint8_t depth {tasks[numTasks].depth};
+        if (tasks[numTasks].parentIdx != NoParent)
+            nodes[tasks[numTasks].parentIdx].first = numNodes;
+
+        Node& node {nodes[numNodes]};
+        node.boxMin = node.boxMax = walls[wallIdxs[first]].seg.p1;
+        for (uint16_t i = first; i < first + count; i++)
+        {
+            AddToBox(walls[wallIdxs[i]].seg.p1, node.boxMin, node.boxMax);
+            AddToBox(walls[wallIdxs[i]].seg.p2, node.boxMin, node.boxMax);
+        }
+        node.boxMin = {node.boxMin.x - BoxMargin, node.boxMin.y - BoxMargin};
+        node.boxMax = {node.boxMax.x + BoxMargin, node.boxMax.y + BoxMargin};
+
+        const uint16_t numFirst {(depth < MaxDepth) ? Split(walls, first, count, node) : static_cast<uint16_t>(0)};
+        if (numFirst == 0)
+        {
+            node.first = first;
+            node.numWalls = count;
+        }
+        else
+        {
+            node.numWalls = 0;
+            tasks[numTasks++] = {static_cast<uint16_t>(first + numFirst), static_cast<uint16_t>(count - numFirst),
+                                 numNodes, static_cast<uint8_t>(depth + 1)};
+            tasks[numTasks++] = {first, numFirst, NoParent, static_cast<uint8_t>(depth + 1)};
+        }
+        numNodes++;
+    }
+
+    Node* const fitted {static_cast<Node*>(realloc(nodes, sizeof(Node) * numNodes))};
+    if (fitted)
+        nodes = fitted;
+}
+
+WallBvh::BinStatus WallBvh::CheckBin(const uint8_t* bytes, size_t size, size_t numWalls)
+{
+    if (size < SerHeaderSize)
+        return BinStatus::BadSize;
+
+    size_t offset {0};
+    if (Serializer::DeSerUint(bytes, offset) != SerMagic)
+        return BinStatus::BadMagic;
+    if (Serializer::DeSerUint16(bytes, offset) != SerVersion)
+        return BinStatus::BadVersion;
+    if (Serializer::DeSerUint16(bytes, offset) != 0)
+        return BinStatus::BadFlags;
+
+    const uint32_t binSize {Serializer::DeSerUint(bytes, offset)};
+    if ((binSize < SerHeaderSize) || (binSize > size))
+        return BinStatus::BadSize;
+    const uint32_t crc {Serializer::DeSerUint(bytes, offset)};
+    const uint32_t headCrc {Serializer::Crc32(bytes, 0, SerCrcOffset)};
+    const size_t tailOffset {SerCrcOffset + SerCrcSize};
+    if (Serializer::Crc32(bytes, tailOffset, static_cast<size_t>(binSize) - tailOffset, headCrc) != crc)
+        return BinStatus::BadChecksum;
+
+    const uint16_t binNumWalls {Serializer::DeSerUint16(bytes, offset)};
+    const uint16_t binNumNodes {Serializer::DeSerUint16(bytes, offset)};
+    if ((binNumWalls == 0) || (binNumWalls != numWalls))
+        return BinStatus::BadWalls;
+    if (binSize != SerHeaderSize + binNumNodes * SerNodeSize + binNumWalls * sizeof(WallIdx))
+        return BinStatus::BadSize;
+
+    const size_t wallIdxsOffset {SerHeaderSize + binNumNodes * SerNodeSize};
+    for (offset = wallIdxsOffset; offset < binSize; )
+        if (Serializer::DeSerUint16(bytes, offset) >= numWalls)
+            return BinStatus::BadWalls;
+
+    // the nodes must make up a single tree, in preorder, that is no deeper than WalkRay()'s stack
+    // allows - it is walked depth first, which must visit the nodes in order, with the second
+    // children waiting on a stack just like WalkRay()'s (which pushes one at every node above a
+    // leaf, so it is each node's depth that has to be checked, not just the size of this stack)
+    struct
+    {
+        uint16_t nodeIdx;
+        uint8_t depth;
+    } seconds[MaxDepth];
+    uint8_t numSeconds {0};
+    uint16_t nodeIdx {0};
+    uint8_t depth {0};
+    for (uint16_t nextIdx = 0; nextIdx < binNumNodes; nextIdx++)
+    {
+        if (nodeIdx != nextIdx)
+            return BinStatus::BadNode;
+
+        offset = SerHeaderSize + nodeIdx * SerNodeSize + 16;
+        const uint16_t first {Serializer::DeSerUint16(bytes, offset)};
+        const uint16_t count {Serializer::DeSerUint16(bytes, offset)};
+        if (count > 0)
+        {
+            if (first + count > binNumWalls)
+                return BinStatus::BadNode;
+            if (numSeconds > 0)
+            {
+                numSeconds--;
+                nodeIdx = seconds[numSeconds].nodeIdx;
+                depth = seconds[numSeconds].depth;
+            }
+            else if (nextIdx + 1 < binNumNodes)
+            {
+                return BinStatus::BadNode;
+            }
+        }
+        else
+        {
+            // (a node this deep must be a leaf)
+            if ((first <= nodeIdx + 1) || (first >= binNumNodes) || (depth >= MaxDepth))
+                return BinStatus::BadNode;
+            depth++;
+            seconds[numSeconds++] = {first, depth};
+            nodeIdx++;
+        }
+    }
+    return ((binNumNodes > 0) && (numSeconds == 0)) ? BinStatus::Ok : BinStatus::BadNode;
+}
+
+void WallBvh::LoadBin(const uint8_t* bytes, size_t numWalls)
+{
+    Free();
+
+    if (CheckBin(bytes, UnknownBinSize, numWalls) != BinStatus::Ok)
+        WallBvh::Error();
+
+    size_t offset {SerHeaderSize - 4};
+    this->numWalls = Serializer::DeSerUint16(bytes, offset);
+    numNodes = Serializer::DeSerUint16(bytes, offset);
+    nodes = static_cast<Node*>(malloc(sizeof(Node) * numNodes));
+    wallIdxs = static_cast<WallIdx*>(malloc(sizeof(WallIdx) * this->numWalls));
+    if (!nodes || !wallIdxs)
+        WallBvh::Error();
+
+    for (uint16_t nodeIdx = 0; nodeIdx < numNodes; nodeIdx++)
+    {
+        Node& node {nodes[nodeIdx]};
+        node.boxMin.x = static_cast<Scalar>(Serializer::DeSerFixed(bytes, offset));
+        node.boxMin.y = static_cast<Scalar>(Serializer::DeSerFixed(bytes, offset));
+        node.boxMax.x = static_cast<Scalar>(Serializer::DeSerFixed(bytes, offset));
+        node.boxMax.y = static_cast<Scalar>(Serializer::DeSerFixed(bytes, offset));
+        node.first = Serializer::DeSerUint16(bytes, offset);
+        node.numWalls = Serializer::DeSerUint16(bytes, offset);
+    }
+    for (uint16_t i = 0; i < this->numWalls; i++)
+        wallIdxs[i] = Serializer::DeSerUint16(bytes, offset);
+}
+
+bool WallBvh::FindClosestHit(const Wall walls[], const Line& ray, WallIdx& wallIdx, Scalar& t) const
+{
+    bool isHit {false};
+    t = ScalarMax;
+    WalkRay(ray, ScalarMax, [walls, &ray, &isHit, &wallIdx, &t](const WallIdx* leafWallIdxs, uint16_t numLeafWalls)
+    {
+        for (uint16_t i = 0; i < numLeafWalls; i++)
+        {
+            Vec2 intersection;
+            Scalar hitT, u;
+            if (GeomUtils::FindRayLineSegIntersection(ray, walls[leafWallIdxs[i]].seg, intersection, hitT, u) && (hitT < t))
+            {
+                isHit = true;
+                wallIdx = leafWallIdxs[i];
+                t = hitT;
+            }
+        }
+        return t;
+    });
+    return isHit;
+}
+
+bool WallBvh::HasAnyHit(const Wall walls[], const Line& seg) const
+{
+    bool isHit {false};
+    WalkRay(seg, 1.0f, [walls, &seg, &isHit](const WallIdx* leafWallIdxs, uint16_t numLeafWalls)
+    {
+        for (uint16_t i = 0; (i < numLeafWalls) && !isHit; i++)
+        {
+            Vec2 intersection;
+            Scalar t, u;
+            isHit = (GeomUtils::FindRayLineSegIntersection(seg, walls[leafWallIdxs[i]].seg, intersection, t, u) && (t <= 1.0f));
+        }
+        return (isHit ? -1.0f : 1.0f);
+    });
+    return isHit;
+}
+
+void WallBvh::Free()
+{
+    free(nodes);
+    free(wallIdxs);
+    nodes = nullptr;
+    wallIdxs = nullptr;
+    numNodes = 0;
+    numWalls = 0;
+}
+
+uint16_t WallBvh::Split(const Wall walls[], uint16_t first, uint16_t count, const Node& node)
+{
+    if (count < 2)
+        return 0;
+
+    // the slices are across whichever side of the walls' centers' box is wider
+    Vec2 centersMin {GetCenter(walls[wallIdxs[first]])};
+    Vec2 centersMax {centersMin};
+    for (uint16_t i = first; i < first + count; i++)
+        AddToBox(GetCenter(walls[wallIdxs[i]]), centersMin, centersMax);
+    const bool isAlongX {(centersMax.x - centersMin.x) >= (centersMax.y - centersMin.y)};
+    const Scalar sliceMin {isAlongX ? centersMin.x : centersMin.y};
+    const Scalar sliceWidth {isAlongX ? centersMax.x - centersMin.x : centersMax.y - centersMin.y};
+    if (sliceWidth <= 0.0f)
+        return 0;
+    auto getBin = [isAlongX, sliceMin, sliceWidth](const Wall& wall)
+    {
+        const Vec2 center {GetCenter(wall)};
+        const Scalar bin {((isAlongX ? center.x : center.y) - sliceMin) / sliceWidth * static_cast<Scalar>(NumBins)};
+        const uint8_t binIdx {static_cast<uint8_t>(bin)};
+        return ((binIdx < NumBins) ? binIdx : static_cast<uint8_t>(NumBins - 1));
+    };
+
+    // the box and number of the walls whose centers are in each slice
+    struct
+    {
+        Vec2 boxMin;
+        Vec2 boxMax;
+        uint16_t count;
+    } bins[NumBins];
+    for (uint8_t bin = 0; bin < NumBins; bin++)
+        bins[bin].count = 0;
+    for (uint16_t i = first; i < first + count; i++)
+    {
+        const Line& seg {walls[wallIdxs[i]].seg};
+        auto& bin = bins[getBin(walls[wallIdxs[i]])];
+        if (bin.count++ == 0)
+            bin.boxMin = bin.boxMax = seg.p1;
+        AddToBox(seg.p1, bin.boxMin, bin.boxMax);
+        AddToBox(seg.p2, bin.boxMin, bin.boxMax);
+    }
+
+    // the cost of each split (the walls that would be tested for a ray that hits the node,
+    // relative to the node's perimeter) is the number of walls on each side times how likely the
+    // ray is to hit that side's box - the sides after each split are added up from the end first
+    // (the costs are floats, as a count times a perimeter could overflow fixed point, and the
+    // tree is only built once)
+    float secondCosts[NumBins];
+    uint16_t secondCount {0};
+    Vec2 secondMin {0.0f, 0.0f}, secondMax {0.0f, 0.0f};
+    for (uint8_t bin = NumBins - 1; bin > 0; bin--)
+    {
+        if (bins[bin].count > 0)
+        {
+            if (secondCount == 0)
+            {
+                secondMin = bins[bin].boxMin;
+                secondMax = bins[bin].boxMax;
+            }
+            AddToBox(bins[bin].boxMin, secondMin, secondMax);
+            AddToBox(bins[bin].boxMax, secondMin, secondMax);
+            secondCount += bins[bin].count;
+        }
+        secondCosts[bin] = static_cast<float>(secondCount) * GetHalfPerimeter(secondMin, secondMax);
+    }
+
+    const float nodeHalfPerimeter {GetHalfPerimeter(node.boxMin, node.boxMax)};
+    float bestCost {static_cast<float>(count) * nodeHalfPerimeter};
+    uint8_t bestBin {0};
+    uint16_t firstCount {0};
+    Vec2 firstMin {0.0f, 0.0f}, firstMax {0.0f, 0.0f};
+    for (uint8_t bin = 0; bin < NumBins - 1; bin++)
+    {
+        if (bins[bin].count > 0)
+        {
+            if (firstCount == 0)
+            {
+                firstMin = bins[bin].boxMin;
+                firstMax = bins[bin].boxMax;
+            }
+            AddToBox(bins[bin].boxMin, firstMin, firstMax);
+            AddToBox(bins[bin].boxMax, firstMin, firstMax);
+            firstCount += bins[bin].count;
+        }
+        if ((firstCount == 0) || (firstCount == count))
+            continue;
+        const float cost {TraversalCost * nodeHalfPerimeter + static_cast<float>(firstCount) * GetHalfPerimeter(firstMin, firstMax) +
+                          secondCosts[bin + 1]};
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            bestBin = static_cast<uint8_t>(bin + 1);
+        }
+    }
+    if (bestBin == 0)
+        return 0;
+
+    // the walls in the slices before the split go first
+    uint16_t numFirst {0};
+    for (uint16_t i = first; i < first + count; i++)
+    {
+        if (getBin(walls[wallIdxs[i]]) < bestBin)
+        {
+            const WallIdx wallIdx {wallIdxs[i]};
+            wallIdxs[i] = wallIdxs[first + numFirst];
+            wallIdxs[first + numFirst] = wallIdx;
+            numFirst++;
+        }
+    }
+    return numFirst;
+}
+
+bool WallBvh::GetEntryT(const Node& node, const Vec2& p, const Vec2& d, Scalar& entryT)
+{
+    // (only the part of the ray in front of its start is wanted)
+    Scalar tLeave {ScalarMax};
+    entryT = 0.0f;
+    GeomUtils::ClipRayToSlab(p.x, d.x, node.boxMin.x, node.boxMax.x, entryT, tLeave);
+    GeomUtils::ClipRayToSlab(p.y, d.y, node.boxMin.y, node.boxMax.y, entryT, tLeave);
+    return (entryT <= tLeave);
+}
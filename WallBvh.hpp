@@ -0,0 +1,198 @@
+//
+//  WallBvh.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef WallBvh_hpp
+#define WallBvh_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include "GeomUtils.hpp"
+#include "Line.hpp"
+#include "Wall.hpp"
+
+// a bounding volume hierarchy over a map's walls - a binary tree of boxes, each of which holds
+// all of the walls below it, so that a ray only has to be tested against the walls in the boxes
+// that it passes through (about log2 of the number of walls of them, for a ray that hits
+// something soon), however the walls are spread over the map
+//
+// unlike WallGrid, this suits sparse or irregular maps (e.g. a few big rooms joined by long
+// corridors), where a grid's cells are either mostly empty or hold too many walls each
+//
+// the tree is built by the surface area heuristic (the box whose walls are most likely to be hit,
+// i.e. the one with the biggest perimeter in 2D, is the one that should hold the fewest of them) -
+// either here, or offline by bspc (see Tools/bspc/BvhCompiler.hpp), which serializes it for
+// LoadBin() so that the device doesn't have to build it
+//
+// serialized format (all numbers are big-endian, and coordinates are 16.16 fixed point - see
+// Fixed.hpp):
+//   header: magic (4 bytes, SerMagic), format version (2 bytes, SerVersion), flags (2 bytes, none
+//           defined yet - a loader rejects any), size of the whole container (4 bytes), CRC-32 of
+//           the whole container apart from this field (4 bytes), number of walls (2 bytes - the
+//           map that the tree is for must have exactly this many), number of nodes (2 bytes)
+//   nodes:  the box as min x, min y, max x, max y (4 bytes each), then for a leaf, the index of
+//           its first wall index and how many it has, or for any other node, the index of its
+//           second child and 0 (2 bytes each)
+//           - the root is node 0, and nodes are in preorder, so a node's first child is always
+//           the node after it
+//   walls:  the indices of the walls (into the map's array of walls, in the order of the leaves),
+//           one for each of the map's walls (2 bytes each)
+// (everything is checked - see CheckBin() - before anything is allocated, as in BspTree)
+class WallBvh
+{
+public:
+    typedef uint16_t WallIdx;
+
+    static constexpr size_t MaxWalls {0xFFFF};
+    // the most levels below the root, which is the size of the stack used by WalkRay() - nodes
+    // that are this deep are always leaves, however many walls they have
+    static constexpr uint8_t MaxDepth {24};
+
+    static constexpr uint32_t SerMagic {0x4256484D}; // "BVHM"
+    static constexpr uint16_t SerVersion {1};
+    static constexpr size_t SerHeaderSize {20};
+    static constexpr size_t SerNodeSize {20};
+
+    // what CheckBin() found wrong with a serialized tree
+    enum class BinStatus : uint8_t
+    {
+        Ok,
+        BadMagic,
+        BadVersion,
+        BadFlags,
+        BadSize,     // the container is bigger than the data that was given, or not the size of its contents
+        BadChecksum,
+        BadWalls,    // for a different number of walls than the map has, or a wall index out of range
+        BadNode      // a node's walls or child don't exist, its child isn't after it, or it is too deep
+    };
+    // (as for BspTree::UnknownBinSize)
+    static constexpr size_t UnknownBinSize {static_cast<size_t>(-1)};
+
+    // (the leaves' walls are wallIdxs[first] up to wallIdxs[first + numWalls], and the other
+    // nodes have no walls of their own, and their children at the next node and at first)
+    class Node
+    {
+    public:
+        Vec2 boxMin;
+        Vec2 boxMax;
+        uint16_t first;
+        uint16_t numWalls;
+    };
+
+    WallBvh();
+    ~WallBvh();
+
+    // (the tree only refers to the walls by index, so they aren't needed afterwards)
+    void Build(const Wall walls[], size_t numWalls);
+
+    // copies a serialized tree (e.g. from PROGMEM) into RAM - numWalls is the number of walls in
+    // the map that it is for
+    static BinStatus CheckBin(const uint8_t* bytes, size_t size, size_t numWalls);
+    void LoadBin(const uint8_t* bytes, size_t numWalls);
+
+    // calls visitLeaf(wallIdxs, numWalls) for the leaves whose boxes the ray passes through,
+    // nearest box first - it returns how far along the ray (as a multiple of the ray's length, as
+    // for GeomUtils::FindRayLineSegIntersection()) anything is still of interest, and boxes that
+    // start beyond that are skipped (so returning the closest hit so far finds the closest hit,
+    // and returning a negative number stops the walk)
+    template <class LeafVisitor>
+    void WalkRay(const Line& ray, Scalar maxT, LeafVisitor&& visitLeaf) const;
+
+    // the closest wall that the ray hits (false if none), and how far along the ray the hit is
+    bool FindClosestHit(const Wall walls[], const Line& ray, WallIdx& wallIdx, Scalar& t) const;
+    // whether any wall crosses the segment (for line of sight and collision tests)
+    bool HasAnyHit(const Wall walls[], const Line& seg) const;
+
+    // (for serializing the tree - see Tools/bspc/BvhCompiler.hpp)
+    const Node* GetNodes() const { return nodes; }
+    uint16_t GetNumNodes() const { return numNodes; }
+    const WallIdx* GetWallIdxs() const { return wallIdxs; }
+    uint16_t GetNumWalls() const { return numWalls; }
+
+private:
+    [[noreturn]] static void Error();
+
+    void Free();
+    // the number of walls (from first) that should go in the first child, which the walls are
+    // reordered for, or 0 if the node should be a leaf
+    uint16_t Split(const Wall walls[], uint16_t first, uint16_t count, const Node& node);
+    // where the ray enters the node's box (false if it misses it)
+    static bool GetEntryT(const Node& node, const Vec2& p, const Vec2& d, Scalar& entryT);
+
+    Node* nodes;
+    uint16_t numNodes;
+    WallIdx* wallIdxs;
+    uint16_t numWalls;
+};
+
+template <class LeafVisitor>
+void WallBvh::WalkRay(const Line& ray, Scalar maxT, LeafVisitor&& visitLeaf) const
+{
+    const Vec2 d {ray.p2 - ray.p1};
+    uint16_t nodeIdx {0};
+    Scalar entryT;
+    if (!nodes || !GetEntryT(nodes[0], ray.p1, d, entryT))
+        return;
+
+    // the far children that are still to be visited, with where the ray enters them (these are
+    // checked against maxT again when they come off of the stack, as it may have come down since)
+    struct
+    {
+        uint16_t nodeIdx;
+        Scalar entryT;
+    } stack[MaxDepth];
+    uint8_t stackSize {0};
+
+    while (true)
+    {
+        if (entryT <= maxT)
+        {
+            const Node& node {nodes[nodeIdx]};
+            if (node.numWalls > 0)
+            {
+                maxT = visitLeaf(&wallIdxs[node.first], node.numWalls);
+            }
+            else
+            {
+                uint16_t nearIdx {static_cast<uint16_t>(nodeIdx + 1)};
+                uint16_t farIdx {node.first};
+                Scalar nearT, farT;
+                const bool isNearHit {GetEntryT(nodes[nearIdx], ray.p1, d, nearT)};
+                const bool isFarHit {GetEntryT(nodes[farIdx], ray.p1, d, farT)};
+                if (isNearHit && isFarHit)
+                {
+                    if (farT < nearT)
+                    {
+                        const uint16_t idx {nearIdx};
+                        nearIdx = farIdx;
+                        farIdx = idx;
+                        const Scalar t {nearT};
+                        nearT = farT;
+                        farT = t;
+                    }
+                    // (CheckBin() and Build() keep the tree shallow enough for this)
+                    if (stackSize >= MaxDepth)
+                        WallBvh::Error();
+                    stack[stackSize++] = {farIdx, farT};
+                }
+                if (isNearHit || isFarHit)
+                {
+                    nodeIdx = isNearHit ? nearIdx : farIdx;
+                    entryT = isNearHit ? nearT : farT;
+                    continue;
+                }
+            }
+        }
+
+        if (stackSize == 0)
+            break;
+        stackSize--;
+        nodeIdx = stack[stackSize].nodeIdx;
+        entryT = stack[stackSize].entryT;
+    }
+}
+
+#endif /* WallBvh_hpp */
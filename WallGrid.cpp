@@ -0,0 +1,185 @@
+//
+//  WallGrid.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <math.h>
+#include "WallGrid.hpp"
+
+constexpr uint8_t WallGrid::MaxCellsPerSide;
+constexpr size_t WallGrid::MaxWalls;
+
+namespace
+{
+    // walls are put in every cell that they come within this fraction of a cell of, so that a
+    // wall that passes right by a corner of a cell (or along an edge of one) is never missed
+    // because of rounding
+    constexpr uint8_t CellMarginDivisor {64};
+}
+
+// (as in BspTree)
+[[noreturn]] void WallGrid::Error()
+{
+    while (1) {}
+}
+
+WallGrid::WallGrid():
+    gridMin{0.0f, 0.0f},
+    cellSize{1.0f},
+    numCols{0},
+    numRows{0},
+    cellStarts{nullptr},
+    wallIdxs{nullptr}
+{
+}
+
+WallGrid::~WallGrid()
+{
+    Free();
+}
+
+void WallGrid::Build(const Wall walls[], size_t numWalls)
+{
+    Free();
+    if ((numWalls == 0) || (numWalls > MaxWalls))
+        return;
+
+    Vec2 gridMax {walls[0].seg.p1};
+    gridMin = gridMax;
+    for (size_t wallIdx = 0; wallIdx < numWalls; wallIdx++)
+    {
+        for (uint8_t end = 0; end < 2; end++)
+        {
+            const Vec2& p {(end == 0) ? walls[wallIdx].seg.p1 : walls[wallIdx].seg.p2};
+            gridMin = {(p.x < gridMin.x) ? p.x : gridMin.x, (p.y < gridMin.y) ? p.y : gridMin.y};
+            gridMax = {(p.x > gridMax.x) ? p.x : gridMax.x, (p.y > gridMax.y) ? p.y : gridMax.y};
+        }
+    }
+
+    // about as many cells as walls (the square root of the number of walls on a side, for a
+    // square map), and a little more than the map, so that the walls on its far edges are inside
+    // the grid
+    uint8_t cellsPerSide {1};
+    while ((cellsPerSide < MaxCellsPerSide) && (static_cast<size_t>(cellsPerSide) * cellsPerSide < numWalls))
+        cellsPerSide++;
+    const Scalar width {gridMax.x - gridMin.x};
+    const Scalar height {gridMax.y - gridMin.y};
+    const Scalar size {(width > height) ? width : height};
+    cellSize = (size > 0.0f) ? (size / static_cast<Scalar>(cellsPerSide)) * 1.01f : 1.0f;
+    numCols = static_cast<uint8_t>(static_cast<int16_t>(width / cellSize) + 1);
+    numRows = static_cast<uint8_t>(static_cast<int16_t>(height / cellSize) + 1);
+    if (numCols > cellsPerSide) numCols = cellsPerSide;
+    if (numRows > cellsPerSide) numRows = cellsPerSide;
+
+    // the lists are counted first, and then filled in (from the end of each one backwards), so
+    // that exactly as much memory is allocated as the grid needs
+    const uint16_t numCells {static_cast<uint16_t>(numCols * numRows)};
+    size_t numWallIdxs {0};
+    cellStarts = static_cast<uint16_t*>(calloc(numCells + 1, sizeof(uint16_t)));
+    if (!cellStarts)
+        WallGrid::Error();
+    for (uint8_t pass = 0; pass < 2; pass++)
+    {
+        for (size_t wallIdx = 0; wallIdx < numWalls; wallIdx++)
+        {
+            const Line& seg {walls[wallIdx].seg};
+            const uint8_t fromCol {GetCell((seg.p1.x < seg.p2.x) ? seg.p1.x : seg.p2.x, gridMin.x, numCols)};
+            const uint8_t toCol {GetCell((seg.p1.x > seg.p2.x) ? seg.p1.x : seg.p2.x, gridMin.x, numCols)};
+            const uint8_t fromRow {GetCell((seg.p1.y < seg.p2.y) ? seg.p1.y : seg.p2.y, gridMin.y, numRows)};
+            const uint8_t toRow {GetCell((seg.p1.y > seg.p2.y) ? seg.p1.y : seg.p2.y, gridMin.y, numRows)};
+            for (uint8_t row = (fromRow > 0) ? fromRow - 1 : 0; (row <= toRow + 1) && (row < numRows); row++)
+            {
+                for (uint8_t col = (fromCol > 0) ? fromCol - 1 : 0; (col <= toCol + 1) && (col < numCols); col++)
+                {
+                    if (!IsWallInCell(walls[wallIdx], col, row))
+                        continue;
+                    const uint16_t cellIdx {static_cast<uint16_t>(row * numCols + col)};
+                    if (pass == 0)
+                    {
+                        cellStarts[cellIdx + 1]++;
+                        if (++numWallIdxs > MaxWalls)
+                            WallGrid::Error();
+                    }
+                    else
+                        wallIdxs[--cellStarts[cellIdx + 1]] = static_cast<WallIdx>(wallIdx);
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            // (cellStarts[i + 1] is now the end of cell i's list, which the second pass counts
+            // back down from, to the start of the list)
+            for (uint16_t cellIdx = 0; cellIdx < numCells; cellIdx++)
+                cellStarts[cellIdx + 1] += cellStarts[cellIdx];
+            wallIdxs = static_cast<WallIdx*>(malloc(sizeof(WallIdx) * ((numWallIdxs > 0) ? numWallIdxs : 1)));
+            if (!wallIdxs)
+                WallGrid::Error();
+        }
+    }
+
+    // the second pass left cellStarts[i + 1] at the start of cell i's list, so they all move back
+    // one place
+    for (uint16_t cellIdx = 0; cellIdx < numCells; cellIdx++)
+        cellStarts[cellIdx] = cellStarts[cellIdx + 1];
+    cellStarts[numCells] = static_cast<uint16_t>(numWallIdxs);
+}
+
+void WallGrid::WalkRay(const Line& ray, CellCbType cellFunc, void* ptr) const
+{
+    WalkRay(ray, [cellFunc, ptr](const WallIdx* cellWallIdxs, uint16_t numWalls, Scalar exitT)
+    {
+        return cellFunc(cellWallIdxs, numWalls, exitT, ptr);
+    });
+}
+
+void WallGrid::Free()
+{
+    free(cellStarts);
+    free(wallIdxs);
+    cellStarts = nullptr;
+    wallIdxs = nullptr;
+    numCols = 0;
+    numRows = 0;
+}
+
+// whether the wall passes through the cell (or near it - see CellMarginDivisor)
+bool WallGrid::IsWallInCell(const Wall& wall, uint8_t col, uint8_t row) const
+{
+    const Scalar margin {cellSize / static_cast<Scalar>(CellMarginDivisor)};
+    const Vec2 cellMin {gridMin.x + cellSize * static_cast<Scalar>(col) - margin, gridMin.y + cellSize * static_cast<Scalar>(row) - margin};
+    const Vec2 cellMax {cellMin.x + cellSize + margin * 2.0f, cellMin.y + cellSize + margin * 2.0f};
+    const Line& seg {wall.seg};
+
+    // the wall's bounding box must overlap the cell...
+    if (((seg.p1.x < cellMin.x) && (seg.p2.x < cellMin.x)) || ((seg.p1.x > cellMax.x) && (seg.p2.x > cellMax.x)) ||
+        ((seg.p1.y < cellMin.y) && (seg.p2.y < cellMin.y)) || ((seg.p1.y > cellMax.y) && (seg.p2.y > cellMax.y)))
+        return false;
+
+    // ...and the wall's line must not have all of the cell's corners on the same side of it
+    const Vec2 dir {seg.p2 - seg.p1};
+    const Vec2 corners[] {cellMin, {cellMax.x, cellMin.y}, cellMax, {cellMin.x, cellMax.y}};
+    bool anyLeft {false};
+    bool anyRight {false};
+    for (const Vec2& corner : corners)
+    {
+        const Vec2 toCorner {corner - seg.p1};
+        const Wide<Scalar>::Type cross {Wide<Scalar>::Mul(dir.x, toCorner.y) - Wide<Scalar>::Mul(dir.y, toCorner.x)};
+        anyLeft = anyLeft || (cross >= 0);
+        anyRight = anyRight || (cross <= 0);
+    }
+    return (anyLeft && anyRight);
+}
+
+// the cell that a coordinate is in, along one axis (clamped to the grid)
+uint8_t WallGrid::GetCell(Scalar coord, Scalar gridMinCoord, uint8_t numCells) const
+{
+    const Scalar cell {(coord - gridMinCoord) / cellSize};
+    if (cell < 0.0f)
+        return 0;
+    const int16_t cellIdx {static_cast<int16_t>(cell)};
+    return static_cast<uint8_t>((cellIdx >= numCells) ? numCells - 1 : cellIdx);
+}
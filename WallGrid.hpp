@@ -0,0 +1,141 @@
+//
+//  WallGrid.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef WallGrid_hpp
+#define WallGrid_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include "GeomUtils.hpp"
+#include "Line.hpp"
+#include "Wall.hpp"
+
+// a uniform grid of square cells over a map's walls, so that a ray only has to be tested against
+// the walls near it, rather than every wall in the map
+//
+// each cell has a list of the walls that touch it (as indices into the map's array of walls, with
+// the lists of all of the cells packed one after another into a single array), and WalkRay()
+// steps through the cells that a ray passes through, nearest first (as in Amanatides and Woo's
+// "A Fast Voxel Traversal Algorithm for Ray Tracing"), so that the search can stop at the first
+// cell in which a wall is hit - the work per ray then depends on how far the ray goes before it
+// hits something, rather than on how big the map is
+class WallGrid
+{
+public:
+    typedef uint16_t WallIdx;
+
+    // a cell's walls, and where the ray leaves the cell (as a multiple of the ray's length, as
+    // for GeomUtils::FindRayLineSegIntersection())
+    // (return false to stop walking the ray)
+    typedef bool (*CellCbType)(const WallIdx* wallIdxs, uint16_t numWalls, Scalar exitT, void* ptr);
+
+    // (so that the cells' lists add up to not much more than the number of walls, the grid has
+    // about as many cells as there are walls, up to this many on a side)
+    static constexpr uint8_t MaxCellsPerSide {32};
+    static constexpr size_t MaxWalls {0xFFFF};
+
+    WallGrid();
+    ~WallGrid();
+
+    // (the grid only refers to the walls by index, so they aren't needed afterwards)
+    void Build(const Wall walls[], size_t numWalls);
+
+    template <class CellVisitor>
+    void WalkRay(const Line& ray, CellVisitor&& visitCell) const;
+    void WalkRay(const Line& ray, CellCbType cellFunc, void* ptr) const;
+
+private:
+    [[noreturn]] static void Error();
+
+    void Free();
+    bool IsWallInCell(const Wall& wall, uint8_t col, uint8_t row) const;
+    uint8_t GetCell(Scalar coord, Scalar gridMin, uint8_t numCells) const;
+
+    Vec2 gridMin;
+    Scalar cellSize;
+    uint8_t numCols;
+    uint8_t numRows;
+
+    // cell (col, row)'s walls are wallIdxs[cellStarts[i]] up to wallIdxs[cellStarts[i + 1]],
+    // where i is row * numCols + col
+    uint16_t* cellStarts;
+    WallIdx* wallIdxs;
+};
+
+template <class CellVisitor>
+void WallGrid::WalkRay(const Line& ray, CellVisitor&& visitCell) const
+{
+    if (!cellStarts)
+        return;
+
+    // clip the ray to the grid (only the part in front of its start is wanted) - this is only
+    // needed if the ray starts outside of the grid, which is rare, as the grid covers the map
+    const Vec2 d {ray.p2 - ray.p1};
+    const Vec2 gridMax {gridMin.x + cellSize * static_cast<Scalar>(numCols), gridMin.y + cellSize * static_cast<Scalar>(numRows)};
+    Vec2 enterP {ray.p1};
+    if ((ray.p1.x < gridMin.x) || (ray.p1.x > gridMax.x) || (ray.p1.y < gridMin.y) || (ray.p1.y > gridMax.y))
+    {
+        Scalar tEnter {0.0f};
+        Scalar tLeave {ScalarMax};
+        GeomUtils::ClipRayToSlab(ray.p1.x, d.x, gridMin.x, gridMax.x, tEnter, tLeave);
+        GeomUtils::ClipRayToSlab(ray.p1.y, d.y, gridMin.y, gridMax.y, tEnter, tLeave);
+        if (tEnter > tLeave)
+            return;
+        enterP = ray.p1 + d * tEnter;
+    }
+
+    int16_t col {GetCell(enterP.x, gridMin.x, numCols)};
+    int16_t row {GetCell(enterP.y, gridMin.y, numRows)};
+
+    // the next cell boundary that the ray crosses in each direction, and how far apart the
+    // boundaries are (a ray along an axis never crosses the other axis's boundaries)
+    const int8_t stepCol {static_cast<int8_t>((d.x > 0.0f) ? 1 : -1)};
+    const int8_t stepRow {static_cast<int8_t>((d.y > 0.0f) ? 1 : -1)};
+    Scalar nextColT {ScalarMax};
+    Scalar nextRowT {ScalarMax};
+    Scalar colDeltaT {ScalarMax};
+    Scalar rowDeltaT {ScalarMax};
+    if (d.x != 0.0f)
+    {
+        const Scalar boundary {gridMin.x + cellSize * static_cast<Scalar>(col + ((stepCol > 0) ? 1 : 0))};
+        nextColT = (boundary - ray.p1.x) / d.x;
+        colDeltaT = cellSize / fabs(d.x);
+    }
+    if (d.y != 0.0f)
+    {
+        const Scalar boundary {gridMin.y + cellSize * static_cast<Scalar>(row + ((stepRow > 0) ? 1 : 0))};
+        nextRowT = (boundary - ray.p1.y) / d.y;
+        rowDeltaT = cellSize / fabs(d.y);
+    }
+
+    while (true)
+    {
+        const uint16_t cellIdx {static_cast<uint16_t>(row * numCols + col)};
+        const uint16_t start {cellStarts[cellIdx]};
+        const Scalar exitT {(nextColT < nextRowT) ? nextColT : nextRowT};
+        if (!visitCell(&wallIdxs[start], static_cast<uint16_t>(cellStarts[cellIdx + 1] - start), exitT))
+            break;
+
+        // (the boundary times are kept from overflowing, for rays that are nearly along an axis)
+        if (nextColT < nextRowT)
+        {
+            col += stepCol;
+            if ((col < 0) || (col >= numCols))
+                break;
+            nextColT = (colDeltaT < ScalarMax - nextColT) ? nextColT + colDeltaT : ScalarMax;
+        }
+        else
+        {
+            row += stepRow;
+            if ((row < 0) || (row >= numRows))
+                break;
+            nextRowT = (rowDeltaT < ScalarMax - nextRowT) ? nextRowT + rowDeltaT : ScalarMax;
+        }
+    }
+}
+
+#endif /* WallGrid_hpp */
@@ -0,0 +1,339 @@
+//
+//  WallSoa.cpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <math.h>
+#include "WallSoa.hpp"
+#include "GeomUtils.hpp"
+#ifdef SimdWallKernels
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+constexpr size_t WallSoa::MaxWalls;
+
+// (MSVC lets any function use any instructions, while GCC and Clang have to be told which
+// functions are only called where the CPU has them)
+#if defined(SimdWallKernels) && !defined(_MSC_VER)
+#define TargetAvx2 __attribute__((target("avx2")))
+#else
+#define TargetAvx2
+#endif
+
+namespace
+{
+#ifdef SimdWallKernels
+    // a little over 1 - the SIMD kernels first rule walls out without dividing (see
+    // FindClosestHitSse2()), with this much slack, so that nothing that the division would let
+    // through is ruled out by rounding
+    constexpr double MayHitSlack {1.0001f};
+
+    // picks the closest of the SIMD lanes' hits that is closer than t (the lanes' wall indices are
+    // doubles, as they were kept alongside the lanes' t's) - the lowest wall index wins a tie
+    bool PickClosestLane(const double lanesT[], const double lanesIdx[], uint8_t numLanes, Scalar& t, WallSoa::WallIdx& wallIdx)
+    {
+        bool isHit {false};
+        for (uint8_t lane {0}; lane < numLanes; lane++)
+        {
+            if ((lanesT[lane] < t) || (isHit && (lanesT[lane] == t) && (lanesIdx[lane] < wallIdx)))
+            {
+                t = lanesT[lane];
+                wallIdx = static_cast<WallSoa::WallIdx>(lanesIdx[lane]);
+                isHit = true;
+            }
+        }
+        return isHit;
+    }
+#endif
+}
+
+// (as in BspTree)
+[[noreturn]] void WallSoa::Error()
+{
+    while (1) {}
+}
+
+WallSoa::WallSoa():
+    x1{nullptr},
+    y1{nullptr},
+    dx{nullptr},
+    dy{nullptr},
+    numWalls{0},
+    kernel{GetBestKernel()}
+{
+}
+
+WallSoa::~WallSoa()
+{
+    Free();
+}
+
+void WallSoa::Build(const Wall walls[], size_t numWalls)
+{
+    Free();
+    if ((numWalls == 0) || (numWalls > MaxWalls))
+        return;
+
+    x1 = static_cast<Scalar*>(malloc(sizeof(Scalar) * 4 * numWalls));
+    if (!x1)
+        WallSoa::Error();
+    y1 = x1 + numWalls;
+    dx = y1 + numWalls;
+    dy = dx + numWalls;
+    for (size_t wallIdx {0}; wallIdx < numWalls; wallIdx++)
+    {
+        const Line& seg {walls[wallIdx].seg};
+        const Vec2 s {seg.p2 - seg.p1};
+        x1[wallIdx] = seg.p1.x;
+        y1[wallIdx] = seg.p1.y;
+        dx[wallIdx] = s.x;
+        dy[wallIdx] = s.y;
+    }
+    this->numWalls = numWalls;
+}
+
+WallSoa::Kernel WallSoa::GetBestKernel()
+{
+#ifdef SimdWallKernels
+#ifdef _MSC_VER
+    // (AVX2 also needs the OS to save the AVX registers, which XGETBV says)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return Kernel::Sse2;
+    __cpuid(info, 1);
+    const bool isAvxSaved {((info[2] & (1 << 27)) != 0) && ((_xgetbv(0) & 6) == 6)};
+    __cpuidex(info, 7, 0);
+    return (isAvxSaved && ((info[1] & (1 << 5)) != 0)) ? Kernel::Avx2 : Kernel::Sse2;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? Kernel::Avx2 : Kernel::Sse2;
+#endif
+#else
+    return Kernel::Scalar;
+#endif
+}
+
+bool WallSoa::FindClosestHit(const Line& ray, const WallIdx* wallIdxs, size_t count, Scalar& t, WallIdx& wallIdx) const
+{
+    size_t first {0};
+    bool isHit {false};
+#ifdef SimdWallKernels
+    // (the lanes are only compared here, out of the AVX2 code - after that, GCC and Clang keep
+    // using the AVX registers' upper halves, which then slows down every SSE instruction that
+    // comes after it, in the scalar kernel and the caller)
+    double lanesT[4];
+    double lanesIdx[4];
+    const bool isAvx2 {kernel == Kernel::Avx2};
+    if ((kernel != Kernel::Scalar) && (count >= (isAvx2 ? 4u : 2u)))
+    {
+        first = isAvx2 ? FindLaneHitsAvx2(ray, wallIdxs, count, t, lanesT, lanesIdx) :
+                         FindLaneHitsSse2(ray, wallIdxs, count, t, lanesT, lanesIdx);
+        isHit = PickClosestLane(lanesT, lanesIdx, isAvx2 ? 4 : 2, t, wallIdx);
+    }
+#endif
+    // (the walls left over after the last full SIMD register, if any)
+    return (FindClosestHitScalar(ray, wallIdxs, first, count, t, wallIdx) || isHit);
+}
+
+void WallSoa::Free()
+{
+    free(x1);
+    x1 = nullptr;
+    y1 = nullptr;
+    dx = nullptr;
+    dy = nullptr;
+    numWalls = 0;
+}
+
+bool WallSoa::FindClosestHitScalar(const Line& ray, const WallIdx* wallIdxs, size_t first, size_t count, Scalar& t, WallIdx& wallIdx) const
+{
+    // (see GeomUtils::FindRayLineSegIntersection() for the math)
+    const Vec2 r {ray.p2 - ray.p1};
+    bool isHit {false};
+    for (size_t i {first}; i < count; i++)
+    {
+        const WallIdx idx {wallIdxs ? wallIdxs[i] : static_cast<WallIdx>(i)};
+        const Vec2 s {dx[idx], dy[idx]};
+        const Vec2 segStartMinusRayStart {Vec2{x1[idx], y1[idx]} - ray.p1};
+        const Wide<Scalar>::Type rCrossS {r.CrossWide(s)};
+        if (fabs(rCrossS) > GeomUtils::fpNegligible)
+        {
+            const Scalar wallT {segStartMinusRayStart.CrossWide(s) / rCrossS};
+            const Scalar u {segStartMinusRayStart.CrossWide(r) / rCrossS};
+            if ((wallT > GeomUtils::fpNegligible) && (u >= 0.0f) && (u <= 1.0f) && (wallT < t))
+            {
+                t = wallT;
+                wallIdx = idx;
+                isHit = true;
+            }
+        }
+    }
+    return isHit;
+}
+
+#ifdef SimdWallKernels
+// each lane keeps the closest hit in its share of the walls (and which wall it was)
+//
+// t and u are the numerators over r x s, so most walls (the ones that the ray misses) can be ruled
+// out by comparing the numerators with r x s, with the signs of all three flipped if r x s is
+// negative - only if that leaves any walls in a register are the divisions done, exactly as in
+// GeomUtils, to decide which of them are hit
+size_t WallSoa::FindLaneHitsSse2(const Line& ray, const WallIdx* wallIdxs, size_t count, Scalar t, double lanesT[], double lanesIdx[]) const
+{
+    const __m128d px {_mm_set1_pd(ray.p1.x)};
+    const __m128d py {_mm_set1_pd(ray.p1.y)};
+    const __m128d rx {_mm_set1_pd(ray.p2.x - ray.p1.x)};
+    const __m128d ry {_mm_set1_pd(ray.p2.y - ray.p1.y)};
+    const __m128d negligible {_mm_set1_pd(GeomUtils::fpNegligible)};
+    const __m128d minusNegligible {_mm_set1_pd(-GeomUtils::fpNegligible)};
+    const __m128d zero {_mm_setzero_pd()};
+    const __m128d one {_mm_set1_pd(1.0f)};
+    const __m128d laneOffsets {_mm_set_pd(1.0f, 0.0f)};
+    const __m128d signBit {_mm_set1_pd(-0.0f)};
+    const __m128d slack {_mm_set1_pd(MayHitSlack)};
+    __m128d closestT {_mm_set1_pd(t)};
+    __m128d closestIdx {_mm_setzero_pd()};
+
+    size_t i {0};
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d wallX1, wallY1, wallDx, wallDy, idx;
+        if (wallIdxs)
+        {
+            const WallIdx idx0 {wallIdxs[i]};
+            const WallIdx idx1 {wallIdxs[i + 1]};
+            wallX1 = _mm_set_pd(x1[idx1], x1[idx0]);
+            wallY1 = _mm_set_pd(y1[idx1], y1[idx0]);
+            wallDx = _mm_set_pd(dx[idx1], dx[idx0]);
+            wallDy = _mm_set_pd(dy[idx1], dy[idx0]);
+            idx = _mm_set_pd(idx1, idx0);
+        }
+        else
+        {
+            wallX1 = _mm_loadu_pd(&x1[i]);
+            wallY1 = _mm_loadu_pd(&y1[i]);
+            wallDx = _mm_loadu_pd(&dx[i]);
+            wallDy = _mm_loadu_pd(&dy[i]);
+            idx = _mm_add_pd(_mm_set1_pd(static_cast<double>(i)), laneOffsets);
+        }
+
+        const __m128d sx {_mm_sub_pd(wallX1, px)};
+        const __m128d sy {_mm_sub_pd(wallY1, py)};
+        const __m128d rCrossS {_mm_sub_pd(_mm_mul_pd(rx, wallDy), _mm_mul_pd(ry, wallDx))};
+        const __m128d tNumerator {_mm_sub_pd(_mm_mul_pd(sx, wallDy), _mm_mul_pd(sy, wallDx))};
+        const __m128d uNumerator {_mm_sub_pd(_mm_mul_pd(sx, ry), _mm_mul_pd(sy, rx))};
+
+        const __m128d rCrossSSign {_mm_and_pd(rCrossS, signBit)};
+        const __m128d absRCrossS {_mm_xor_pd(rCrossS, rCrossSSign)};
+        const __m128d tScaled {_mm_xor_pd(tNumerator, rCrossSSign)};
+        const __m128d uScaled {_mm_xor_pd(uNumerator, rCrossSSign)};
+        __m128d mayHit {_mm_cmpgt_pd(absRCrossS, negligible)};
+        mayHit = _mm_and_pd(mayHit, _mm_cmpgt_pd(tScaled, zero));
+        mayHit = _mm_and_pd(mayHit, _mm_cmpge_pd(uScaled, zero));
+        mayHit = _mm_and_pd(mayHit, _mm_cmple_pd(uScaled, _mm_mul_pd(absRCrossS, slack)));
+        mayHit = _mm_and_pd(mayHit, _mm_cmplt_pd(tScaled, _mm_mul_pd(_mm_mul_pd(closestT, absRCrossS), slack)));
+        if (_mm_movemask_pd(mayHit) == 0)
+            continue;
+
+        const __m128d wallT {_mm_div_pd(tNumerator, rCrossS)};
+        const __m128d u {_mm_div_pd(uNumerator, rCrossS)};
+
+        // (a wall parallel to the ray divides by 0, but then its lane fails the first test anyway)
+        __m128d isCloser {_mm_or_pd(_mm_cmpgt_pd(rCrossS, negligible), _mm_cmplt_pd(rCrossS, minusNegligible))};
+        isCloser = _mm_and_pd(isCloser, _mm_cmpgt_pd(wallT, negligible));
+        isCloser = _mm_and_pd(isCloser, _mm_cmpge_pd(u, zero));
+        isCloser = _mm_and_pd(isCloser, _mm_cmple_pd(u, one));
+        isCloser = _mm_and_pd(isCloser, _mm_cmplt_pd(wallT, closestT));
+        closestT = _mm_or_pd(_mm_and_pd(isCloser, wallT), _mm_andnot_pd(isCloser, closestT));
+        closestIdx = _mm_or_pd(_mm_and_pd(isCloser, idx), _mm_andnot_pd(isCloser, closestIdx));
+    }
+
+    _mm_storeu_pd(lanesT, closestT);
+    _mm_storeu_pd(lanesIdx, closestIdx);
+    return i;
+}
+
+// (as for SSE2, but with gathers for the walls that come by index)
+TargetAvx2 size_t WallSoa::FindLaneHitsAvx2(const Line& ray, const WallIdx* wallIdxs, size_t count, Scalar t, double lanesT[], double lanesIdx[]) const
+{
+    const __m256d px {_mm256_set1_pd(ray.p1.x)};
+    const __m256d py {_mm256_set1_pd(ray.p1.y)};
+    const __m256d rx {_mm256_set1_pd(ray.p2.x - ray.p1.x)};
+    const __m256d ry {_mm256_set1_pd(ray.p2.y - ray.p1.y)};
+    const __m256d negligible {_mm256_set1_pd(GeomUtils::fpNegligible)};
+    const __m256d minusNegligible {_mm256_set1_pd(-GeomUtils::fpNegligible)};
+    const __m256d zero {_mm256_setzero_pd()};
+    const __m256d one {_mm256_set1_pd(1.0f)};
+    const __m256d laneOffsets {_mm256_set_pd(3.0f, 2.0f, 1.0f, 0.0f)};
+    const __m256d signBit {_mm256_set1_pd(-0.0f)};
+    const __m256d slack {_mm256_set1_pd(MayHitSlack)};
+    // (the gathers are the masked kind, with every lane set, as GCC's plain ones start from an
+    // uninitialized register, which -Wall warns about)
+    const __m256d allLanes {_mm256_castsi256_pd(_mm256_set1_epi64x(-1))};
+    __m256d closestT {_mm256_set1_pd(t)};
+    __m256d closestIdx {_mm256_setzero_pd()};
+
+    size_t i {0};
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d wallX1, wallY1, wallDx, wallDy, idx;
+        if (wallIdxs)
+        {
+            const __m128i idxs {_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&wallIdxs[i])))};
+            wallX1 = _mm256_mask_i32gather_pd(zero, x1, idxs, allLanes, sizeof(Scalar));
+            wallY1 = _mm256_mask_i32gather_pd(zero, y1, idxs, allLanes, sizeof(Scalar));
+            wallDx = _mm256_mask_i32gather_pd(zero, dx, idxs, allLanes, sizeof(Scalar));
+            wallDy = _mm256_mask_i32gather_pd(zero, dy, idxs, allLanes, sizeof(Scalar));
+            idx = _mm256_cvtepi32_pd(idxs);
+        }
+        else
+        {
+            wallX1 = _mm256_loadu_pd(&x1[i]);
+            wallY1 = _mm256_loadu_pd(&y1[i]);
+            wallDx = _mm256_loadu_pd(&dx[i]);
+            wallDy = _mm256_loadu_pd(&dy[i]);
+            idx = _mm256_add_pd(_mm256_set1_pd(static_cast<double>(i)), laneOffsets);
+        }
+
+        const __m256d sx {_mm256_sub_pd(wallX1, px)};
+        const __m256d sy {_mm256_sub_pd(wallY1, py)};
+        const __m256d rCrossS {_mm256_sub_pd(_mm256_mul_pd(rx, wallDy), _mm256_mul_pd(ry, wallDx))};
+        const __m256d tNumerator {_mm256_sub_pd(_mm256_mul_pd(sx, wallDy), _mm256_mul_pd(sy, wallDx))};
+        const __m256d uNumerator {_mm256_sub_pd(_mm256_mul_pd(sx, ry), _mm256_mul_pd(sy, rx))};
+
+        const __m256d rCrossSSign {_mm256_and_pd(rCrossS, signBit)};
+        const __m256d absRCrossS {_mm256_xor_pd(rCrossS, rCrossSSign)};
+        const __m256d tScaled {_mm256_xor_pd(tNumerator, rCrossSSign)};
+        const __m256d uScaled {_mm256_xor_pd(uNumerator, rCrossSSign)};
+        __m256d mayHit {_mm256_cmp_pd(absRCrossS, negligible, _CMP_GT_OQ)};
+        mayHit = _mm256_and_pd(mayHit, _mm256_cmp_pd(tScaled, zero, _CMP_GT_OQ));
+        mayHit = _mm256_and_pd(mayHit, _mm256_cmp_pd(uScaled, zero, _CMP_GE_OQ));
+        mayHit = _mm256_and_pd(mayHit, _mm256_cmp_pd(uScaled, _mm256_mul_pd(absRCrossS, slack), _CMP_LE_OQ));
+        mayHit = _mm256_and_pd(mayHit, _mm256_cmp_pd(tScaled, _mm256_mul_pd(_mm256_mul_pd(closestT, absRCrossS), slack), _CMP_LT_OQ));
+        if (_mm256_movemask_pd(mayHit) == 0)
+            continue;
+
+        const __m256d wallT {_mm256_div_pd(tNumerator, rCrossS)};
+        const __m256d u {_mm256_div_pd(uNumerator, rCrossS)};
+
+        __m256d isCloser {_mm256_or_pd(_mm256_cmp_pd(rCrossS, negligible, _CMP_GT_OQ), _mm256_cmp_pd(rCrossS, minusNegligible, _CMP_LT_OQ))};
+        isCloser = _mm256_and_pd(isCloser, _mm256_cmp_pd(wallT, negligible, _CMP_GT_OQ));
+        isCloser = _mm256_and_pd(isCloser, _mm256_cmp_pd(u, zero, _CMP_GE_OQ));
+        isCloser = _mm256_and_pd(isCloser, _mm256_cmp_pd(u, one, _CMP_LE_OQ));
+        isCloser = _mm256_and_pd(isCloser, _mm256_cmp_pd(wallT, closestT, _CMP_LT_OQ));
+        closestT = _mm256_blendv_pd(closestT, wallT, isCloser);
+        closestIdx = _mm256_blendv_pd(closestIdx, idx, isCloser);
+    }
+
+    _mm256_storeu_pd(lanesT, closestT);
+    _mm256_storeu_pd(lanesIdx, closestIdx);
+    return i;
+}
+#endif
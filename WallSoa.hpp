@@ -0,0 +1,90 @@
+//
+//  WallSoa.hpp
+//  walls3duino
+//
+//  Copyright © 2020 Brian Dolan. All rights reserved.
+//
+
+#ifndef WallSoa_hpp
+#define WallSoa_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Line.hpp"
+#include "Wall.hpp"
+
+// the SIMD kernels below are only for x86 PCs (where SSE2 is always there, and AVX2 is looked
+// for when the program runs) doing floating-point math - fixed point, or anything else (e.g. the
+// embedded hardware), only has the scalar kernel
+#if !defined(FixedPointMath) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define SimdWallKernels
+#endif
+
+// a map's walls laid out as a "structure of arrays" - every wall's start x, start y, and the x
+// and y of its direction (end minus start) in four separate arrays - so that a ray can be tested
+// against several walls at once, with each wall in one lane of a SIMD register (2 at a time with
+// SSE2, 4 with AVX2, as the math is in double precision)
+//
+// the kernels do exactly the same operations as GeomUtils::FindRayLineSegIntersection(), lane by
+// lane, so they find exactly the same hits - a SIMD search draws the same frame as any other
+class WallSoa
+{
+public:
+    typedef uint16_t WallIdx;
+
+    static constexpr size_t MaxWalls {0xFFFF};
+
+    // which instructions FindClosestHit() uses
+    enum class Kernel : uint8_t
+    {
+        Scalar, // one wall at a time
+        Sse2,   // 2 walls at a time
+        Avx2    // 4 walls at a time
+    };
+
+    WallSoa();
+    ~WallSoa();
+
+    // (the walls are copied, so they aren't needed afterwards - more than MaxWalls of them leave
+    // the store empty, as for WallGrid and WallBvh, and then it mustn't be searched)
+    void Build(const Wall walls[], size_t numWalls);
+
+    // the fastest kernel that this CPU can run (and that was built), which every WallSoa starts
+    // out using
+    static Kernel GetBestKernel();
+    // (for comparing the kernels - one that the CPU can't run mustn't be set)
+    void SetKernel(Kernel newKernel) { kernel = newKernel; }
+    Kernel GetKernel() const { return kernel; }
+
+    // finds the closest of the walls that the ray hits closer than t (how far along the ray, as
+    // for GeomUtils::FindRayLineSegIntersection()), if there is one, and updates t and wallIdx
+    // to it - the walls are wallIdxs[0] up to wallIdxs[count], or the first count walls if
+    // wallIdxs is null, and it returns false if none of them are hit closer than t
+    bool FindClosestHit(const Line& ray, const WallIdx* wallIdxs, size_t count, Scalar& t, WallIdx& wallIdx) const;
+
+    size_t GetNumWalls() const { return numWalls; }
+
+private:
+    [[noreturn]] static void Error();
+
+    void Free();
+    // (from wallIdxs[first], or wall first, up to count)
+    bool FindClosestHitScalar(const Line& ray, const WallIdx* wallIdxs, size_t first, size_t count, Scalar& t, WallIdx& wallIdx) const;
+#ifdef SimdWallKernels
+    // (these test the walls a SIMD register at a time, up to the last full one, and leave each
+    // lane's closest hit closer than t, and its wall index, in lanesT and lanesIdx - they return
+    // how many walls that was)
+    size_t FindLaneHitsSse2(const Line& ray, const WallIdx* wallIdxs, size_t count, Scalar t, double lanesT[], double lanesIdx[]) const;
+    size_t FindLaneHitsAvx2(const Line& ray, const WallIdx* wallIdxs, size_t count, Scalar t, double lanesT[], double lanesIdx[]) const;
+#endif
+
+    // (all four arrays are in one allocation, starting at x1)
+    Scalar* x1;
+    Scalar* y1;
+    Scalar* dx;
+    Scalar* dy;
+    size_t numWalls;
+    Kernel kernel;
+};
+
+#endif /* WallSoa_hpp */